@@ -0,0 +1,255 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark: expression to BDD conversion with TeDDy and CUDD.
+ *
+ * Usage: bdd_benchmark <expressions_dir> [repetitions]
+ *
+ * Converts every `*.expr` file in `expressions_dir` plus generated 8-Queens
+ * and 10-Queens constraints with both BDD libraries. For each workload the
+ * program-based converters (`convert_expression_to_teddy` /
+ * `convert_expression_to_cudd`) are timed under every `expression_schedule`
+ * against a recursive reference converter equivalent to the original
+ * `std::visit` implementation, and each result is checked for equality with
+ * the reference. Each measurement uses a fresh manager; the best of
+ * `repetitions` runs is reported.
+ *
+ * The `peak` column is CUDD's peak live node count and, for TeDDy, the number
+ * of nodes held by the manager once the conversion has finished.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+#include <dagir/utility/expressions/expression_schedule.hpp>
+
+#include <dagir/utility/cudd/cudd_convert_expression.hpp>
+#include <dagir/utility/teddy/teddy_convert_expression.hpp>
+
+namespace {
+
+using namespace dagir::utility;
+using bench_clock = std::chrono::steady_clock;
+
+struct workload {
+  std::string name;
+  my_expression_ptr expr;
+};
+
+struct measurement {
+  double ms = std::numeric_limits<double>::max();
+  long long nodes = 0;
+  long long peak = 0;
+  bool same_result = true;
+};
+
+struct schedule_case {
+  const char* name;
+  bool reference;
+  expression_schedule schedule;
+};
+
+constexpr schedule_case k_schedules[] = {
+    {"reference", true, expression_schedule::in_order},
+    {"in_order", false, expression_schedule::in_order},
+    {"balanced", false, expression_schedule::balanced},
+    {"smallest_first", false, expression_schedule::smallest_first},
+};
+
+double elapsed_ms(bench_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+/**
+ * @brief Recursive reference converter for TeDDy (the original implementation).
+ */
+teddy::bdd_manager::diagram_t reference_convert_teddy(teddy::bdd_manager& mgr,
+                                                      const my_expression& expr,
+                                                      std::unordered_map<std::string, int>& vars) {
+  using diagram_t = teddy::bdd_manager::diagram_t;
+  struct visitor {
+    teddy::bdd_manager& mgr;
+    std::function<int(const std::string&)> resolve_var;
+    diagram_t operator()(const my_variable& v) { return mgr.variable(resolve_var(v.variable_name)); }
+    diagram_t operator()(const my_and& a) {
+      auto L = std::visit(*this, *a.left);
+      auto R = std::visit(*this, *a.right);
+      return mgr.apply<teddy::ops::AND>(L, R);
+    }
+    diagram_t operator()(const my_or& o) {
+      auto L = std::visit(*this, *o.left);
+      auto R = std::visit(*this, *o.right);
+      return mgr.apply<teddy::ops::OR>(L, R);
+    }
+    diagram_t operator()(const my_xor& x) {
+      auto L = std::visit(*this, *x.left);
+      auto R = std::visit(*this, *x.right);
+      return mgr.apply<teddy::ops::XOR>(L, R);
+    }
+    diagram_t operator()(const my_not& n) {
+      auto D = std::visit(*this, *n.expr);
+      return mgr.apply<teddy::ops::NAND>(D, D);
+    }
+  } vis{mgr, [&](const std::string& name) { return vars.at(name); }};
+  return std::visit(vis, expr);
+}
+
+/**
+ * @brief Recursive reference converter for CUDD (the original implementation).
+ */
+DdNode* reference_convert_cudd(DdManager& mgr, const my_expression& expr,
+                               std::unordered_map<std::string, int>& vars) {
+  struct visitor {
+    DdManager& mgr;
+    std::function<int(const std::string&)> resolve_var;
+    DdNode* binary(const my_expression_ptr& l, const my_expression_ptr& r,
+                   DdNode* (*op)(DdManager*, DdNode*, DdNode*)) {
+      DdNode* L = std::visit(*this, *l);
+      DdNode* R = std::visit(*this, *r);
+      DdNode* out = op(&mgr, L, R);
+      Cudd_Ref(out);
+      Cudd_RecursiveDeref(&mgr, L);
+      Cudd_RecursiveDeref(&mgr, R);
+      return out;
+    }
+    DdNode* operator()(const my_variable& v) {
+      DdNode* var = Cudd_bddIthVar(&mgr, resolve_var(v.variable_name));
+      Cudd_Ref(var);
+      return var;
+    }
+    DdNode* operator()(const my_and& a) { return binary(a.left, a.right, Cudd_bddAnd); }
+    DdNode* operator()(const my_or& o) { return binary(o.left, o.right, Cudd_bddOr); }
+    DdNode* operator()(const my_xor& x) { return binary(x.left, x.right, Cudd_bddXor); }
+    DdNode* operator()(const my_not& n) {
+      DdNode* D = std::visit(*this, *n.expr);
+      DdNode* out = Cudd_Not(D);
+      Cudd_Ref(out);
+      Cudd_RecursiveDeref(&mgr, D);
+      return out;
+    }
+  } vis{mgr, [&](const std::string& name) { return vars.at(name); }};
+  return std::visit(vis, expr);
+}
+
+measurement bench_teddy(const my_expression& expr, const schedule_case& sc, int repetitions) {
+  measurement m;
+  std::unordered_map<std::string, int> vars;
+  const auto program = compile_expression(expr, vars);
+  const auto var_count = static_cast<teddy::int32>(std::max<std::size_t>(vars.size(), 1));
+
+  for (int rep = 0; rep < repetitions; ++rep) {
+    teddy::bdd_manager mgr(var_count, 1024);
+    const auto start = bench_clock::now();
+    auto out = sc.reference ? reference_convert_teddy(mgr, expr, vars)
+                            : convert_expression_to_teddy(mgr, program, sc.schedule);
+    m.ms = std::min(m.ms, elapsed_ms(start));
+    m.nodes = static_cast<long long>(mgr.get_node_count(out));
+    m.peak = static_cast<long long>(mgr.get_node_count());
+
+    if (rep == 0 && !sc.reference) {
+      auto check = reference_convert_teddy(mgr, expr, vars);
+      m.same_result = check.unsafe_get_root() == out.unsafe_get_root();
+    }
+  }
+  return m;
+}
+
+measurement bench_cudd(const my_expression& expr, const schedule_case& sc, int repetitions) {
+  measurement m;
+  std::unordered_map<std::string, int> vars;
+  const auto program = compile_expression(expr, vars);
+  const auto var_count = static_cast<unsigned int>(vars.size());
+
+  for (int rep = 0; rep < repetitions; ++rep) {
+    DdManager* mgr = Cudd_Init(var_count, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+    const auto start = bench_clock::now();
+    DdNode* out = sc.reference ? reference_convert_cudd(*mgr, expr, vars)
+                               : convert_expression_to_cudd(*mgr, program, sc.schedule);
+    m.ms = std::min(m.ms, elapsed_ms(start));
+    m.nodes = Cudd_DagSize(out);
+    m.peak = Cudd_ReadPeakLiveNodeCount(mgr);
+
+    if (rep == 0 && !sc.reference) {
+      DdNode* check = reference_convert_cudd(*mgr, expr, vars);
+      m.same_result = check == out;
+      Cudd_RecursiveDeref(mgr, check);
+    }
+    Cudd_RecursiveDeref(mgr, out);
+    Cudd_Quit(mgr);
+  }
+  return m;
+}
+
+std::vector<workload> load_workloads(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".expr") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<workload> out;
+  for (const auto& f : files) {
+    out.push_back({f.stem().string(), read_expression_from_file(f.string())});
+  }
+  for (int n : {8, 10}) {
+    out.push_back({std::format("generated_{}_queens", n),
+                   parse_expression(make_n_queens_expression(n))});
+  }
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <expressions_dir> [repetitions]\n";
+    return 1;
+  }
+
+  try {
+    const int repetitions = (argc == 3) ? std::max(1, std::stoi(argv[2])) : 3;
+    auto workloads = load_workloads(argv[1]);
+
+    std::cout << std::format("{:<32} {:<6} {:<15} {:>10} {:>10} {:>12} {:>8} {:>5}\n",
+                             "workload", "lib", "schedule", "nodes", "peak", "ms", "speedup",
+                             "same");
+    bool all_same = true;
+    for (const auto& w : workloads) {
+      for (const std::string lib : {"teddy", "cudd"}) {
+        double reference_ms = 0.0;
+        for (const schedule_case& sc : k_schedules) {
+          const measurement m = (lib == "teddy") ? bench_teddy(*w.expr, sc, repetitions)
+                                                 : bench_cudd(*w.expr, sc, repetitions);
+          if (sc.reference) reference_ms = m.ms;
+          all_same = all_same && m.same_result;
+          const double speedup = m.ms > 0 ? reference_ms / m.ms : 0.0;
+          std::cout << std::format("{:<32} {:<6} {:<15} {:>10} {:>10} {:>12.3f} {:>7.2f}x {:>5}\n",
+                                   w.name, lib, sc.name, m.nodes, m.peak, m.ms, speedup,
+                                   m.same_result ? "yes" : "NO");
+        }
+      }
+    }
+    return all_same ? 0 : 2;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,204 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark: batch evaluation of BDDs from a flattened node table.
+ *
+ * Usage: bdd_eval_benchmark <expressions_dir> [assignments]
+ *
+ * For every `*.expr` file in `expressions_dir` plus generated 8-Queens
+ * constraints, builds the BDD with TeDDy and CUDD, flattens it through the
+ * library's read-only view with `flatten_bdd` and evaluates random
+ * assignments. Reports assignments per second for:
+ *
+ * - `view`: one walk per assignment through the read-only view (library nodes);
+ * - `table`: `evaluate_bdd_batch<1>`, one assignment at a time on the table;
+ * - `lanes8`, `lanes16`, `lanes32`: assignments walked in lockstep.
+ *
+ * All results are checked against bit-parallel evaluation of the expression.
+ * The view walk runs on a prefix of the batch (at most 1000000 assignments).
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dagir/bdd_eval.hpp>
+#include <dagir/utility/expressions/expression_batch_eval.hpp>
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+
+#include <dagir/utility/cudd/cudd_convert_expression.hpp>
+#include <dagir/utility/cudd/cudd_read_only_dag_view.hpp>
+#include <dagir/utility/teddy/teddy_convert_expression.hpp>
+#include <dagir/utility/teddy/teddy_read_only_dag_view.hpp>
+
+namespace {
+
+using namespace dagir::utility;
+using bench_clock = std::chrono::steady_clock;
+
+constexpr std::size_t k_max_view_assignments = 1000000;
+
+struct workload {
+  std::string name;
+  my_expression_ptr expr;
+};
+
+struct batch {
+  std::size_t count = 0;
+  std::size_t words = 0;                ///< Words per row-major assignment
+  std::vector<std::uint64_t> rows;      ///< Row-major assignments for the BDD
+  std::vector<std::uint64_t> expected;  ///< Bit-parallel expression results
+};
+
+double elapsed_seconds(bench_clock::time_point start) {
+  return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+bool result_bit(const std::vector<std::uint64_t>& words, std::size_t j) {
+  return (words[j / 64] >> (j % 64)) & 1u;
+}
+
+/**
+ * @brief Random assignments plus the expression's value under each of them.
+ */
+batch make_batch(const expression_program& program, std::size_t count, std::mt19937_64& rng) {
+  batch b;
+  b.count = count;
+  b.words = std::max<std::size_t>(1, (program.variable_count + 63) / 64);
+  b.rows.resize(count * b.words);
+  bit_sliced_assignments sliced(program.variable_count, count);
+  for (std::size_t j = 0; j < count; ++j) {
+    for (std::size_t w = 0; w < b.words; ++w) b.rows[j * b.words + w] = rng();
+    for (std::size_t v = 0; v < program.variable_count; ++v) {
+      sliced.set(j, v, (b.rows[j * b.words + v / 64] >> (v % 64)) & 1u);
+    }
+  }
+  b.expected = evaluate_bit_parallel<4>(program, sliced);
+  return b;
+}
+
+/**
+ * @brief Evaluate one assignment by walking the library nodes through the view.
+ */
+template <class View>
+bool walk_view(const View& view, typename View::handle h, const std::uint64_t* row) {
+  while (!view.is_terminal(h)) {
+    const std::size_t v = view.variable_index(h);
+    const auto kids = view.children(h);
+    h = kids[(row[v / 64] >> (v % 64)) & 1u].target();
+  }
+  return view.terminal_value(h);
+}
+
+template <std::size_t Lanes>
+double bench_table(const dagir::bdd_table& table, const batch& b, bool& same) {
+  const auto start = bench_clock::now();
+  const auto out = dagir::evaluate_bdd_batch<Lanes>(table, 0, b.rows.data(), b.words, b.count);
+  const double rate = static_cast<double>(b.count) / elapsed_seconds(start);
+  same = same && out == b.expected;
+  return rate;
+}
+
+template <class View>
+void report(const std::string& name, const char* lib, const View& view, const batch& b) {
+  const dagir::bdd_table table = dagir::flatten_bdd(view);
+  bool same = true;
+
+  const std::size_t view_count = std::min(b.count, k_max_view_assignments);
+  const auto root = view.roots().front();
+  const auto start = bench_clock::now();
+  std::vector<char> walked(view_count);
+  for (std::size_t j = 0; j < view_count; ++j) {
+    walked[j] = walk_view(view, root, b.rows.data() + j * b.words);
+  }
+  const double view_rate = static_cast<double>(view_count) / elapsed_seconds(start);
+  for (std::size_t j = 0; j < view_count; ++j) {
+    same = same && (walked[j] != 0) == result_bit(b.expected, j);
+  }
+
+  const double table_rate = bench_table<1>(table, b, same);
+  const double rate8 = bench_table<8>(table, b, same);
+  const double rate16 = bench_table<16>(table, b, same);
+  const double rate32 = bench_table<32>(table, b, same);
+  std::cout << std::format(
+      "{:<32} {:<6} {:>8} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>5}\n", name, lib,
+      table.nodes.size(), view_rate / 1e6, table_rate / 1e6, rate8 / 1e6, rate16 / 1e6,
+      rate32 / 1e6, same ? "yes" : "NO");
+}
+
+std::vector<workload> load_workloads(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".expr") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<workload> out;
+  for (const auto& f : files) {
+    out.push_back({f.stem().string(), read_expression_from_file(f.string())});
+  }
+  out.push_back({"generated_8_queens", parse_expression(make_n_queens_expression(8))});
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <expressions_dir> [assignments]\n";
+    return 1;
+  }
+
+  try {
+    const std::size_t assignments =
+        (argc == 3) ? std::max<std::size_t>(1, std::stoull(argv[2])) : 10000000;
+    auto workloads = load_workloads(argv[1]);
+    std::mt19937_64 rng(42);
+
+    std::cout << "Rates in million assignments per second.\n";
+    std::cout << std::format("{:<32} {:<6} {:>8} {:>10} {:>10} {:>10} {:>10} {:>10} {:>5}\n",
+                             "workload", "lib", "nodes", "view", "table", "lanes8", "lanes16",
+                             "lanes32", "same");
+    for (const auto& w : workloads) {
+      std::unordered_map<std::string, int> var_map;
+      const expression_program program = compile_expression(*w.expr, var_map);
+      const batch b = make_batch(program, assignments, rng);
+
+      {
+        const auto var_count =
+            static_cast<teddy::int32>(std::max<std::size_t>(program.variable_count, 1));
+        teddy::bdd_manager mgr(var_count, 1024);
+        auto diagram = convert_expression_to_teddy(mgr, program);
+        teddy_read_only_dag_view view(&mgr, nullptr, {diagram.unsafe_get_root()});
+        report(w.name, "teddy", view, b);
+      }
+      {
+        DdManager* mgr = Cudd_Init(static_cast<unsigned int>(program.variable_count), 0,
+                                   CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+        DdNode* root = convert_expression_to_cudd(*mgr, program);
+        cudd_read_only_dag_view view(mgr, nullptr, {root});
+        report(w.name, "cudd", view, b);
+        Cudd_RecursiveDeref(mgr, root);
+        Cudd_Quit(mgr);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
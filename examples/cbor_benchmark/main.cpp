@@ -0,0 +1,230 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark: size and read/write throughput of the CBOR encoding against JSON.
+ *
+ * Usage: cbor_benchmark <expressions_dir> [repetitions]
+ *
+ * Builds the IR of the CUDD BDD of every `*.expr` file in `expressions_dir`,
+ * of the generated 10-Queens constraints and of synthetic BDD-shaped graphs
+ * (labels, shapes and edge styles as written by the CUDD attributors), then
+ * writes each with `render_json`, minified `render_json` and `render_cbor`,
+ * then reads the minified JSON back with `load_json` and the CBOR with
+ * `decode_cbor`. Every timing is the best of `repetitions` runs (default 5).
+ * Rows report the output sizes, the CBOR size relative to minified JSON,
+ * write times, read times with their throughput, and whether both graphs
+ * read back have the same content.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dagir/build_ir.hpp>
+#include <dagir/load_json.hpp>
+#include <dagir/render_cbor.hpp>
+#include <dagir/render_json.hpp>
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+
+#include <dagir/utility/cudd/cudd_convert_expression.hpp>
+#include <dagir/utility/cudd/cudd_policy.hpp>
+#include <dagir/utility/cudd/cudd_read_only_dag_view.hpp>
+
+namespace {
+
+using namespace dagir::utility;
+using bench_clock = std::chrono::steady_clock;
+
+struct workload {
+  std::string name;
+  dagir::ir_graph ir;
+};
+
+/// Best wall time of `repetitions` calls of `fn`, in milliseconds.
+template <class Fn>
+double best_ms(std::size_t repetitions, Fn&& fn) {
+  double best = 0.0;
+  for (std::size_t r = 0; r < repetitions; ++r) {
+    const auto start = bench_clock::now();
+    fn();
+    const std::chrono::duration<double, std::milli> ms = bench_clock::now() - start;
+    best = r == 0 ? ms.count() : std::min(best, ms.count());
+  }
+  return best;
+}
+
+/**
+ * @brief `depth` levels of `width` decision nodes over two terminals.
+ *
+ * Every node has a low (dashed) and a high edge to a deeper level or a
+ * terminal, as in a BDD.
+ */
+dagir::ir_graph synthetic_graph(std::size_t depth, std::size_t width, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  dagir::ir_graph g;
+  const std::uint64_t decisions = depth * width;
+  for (std::uint64_t i = 0; i < decisions; ++i) {
+    g.nodes.push_back({i,
+                       {{dagir::ir_attrs::k_label, std::format("x{}", i / width)},
+                        {dagir::ir_attrs::k_shape, "circle"}}});
+  }
+  for (std::uint64_t t = 0; t < 2; ++t) {
+    g.nodes.push_back({decisions + t,
+                       {{dagir::ir_attrs::k_label, std::to_string(t)},
+                        {dagir::ir_attrs::k_shape, "box"},
+                        {dagir::ir_attrs::k_fill_color, "lightgray"}}});
+  }
+  for (std::uint64_t i = 0; i < decisions; ++i) {
+    const std::uint64_t level = i / width;
+    for (int k = 0; k < 2; ++k) {
+      const std::uint64_t below = depth - level - 1;
+      std::uint64_t target = decisions + rng() % 2;
+      if (below > 0 && rng() % 16 != 0) {
+        target = (level + 1 + rng() % std::min<std::uint64_t>(below, 2)) * width + rng() % width;
+      }
+      dagir::ir_attr_map attrs;
+      if (k == 0) attrs.emplace(dagir::ir_attrs::k_style, "dashed");
+      g.edges.push_back({i, target, std::move(attrs)});
+    }
+  }
+  return g;
+}
+
+/// IR of the BDD of `expr` as `expression2bdd` builds it with CUDD.
+dagir::ir_graph bdd_graph(const my_expression& expr) {
+  std::unordered_map<std::string, int> var_map;
+  const expression_program program = compile_expression(expr, var_map);
+  DdManager* mgr = Cudd_Init(static_cast<unsigned int>(program.variable_count), 0,
+                             CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+  DdNode* root = convert_expression_to_cudd(*mgr, program);
+  dagir::ir_graph ir;
+  {
+    cudd_read_only_dag_view view(mgr, nullptr, {root});
+    ir = dagir::build_ir(view, cudd_node_attributor{}, cudd_edge_attributor{});
+  }
+  Cudd_RecursiveDeref(mgr, root);
+  Cudd_Quit(mgr);
+  return ir;
+}
+
+/// True if `decoded` holds the nodes, edges and attributes of `ir` (ids renumbered).
+bool same_content(const dagir::ir_graph& ir, const dagir::ir_graph& decoded) {
+  if (ir.nodes.size() != decoded.nodes.size() || ir.edges.size() != decoded.edges.size()) {
+    return false;
+  }
+  auto without_id = [](dagir::ir_attr_map m) {
+    m.erase(dagir::ir_attrs::k_id);
+    return m;
+  };
+  std::unordered_map<std::uint64_t, std::uint64_t> position;
+  for (std::size_t i = 0; i < ir.nodes.size(); ++i) {
+    position.try_emplace(ir.nodes[i].id, i);
+    if (without_id(ir.nodes[i].attributes) != decoded.nodes[i].attributes) return false;
+  }
+  for (std::size_t i = 0; i < ir.edges.size(); ++i) {
+    const auto& e = ir.edges[i];
+    const auto& d = decoded.edges[i];
+    if (position.at(e.source) != d.source || position.at(e.target) != d.target ||
+        without_id(e.attributes) != d.attributes) {
+      return false;
+    }
+  }
+  return ir.global_attrs == decoded.global_attrs;
+}
+
+void report(const workload& w, std::size_t repetitions) {
+  std::string json;
+  std::string minified;
+  std::string cbor;
+  const double json_ms = best_ms(repetitions, [&] {
+    std::ostringstream oss;
+    dagir::render_json(oss, w.ir);
+    json = oss.str();
+  });
+  const double minified_ms = best_ms(repetitions, [&] {
+    std::ostringstream oss;
+    dagir::render_json(oss, w.ir, dagir::json_options{false, true});
+    minified = oss.str();
+  });
+  const double cbor_ms = best_ms(repetitions, [&] {
+    std::ostringstream oss;
+    dagir::render_cbor(oss, w.ir);
+    cbor = oss.str();
+  });
+  dagir::ir_document loaded;
+  const double load_ms = best_ms(repetitions, [&] { loaded = dagir::load_json(minified); });
+  dagir::ir_document decoded;
+  const double decode_ms = best_ms(repetitions, [&] { decoded = dagir::decode_cbor(cbor); });
+  auto mb_per_s = [](const std::string& bytes, double ms) {
+    return static_cast<double>(bytes.size()) / 1e3 / ms;
+  };
+
+  std::cout << std::format(
+      "{:<28} {:>8} {:>11} {:>11} {:>10} {:>6.1f}% {:>9.1f} {:>9.1f} {:>9.1f} {:>9.1f} {:>8.1f} "
+      "{:>9.1f} {:>8.1f} {:>5}\n",
+      w.name, w.ir.nodes.size(), json.size(), minified.size(), cbor.size(),
+      100.0 * static_cast<double>(cbor.size()) / static_cast<double>(minified.size()), json_ms,
+      minified_ms, cbor_ms, load_ms, mb_per_s(minified, load_ms), decode_ms,
+      mb_per_s(cbor, decode_ms),
+      same_content(w.ir, loaded.graph) && same_content(w.ir, decoded.graph) ? "yes" : "NO");
+}
+
+std::vector<workload> load_workloads(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".expr") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<workload> out;
+  for (const auto& f : files) {
+    out.push_back({f.stem().string(), bdd_graph(*read_expression_from_file(f.string()))});
+  }
+  out.push_back(
+      {"generated_10_queens", bdd_graph(*parse_expression(make_n_queens_expression(10)))});
+  out.push_back({"synthetic_20x5000", synthetic_graph(20, 5000, 1)});
+  out.push_back({"synthetic_40x10000", synthetic_graph(40, 10000, 2)});
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <expressions_dir> [repetitions]\n";
+    return 1;
+  }
+
+  try {
+    const std::size_t repetitions =
+        (argc == 3) ? std::max<std::size_t>(1, std::stoull(argv[2])) : 5;
+    const auto workloads = load_workloads(argv[1]);
+
+    std::cout << "Sizes in bytes; times in ms (best of " << repetitions
+              << "); read throughput in MB/s.\n";
+    std::cout << std::format(
+        "{:<28} {:>8} {:>11} {:>11} {:>10} {:>7} {:>9} {:>9} {:>9} {:>9} {:>8} {:>9} {:>8} {:>5}\n",
+        "workload", "nodes", "json", "json-min", "cbor", "ratio", "json ms", "min ms", "cbor ms",
+        "load ms", "MB/s", "decode ms", "MB/s", "same");
+    for (const auto& w : workloads) report(w, repetitions);
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
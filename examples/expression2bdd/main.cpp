@@ -2,28 +2,56 @@
  * @file main.cpp
  * @brief Sample CLI: parse expression, convert to BDD, render IR via DagIR
  *
- * Usage: expression2bdd <expr_file> <library> <backend>
- *   library: teddy
- *   backend: dot | json | mermaid
+ * Usage: expression2bdd <expr_file> <library> <backend> [options]
+ *   library: teddy | cudd
+ *   backend: dot | json | mermaid | svg | graphml | ndjson | cbor
+ *   options: see `print_usage`
  *
  * SPDX-License-Identifier: MIT
  */
 
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <dagir/build_ir.hpp>
+#include <dagir/render_cbor.hpp>
 #include <dagir/render_dot.hpp>
+#include <dagir/render_graphml.hpp>
 #include <dagir/render_json.hpp>
 #include <dagir/render_mermaid.hpp>
+#include <dagir/render_ndjson.hpp>
+#include <dagir/render_svg.hpp>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
 #include <set>
 #include <span>
+#include <sstream>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+// Model counting and cube enumeration
+#include <dagir/bdd_cubes.hpp>
+#include <dagir/bdd_sat_count.hpp>
+
 // Expression parser
 #include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/variable_order.hpp>
+
+// Output, caching and portfolio helpers
+#include <dagir/utility/async_output.hpp>
+#include <dagir/utility/byte_size.hpp>
+#include <dagir/utility/portfolio.hpp>
+#include <dagir/utility/render_cache.hpp>
 
 // Teddy-specific helpers
 #include <dagir/utility/teddy/teddy_convert_expression.hpp>
@@ -31,6 +59,7 @@
 #include <dagir/utility/teddy/teddy_read_only_dag_view.hpp>
 
 // CUDD-specific helpers
+#include <dagir/utility/cudd/cudd_config.hpp>
 #include <dagir/utility/cudd/cudd_convert_expression.hpp>
 #include <dagir/utility/cudd/cudd_policy.hpp>
 #include <dagir/utility/cudd/cudd_read_only_dag_view.hpp>
@@ -41,11 +70,16 @@
  * Sorts nodes and edges deterministically to ensure stable output, then
  * forwards to the selected renderer (`dot`, `json`, or `mermaid`).
  *
+ * @param os Output stream.
  * @param in_ir Input IR graph (copied internally for reordering).
  * @param backend Target backend name: "dot", "json", or "mermaid".
+ * @param dot Layout hints for the `dot` backend; its `hoist_defaults`,
+ *            `minified` and `threads` settings apply to the `json` and
+ *            `mermaid` backends too.
  * @throws std::runtime_error If an unknown backend is requested.
  */
-static void emit_ir(const dagir::ir_graph& in_ir, const std::string& backend) {
+static void emit_ir(std::ostream& os, const dagir::ir_graph& in_ir, const std::string& backend,
+                    const dagir::dot_options& dot = {}) {
   dagir::ir_graph ir = in_ir;  // make a local copy we can reorder
 
   auto node_print_name = [&](const dagir::ir_node& n) {
@@ -140,13 +174,23 @@ static void emit_ir(const dagir::ir_graph& in_ir, const std::string& backend) {
             });
 
   if (backend == "dot") {
-    dagir::render_dot(std::cout, ir, "bdd");
+    dagir::render_dot(os, ir, dot, "bdd");
   } else if (backend == "json") {
-    dagir::render_json(std::cout, ir);
+    dagir::render_json(os, ir, dagir::json_options{dot.hoist_defaults, dot.minified, dot.threads});
   } else if (backend == "mermaid") {
-    std::cout << "```mermaid\n";
-    dagir::render_mermaid(std::cout, ir, "bdd");
-    std::cout << "```\n";
+    os << "```mermaid\n";
+    dagir::render_mermaid(os, ir,
+                          dagir::mermaid_options{dot.hoist_defaults, dot.minified, dot.threads},
+                          "bdd");
+    os << "```\n";
+  } else if (backend == "graphml") {
+    dagir::render_graphml(os, ir, "bdd");
+  } else if (backend == "ndjson") {
+    dagir::render_ndjson(os, ir);
+  } else if (backend == "cbor") {
+    dagir::render_cbor(os, ir);
+  } else if (backend == "svg") {
+    dagir::render_svg(os, ir);
   } else {
     std::cerr << "Unknown backend: " << backend << "\n";
     throw std::runtime_error("Unknown backend");
@@ -212,20 +256,207 @@ static std::vector<std::string> build_var_names(
   return var_names;
 }
 
+/**
+ * @brief Print the command line synopsis and options to stderr.
+ */
+static void print_usage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " <expression_file> <library> <backend> [options]\n"
+            << "library: teddy | cudd\n"
+            << "backend: dot | json | mermaid | svg | graphml | ndjson | cbor\n"
+            << "options:\n"
+            << "  --order=<first_seen|dfs_fanin|weighted|force>  static variable order\n"
+            << "  --portfolio=<n>            race n variable orders on n threads\n"
+            << "  --portfolio-policy=<first|smallest>  winner: first finished or smallest\n"
+            << "  --budget-ms=<ms>           portfolio time budget\n"
+            << "  --unique-slots=<n>         CUDD initial unique subtable slots\n"
+            << "  --cache-slots=<n>          CUDD initial computed-table slots\n"
+            << "  --max-memory=<bytes[K|M|G]>  CUDD hard memory limit\n"
+            << "  --reorder=<method>         CUDD autodyn method (sift, symm_sift, group_sift...)\n"
+            << "  --reorder-threshold=<n>    live nodes before the first CUDD reordering\n"
+            << "  --max-growth=<factor>      CUDD sifting growth limit\n"
+            << "  --max-reorderings=<n>      CUDD limit on automatic reorderings\n"
+            << "  --final-reorder            CUDD reordering once the BDD is built\n"
+            << "  --stats                    print build statistics to stderr\n"
+            << "  --count                    print the number of models to stderr\n"
+            << "  --cubes=<k>                print the first k satisfying cubes to stderr\n"
+            << "  --max-nodes=<n>            render at most n BDD nodes, summarizing the rest\n"
+            << "  --max-depth=<n>            render nodes at most n edges below the root\n"
+            << "  --dot-fast                 dot: rank by level, split terminals, hoist defaults,\n"
+            << "                             straight edges and small layout budgets\n"
+            << "  --dot-splines=<mode>       dot: graph splines attribute (line, polyline, ...)\n"
+            << "  --dot-nslimit=<f>          dot: network simplex iteration factor\n"
+            << "  --dot-mclimit=<f>          dot: crossing minimization iteration factor\n"
+            << "  --hoist-defaults           write common attribute values once as defaults\n"
+            << "  --minified                 short node ids and no optional whitespace\n"
+            << "  --render-threads=<n>       format dot/json/mermaid output on n threads\n"
+            << "  --output=<file>            write the output to file on a background thread\n"
+            << "  --write-buffer=<bytes[K|M|G]>  background writer buffer size (default 1M)\n"
+            << "  --direct-io                open --output with O_DIRECT (Linux)\n"
+            << "  --gzip                     gzip the output on the background writer thread\n"
+            << "  --cache-dir=<dir>          reuse output rendered earlier for the same input\n"
+            << "  --cache-max-bytes=<bytes[K|M|G]>  cache size limit (default 256M)\n"
+            << "  --cache-stats              print cache hits and misses to stderr\n";
+}
+
+/**
+ * @brief Print up to `k` satisfying cubes of the first root of `view`, one per
+ *        line, listing the fixed variables as `name=0|1`.
+ */
+template <dagir::concepts::bdd_view View>
+static void write_cubes(std::ostream& os, const View& view,
+                        const std::vector<std::string>& var_names, std::size_t k) {
+  const dagir::bdd_table table = dagir::flatten_bdd(view);
+  dagir::bdd_cube_enumerator cubes(table);
+  for (std::size_t i = 0; i < k && cubes.next(); ++i) {
+    const char* sep = "cube:";
+    for (std::size_t v = 0; v < cubes.cube().size(); ++v) {
+      if (cubes.cube()[v] == dagir::cube_literal::dont_care) continue;
+      os << sep << ' ' << (v < var_names.size() ? var_names[v] : "x" + std::to_string(v)) << '='
+         << (cubes.cube()[v] == dagir::cube_literal::one ? 1 : 0);
+      sep = "";
+    }
+    os << (*sep ? "cube: true" : "") << "\n";
+  }
+}
+
+/**
+ * @brief Variable map for portfolio candidate `index`.
+ *
+ * Candidates cycle through the static heuristics starting at `base`; once
+ * every heuristic is in use, further candidates use seeded random shuffles of
+ * the `dfs_fanin` order.
+ */
+static std::unordered_map<std::string, int> candidate_var_map(
+    const dagir::utility::my_expression& expr, dagir::utility::variable_order_heuristic base,
+    std::size_t index) {
+  using namespace dagir::utility;
+  constexpr variable_order_heuristic heuristics[] = {
+      variable_order_heuristic::first_seen, variable_order_heuristic::dfs_fanin,
+      variable_order_heuristic::weighted_interleaving, variable_order_heuristic::force};
+  constexpr std::size_t count = std::size(heuristics);
+
+  std::unordered_map<std::string, int> var_map;
+  const expression_program program = compile_expression(expr, var_map);
+  if (index < count) {
+    const std::size_t slot =
+        (static_cast<std::size_t>(base) + index) % count;  // enum order matches `heuristics`
+    apply_variable_order(var_map, compute_variable_order(program, heuristics[slot]));
+  } else {
+    auto order = compute_variable_order(program, variable_order_heuristic::dfs_fanin);
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(index));
+    std::shuffle(order.begin(), order.end(), rng);
+    apply_variable_order(var_map, order);
+  }
+  return var_map;
+}
+
+/**
+ * @brief TeDDy manager and diagram built for one variable order.
+ *
+ * The manager is declared first so the diagram is released before it.
+ */
+struct teddy_build {
+  std::unordered_map<std::string, int> var_map;
+  std::unique_ptr<teddy::bdd_manager> mgr;
+  std::optional<teddy::bdd_manager::diagram_t> diag;
+};
+
+static teddy_build build_teddy(const dagir::utility::my_expression& expr,
+                               std::unordered_map<std::string, int> var_map,
+                               std::stop_token stop = {}) {
+  using namespace dagir::utility;
+  teddy_build out;
+  const expression_program program = compile_expression(expr, var_map);
+  out.var_map = std::move(var_map);
+  out.mgr = std::make_unique<teddy::bdd_manager>(
+      static_cast<int32_t>(std::max<std::size_t>(out.var_map.size(), 1)), 1024);
+  out.diag.emplace(
+      convert_expression_to_teddy(*out.mgr, program, expression_schedule::smallest_first, stop));
+  return out;
+}
+
+/**
+ * @brief CUDD manager and referenced root built for one variable order.
+ */
+struct cudd_build {
+  std::unordered_map<std::string, int> var_map;
+  DdManager* mgr = nullptr;
+  DdNode* root = nullptr;
+
+  cudd_build() = default;
+  cudd_build(cudd_build&& other) noexcept
+      : var_map(std::move(other.var_map)),
+        mgr(std::exchange(other.mgr, nullptr)),
+        root(std::exchange(other.root, nullptr)) {}
+  cudd_build& operator=(cudd_build&&) = delete;
+  ~cudd_build() {
+    if (root) Cudd_RecursiveDeref(mgr, root);
+    if (mgr) Cudd_Quit(mgr);
+  }
+};
+
+static cudd_build build_cudd(const dagir::utility::my_expression& expr,
+                             std::unordered_map<std::string, int> var_map,
+                             const dagir::utility::cudd_config& settings,
+                             std::stop_token stop = {}) {
+  using namespace dagir::utility;
+  cudd_build out;
+  const expression_program program = compile_expression(expr, var_map);
+  out.var_map = std::move(var_map);
+  out.mgr = make_cudd_manager(static_cast<unsigned int>(out.var_map.size()), settings);
+  out.root = convert_expression_to_cudd(*out.mgr, program, settings,
+                                        expression_schedule::smallest_first, stop);
+  return out;
+}
+
+/**
+ * @brief Write one line per portfolio candidate to stderr.
+ */
+static void print_portfolio_reports(const std::vector<dagir::utility::portfolio_report>& reports,
+                                    std::size_t winner) {
+  using dagir::utility::portfolio_status;
+  for (std::size_t i = 0; i < reports.size(); ++i) {
+    const auto& r = reports[i];
+    const char* status = r.status == portfolio_status::finished    ? "finished"
+                         : r.status == portfolio_status::cancelled ? "cancelled"
+                                                                   : "failed";
+    std::cerr << "candidate " << i << ": " << status << ", " << r.elapsed.count() << " ms";
+    if (r.status == portfolio_status::finished) std::cerr << ", " << r.size << " nodes";
+    if (r.status == portfolio_status::failed) std::cerr << ", " << r.error;
+    if (i == winner && r.status == portfolio_status::finished) std::cerr << " (winner)";
+    std::cerr << "\n";
+  }
+}
+
+/**
+ * @brief Run a portfolio of `build` and return the winner or throw.
+ */
+template <class Build, class Candidate, class Size>
+static Build race(std::size_t candidates, Candidate&& candidate, Size&& size,
+                  const dagir::utility::portfolio_options& options, bool print_stats) {
+  auto outcome = dagir::utility::run_portfolio<Build>(candidates, candidate, size, options);
+  if (print_stats) print_portfolio_reports(outcome.reports, outcome.winner_index);
+  if (!outcome.winner) {
+    for (const auto& r : outcome.reports) {
+      if (r.status == dagir::utility::portfolio_status::failed) throw std::runtime_error(r.error);
+    }
+    throw std::runtime_error("no portfolio candidate finished within the time budget");
+  }
+  return std::move(*outcome.winner);
+}
+
 /**
  * @brief CLI entrypoint for the expression2bdd sample application.
  *
- * Usage: expression2bdd <expression_file> <library> <backend>
+ * Usage: expression2bdd <expression_file> <library> <backend> [options]
  *   library: teddy | cudd
- *   backend: dot | json | mermaid
+ *   backend: dot | json | mermaid | svg | graphml | ndjson | cbor
  */
 int main(int argc, char** argv) {
   using namespace dagir::utility;
 
   if (argc < 4) {
-    std::cerr << "Usage: " << argv[0] << " <expression_file> <library> <backend>\n";
-    std::cerr << "library: teddy | cudd\n";
-    std::cerr << "backend: dot | json | mermaid\n";
+    print_usage(argv[0]);
     return 1;
   }
 
@@ -234,62 +465,250 @@ int main(int argc, char** argv) {
   const std::string backend = argv[3];
 
   try {
+    variable_order_heuristic order_heuristic = variable_order_heuristic::first_seen;
+    cudd_config cudd_settings;
+    std::size_t portfolio_size = 0;
+    portfolio_options portfolio;
+    bool print_stats = false;
+    bool print_count = false;
+    std::size_t print_cubes = 0;
+    dagir::build_ir_options ir_options;
+    dagir::dot_options dot_settings;
+    std::string cache_dir;
+    std::uint64_t cache_max_bytes = std::uint64_t{256} << 20;
+    bool print_cache_stats = false;
+    std::string output_file;
+    async_output_options write_settings;
+    std::string output_options;  // options that affect the rendered output
+    if (std::find(argv + 4, argv + argc, std::string_view("--dot-fast")) != argv + argc) {
+      dot_settings = dagir::dot_options::fast();
+    }
+    for (int i = 4; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      const auto eq = arg.find('=');
+      const std::string_view key = arg.substr(0, eq);
+      const std::string value(eq == std::string_view::npos ? std::string_view{}
+                                                            : arg.substr(eq + 1));
+      if (key != "--stats" && key != "--count" && key != "--cubes" && key != "--render-threads" &&
+          key != "--output" && key != "--write-buffer" && key != "--direct-io" &&
+          key != "--gzip" && !key.starts_with("--cache")) {
+        output_options.append(arg).push_back('\n');
+      }
+      if (key == "--order") {
+        order_heuristic = parse_variable_order_heuristic(value);
+      } else if (key == "--portfolio") {
+        portfolio_size = static_cast<std::size_t>(std::stoul(value));
+      } else if (key == "--portfolio-policy") {
+        if (value == "first") {
+          portfolio.policy = portfolio_policy::first_finished;
+        } else if (value == "smallest") {
+          portfolio.policy = portfolio_policy::smallest_within_budget;
+        } else {
+          throw std::invalid_argument("unknown portfolio policy: " + value);
+        }
+      } else if (key == "--budget-ms") {
+        portfolio.budget = std::chrono::milliseconds(std::stoll(value));
+      } else if (key == "--unique-slots") {
+        cudd_settings.unique_slots = static_cast<unsigned int>(std::stoul(value));
+      } else if (key == "--cache-slots") {
+        cudd_settings.cache_slots = static_cast<unsigned int>(std::stoul(value));
+      } else if (key == "--max-memory") {
+        cudd_settings.max_memory = parse_byte_size(value);
+      } else if (key == "--reorder") {
+        cudd_settings.reorder_method = parse_cudd_reorder_method(value);
+      } else if (key == "--reorder-threshold") {
+        cudd_settings.first_reorder_threshold = static_cast<unsigned int>(std::stoul(value));
+      } else if (key == "--max-growth") {
+        cudd_settings.max_growth = std::stod(value);
+      } else if (key == "--max-reorderings") {
+        cudd_settings.max_reorderings = static_cast<unsigned int>(std::stoul(value));
+      } else if (arg == "--final-reorder") {
+        cudd_settings.reorder_after_build = true;
+      } else if (arg == "--stats") {
+        print_stats = true;
+      } else if (arg == "--count") {
+        print_count = true;
+      } else if (key == "--cubes") {
+        print_cubes = static_cast<std::size_t>(std::stoul(value));
+      } else if (key == "--max-nodes") {
+        ir_options.max_nodes = static_cast<std::size_t>(std::stoull(value));
+      } else if (key == "--max-depth") {
+        ir_options.max_depth = static_cast<std::size_t>(std::stoull(value));
+      } else if (arg == "--dot-fast") {
+        // Applied before the loop so that it never resets other dot options.
+      } else if (arg == "--hoist-defaults") {
+        dot_settings.hoist_defaults = true;
+      } else if (arg == "--minified") {
+        dot_settings.minified = true;
+      } else if (key == "--render-threads") {
+        dot_settings.threads = static_cast<unsigned>(std::stoul(value));
+      } else if (key == "--dot-splines") {
+        dot_settings.splines = value;
+      } else if (key == "--dot-nslimit") {
+        dot_settings.nslimit = dot_settings.nslimit1 = std::stod(value);
+      } else if (key == "--dot-mclimit") {
+        dot_settings.mclimit = std::stod(value);
+      } else if (key == "--cache-dir") {
+        cache_dir = value;
+      } else if (key == "--cache-max-bytes") {
+        cache_max_bytes = parse_byte_size(value);
+      } else if (arg == "--cache-stats") {
+        print_cache_stats = true;
+      } else if (key == "--output") {
+        output_file = value;
+      } else if (key == "--write-buffer") {
+        write_settings.buffer_size = parse_byte_size(value);
+      } else if (arg == "--direct-io") {
+        write_settings.direct_io = true;
+      } else if (arg == "--gzip") {
+        write_settings.gzip = true;
+      } else {
+        std::cerr << "Unknown option: " << arg << "\n";
+        print_usage(argv[0]);
+        return 1;
+      }
+    }
+
+    // Output goes to stdout, or through the background writer when a file or
+    // compression was requested.
+    std::optional<async_ostream> async_out;
+    if (!output_file.empty()) {
+      async_out.emplace(std::filesystem::path(output_file), write_settings);
+    } else if (write_settings.gzip) {
+      async_out.emplace(std::cout, write_settings);
+    }
+    std::ostream& dest = async_out ? static_cast<std::ostream&>(*async_out) : std::cout;
+
+    // Content-addressed cache keyed by the file bytes, library, backend and
+    // output-affecting options. A hit skips parsing and conversion, so it is
+    // not consulted when build diagnostics were requested. A portfolio whose
+    // winner depends on timing (the first to finish, or the smallest within
+    // a time budget) renders different variable orders from run to run, so
+    // its output is not cached at all.
+    const bool timing_dependent =
+        portfolio_size != 0 && (portfolio.policy == portfolio_policy::first_finished ||
+                                portfolio.budget.count() != 0);
+    std::optional<render_cache> cache;
+    dagir::hash128 cache_key;
+    if (!cache_dir.empty() && !timing_dependent) {
+      std::ifstream in(filename, std::ios::binary);
+      if (!in) throw std::runtime_error("Could not open file: " + filename);
+      const std::string contents((std::istreambuf_iterator<char>(in)),
+                                 std::istreambuf_iterator<char>());
+      cache.emplace(cache_dir, cache_max_bytes);
+      cache_key = render_cache_key({"expression2bdd", contents, library, backend, output_options});
+      if (!print_stats && !print_count && print_cubes == 0) {
+        if (auto hit = cache->lookup(cache_key)) {
+          dest << *hit;
+          if (async_out) async_out->close();
+          if (print_cache_stats) write_render_cache_stats(std::cerr, *cache);
+          return 0;
+        }
+      }
+    }
+    std::ostringstream buffer;
+    std::ostream& out = cache ? static_cast<std::ostream&>(buffer) : dest;
+
     my_expression_ptr expr = read_expression_from_file(filename);
 
     // Use DagIR algorithms to collect variable names from the expression AST.
     auto var_map = build_var_map(expr.get());
-    // Build inverse map (index -> name) once and reuse for both libraries
-    auto var_names = build_var_names(var_map);
+    if (order_heuristic != variable_order_heuristic::first_seen) {
+      // Renumber variables so that index == level in the chosen static order.
+      const expression_program program = compile_expression(*expr, var_map);
+      apply_variable_order(var_map, compute_variable_order(program, order_heuristic));
+    }
 
     if (library == "teddy") {
-      // Create a Teddy manager and convert expression to a diagram
-      teddy::bdd_manager mgr(static_cast<int32_t>(var_map.size()), 1024);
-
-      auto diag = convert_expression_to_teddy(mgr, *expr, var_map);
+      teddy_build built =
+          portfolio_size == 0
+              ? build_teddy(*expr, var_map)
+              : race<teddy_build>(
+                    portfolio_size,
+                    [&](std::size_t i, std::stop_token stop) {
+                      return build_teddy(*expr, candidate_var_map(*expr, order_heuristic, i),
+                                         stop);
+                    },
+                    [](const teddy_build& b) {
+                      return static_cast<std::size_t>(b.mgr->get_node_count(*b.diag));
+                    },
+                    portfolio, print_stats);
+
+      // Build inverse map (index -> name) for the winning variable numbering
+      auto var_names = build_var_names(built.var_map);
 
       // Extract root pointer
       std::vector<teddy::bdd_manager::diagram_t::node_t*> roots;
-      roots.push_back(diag.unsafe_get_root());
+      roots.push_back(built.diag->unsafe_get_root());
 
-      dagir::utility::teddy_read_only_dag_view view(&mgr, &var_names, std::move(roots));
+      dagir::utility::teddy_read_only_dag_view view(built.mgr.get(), &var_names,
+                                                    std::move(roots));
+      if (print_count) std::cerr << "models: " << to_string(dagir::sat_count(view)) << "\n";
+      if (print_cubes != 0) write_cubes(std::cerr, view, var_names, print_cubes);
 
       // Build IR using teddy policies and render deterministically
-      dagir::ir_graph ir = dagir::build_ir(view, dagir::utility::teddy_node_attributor{},
-                                           dagir::utility::teddy_edge_attributor{});
-      emit_ir(ir, backend);
+      // The SVG layout and DOT rank hints place nodes by BDD level.
+      dagir::ir_graph ir =
+          backend == "svg" || dot_settings.rank_by_level
+              ? dagir::build_ir(
+                    view, dagir::bdd_level_attributor{dagir::utility::teddy_node_attributor{}},
+                    dagir::utility::teddy_edge_attributor{}, ir_options)
+              : dagir::build_ir(view, dagir::utility::teddy_node_attributor{},
+                                dagir::utility::teddy_edge_attributor{}, ir_options);
+      emit_ir(out, ir, backend, dot_settings);
 
     } else if (library == "cudd") {
-      // Initialize CUDD manager
-      DdManager* mgr =
-          Cudd_Init(static_cast<int>(var_map.size()), 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
-
-      DdNode* diag = convert_expression_to_cudd(*mgr, *expr, var_map);
+      // Portfolio candidates resize their CUDD tables concurrently.
+      std::optional<cudd_concurrent_managers> concurrent;
+      if (portfolio_size != 0) concurrent.emplace();
+      cudd_build built =
+          portfolio_size == 0
+              ? build_cudd(*expr, var_map, cudd_settings)
+              : race<cudd_build>(
+                    portfolio_size,
+                    [&](std::size_t i, std::stop_token stop) {
+                      return build_cudd(*expr, candidate_var_map(*expr, order_heuristic, i),
+                                        cudd_settings, stop);
+                    },
+                    [](const cudd_build& b) {
+                      return static_cast<std::size_t>(Cudd_DagSize(b.root));
+                    },
+                    portfolio, print_stats);
+      concurrent.reset();
+      if (print_stats) write_cudd_stats(std::cerr, read_cudd_stats(*built.mgr));
+
+      auto var_names = build_var_names(built.var_map);
 
       std::vector<DdNode*> roots;
-      roots.push_back(diag);
+      roots.push_back(built.root);
 
-      dagir::utility::cudd_read_only_dag_view view(mgr, &var_names, std::move(roots));
+      dagir::utility::cudd_read_only_dag_view view(built.mgr, &var_names, std::move(roots));
+      if (print_count) std::cerr << "models: " << to_string(dagir::sat_count(view)) << "\n";
+      if (print_cubes != 0) write_cubes(std::cerr, view, var_names, print_cubes);
 
       // Build IR using cudd policies and render deterministically
-      dagir::ir_graph ir = dagir::build_ir(view, dagir::utility::cudd_node_attributor{},
-                                           dagir::utility::cudd_edge_attributor{});
-      try {
-        emit_ir(ir, backend);
-      } catch (...) {
-        Cudd_RecursiveDeref(mgr, diag);
-        Cudd_Quit(mgr);
-        throw;
-      }
-
-      // Clean up CUDD objects
-      Cudd_RecursiveDeref(mgr, diag);
-      Cudd_Quit(mgr);
+      // The SVG layout and DOT rank hints place nodes by BDD level.
+      dagir::ir_graph ir =
+          backend == "svg" || dot_settings.rank_by_level
+              ? dagir::build_ir(
+                    view, dagir::bdd_level_attributor{dagir::utility::cudd_node_attributor{}},
+                    dagir::utility::cudd_edge_attributor{}, ir_options)
+              : dagir::build_ir(view, dagir::utility::cudd_node_attributor{},
+                                dagir::utility::cudd_edge_attributor{}, ir_options);
+      emit_ir(out, ir, backend, dot_settings);
 
     } else {
       std::cerr << "Unsupported library: " << library << "\n";
       return 1;
     }
 
+    if (cache) {
+      dest << buffer.view();
+      cache->store(cache_key, buffer.view());
+      if (print_cache_stats) write_render_cache_stats(std::cerr, *cache);
+    }
+    if (async_out) async_out->close();
+
   } catch (const std::exception& e) {
     std::cerr << "Error: " << e.what() << "\n";
     return 1;
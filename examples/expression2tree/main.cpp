@@ -8,11 +8,20 @@
  */
 
 #include <dagir/build_ir.hpp>
+#include <dagir/render_cbor.hpp>
 #include <dagir/render_dot.hpp>
+#include <dagir/render_graphml.hpp>
 #include <dagir/render_json.hpp>
 #include <dagir/render_mermaid.hpp>
+#include <dagir/render_ndjson.hpp>
+#include <dagir/render_svg.hpp>
+#include <cstdint>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
 
@@ -21,19 +30,66 @@
 #include <dagir/utility/expressions/expression_policy.hpp>
 #include <dagir/utility/expressions/expression_read_only_dag_view.hpp>
 
+// Render cache
+#include <dagir/utility/byte_size.hpp>
+#include <dagir/utility/render_cache.hpp>
+
+static void print_usage(const char* argv0) {
+  std::cerr << "Usage: " << argv0 << " <expression_file> [backend] [options]\n"
+            << "Supported backends: dot, json, mermaid, svg, graphml, ndjson, cbor (default: dot)\n"
+            << "options:\n"
+            << "  --cache-dir=<dir>          reuse output rendered earlier for the same input\n"
+            << "  --cache-max-bytes=<bytes[K|M|G]>  cache size limit (default 256M)\n"
+            << "  --cache-stats              print cache hits and misses to stderr\n";
+}
+
 int main(int argc, char** argv) {
   using namespace dagir::utility;
 
-  if (argc < 2 || argc > 3) {
-    std::cerr << "Usage: " << argv[0] << " <expression_file> [backend]\n"
-              << "Supported backends: dot, json, mermaid (default: dot)\n";
+  if (argc < 2) {
+    print_usage(argv[0]);
     return 1;
   }
 
   const std::string filename = argv[1];
-  const std::string backend = (argc == 3) ? std::string(argv[2]) : std::string("dot");
-
   try {
+    std::string backend = "dot";
+    std::string cache_dir;
+    std::uint64_t cache_max_bytes = std::uint64_t{256} << 20;
+    bool print_cache_stats = false;
+    for (int i = 2; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      if (arg.starts_with("--cache-dir=")) {
+        cache_dir = std::string(arg.substr(12));
+      } else if (arg.starts_with("--cache-max-bytes=")) {
+        cache_max_bytes = parse_byte_size(arg.substr(18));
+      } else if (arg == "--cache-stats") {
+        print_cache_stats = true;
+      } else if (i == 2 && !arg.starts_with("--")) {
+        backend = std::string(arg);
+      } else {
+        print_usage(argv[0]);
+        return 1;
+      }
+    }
+
+    // Content-addressed cache: the key covers the file bytes and the backend.
+    std::optional<render_cache> cache;
+    dagir::hash128 cache_key;
+    if (!cache_dir.empty()) {
+      std::ifstream in(filename, std::ios::binary);
+      if (!in) throw std::runtime_error("Could not open file: " + filename);
+      const std::string contents((std::istreambuf_iterator<char>(in)),
+                                 std::istreambuf_iterator<char>());
+      cache.emplace(cache_dir, cache_max_bytes);
+      cache_key = render_cache_key({"expression2tree", contents, backend});
+      if (auto hit = cache->lookup(cache_key)) {
+        std::cout << *hit;
+        if (print_cache_stats) write_render_cache_stats(std::cerr, *cache);
+        return 0;
+      }
+    }
+
     // Read and parse the expression from the specified file
     my_expression_ptr expr = read_expression_from_file(filename);
 
@@ -45,8 +101,9 @@ int main(int argc, char** argv) {
     dagir::ir_graph ir = dagir::build_ir(dag_view, dagir::utility::expression_node_attributor{},
                                          dagir::utility::expression_edge_attributor{});
 
-    // Render using the requested backend to stdout.
-    std::ostream& os = std::cout;
+    // Render using the requested backend (to a buffer when caching).
+    std::ostringstream buffer;
+    std::ostream& os = cache ? static_cast<std::ostream&>(buffer) : std::cout;
     if (backend == "dot") {
       dagir::render_dot(os, ir, "expression");
     } else if (backend == "json") {
@@ -56,12 +113,26 @@ int main(int argc, char** argv) {
       os << "```mermaid\n";
       dagir::render_mermaid(os, ir, "expression");
       os << "```\n";
+    } else if (backend == "graphml") {
+      dagir::render_graphml(os, ir, "expression");
+    } else if (backend == "ndjson") {
+      dagir::render_ndjson(os, ir);
+    } else if (backend == "cbor") {
+      dagir::render_cbor(os, ir);
+    } else if (backend == "svg") {
+      dagir::render_svg(os, ir);
     } else {
       std::cerr << "Unknown backend: " << backend << "\n";
-      std::cerr << "Supported backends: dot, json, mermaid\n";
+      std::cerr << "Supported backends: dot, json, mermaid, svg, graphml, ndjson, cbor\n";
       return 1;
     }
 
+    if (cache) {
+      std::cout << buffer.view();
+      cache->store(cache_key, buffer.view());
+      if (print_cache_stats) write_render_cache_stats(std::cerr, *cache);
+    }
+
   } catch (const std::exception& e) {
     std::cerr << "Error: " << e.what() << "\n";
     return 1;
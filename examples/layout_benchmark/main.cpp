@@ -0,0 +1,169 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark: crossing reduction of the layered layout versus thread count.
+ *
+ * Usage: layout_benchmark <expressions_dir> [max_threads] [restarts]
+ *
+ * Lays out the CUDD BDD of every `*.expr` file in `expressions_dir`, the
+ * generated 10-Queens constraints and synthetic BDD-shaped layered graphs
+ * (wide layers, two edges from every node to deeper layers) with
+ * `dagir::layered_layout`. Every workload is laid out once without restarts,
+ * then with `restarts` random restarts (default 3) for 1, 2, 4, ... up to
+ * `max_threads` threads (default: the hardware concurrency). Each row reports
+ * the crossings between adjacent layers, the wall time, the speedup over one
+ * thread and whether the layer order is identical to the one-thread run.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <dagir/build_ir.hpp>
+#include <dagir/layout.hpp>
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+
+#include <dagir/utility/cudd/cudd_convert_expression.hpp>
+#include <dagir/utility/cudd/cudd_read_only_dag_view.hpp>
+
+namespace {
+
+using namespace dagir::utility;
+using bench_clock = std::chrono::steady_clock;
+
+struct workload {
+  std::string name;
+  dagir::ir_graph ir;
+};
+
+double elapsed_seconds(bench_clock::time_point start) {
+  return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * @brief `depth` levels of `width` nodes; every node has two children below it.
+ *
+ * Most edges go to the next level, some skip levels, as in a BDD.
+ */
+dagir::ir_graph synthetic_graph(std::size_t depth, std::size_t width, std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  dagir::ir_graph g;
+  for (std::uint64_t i = 0; i < depth * width; ++i) {
+    g.nodes.push_back({i, {{dagir::ir_attrs::k_level, std::to_string(i / width)}}});
+  }
+  for (std::uint64_t r = 0; r + 1 < depth; ++r) {
+    for (std::uint64_t i = 0; i < width; ++i) {
+      for (int k = 0; k < 2; ++k) {
+        const std::uint64_t skip = rng() % 8 == 0 ? 1 + rng() % (depth - r - 1) : 1;
+        const std::uint64_t target = (r + skip) * width + rng() % width;
+        g.edges.push_back({r * width + i, target, {}});
+      }
+    }
+  }
+  return g;
+}
+
+/// IR of the BDD of `expr`, with levels, without display attributes.
+dagir::ir_graph bdd_graph(const my_expression& expr) {
+  std::unordered_map<std::string, int> var_map;
+  const expression_program program = compile_expression(expr, var_map);
+  DdManager* mgr = Cudd_Init(static_cast<unsigned int>(program.variable_count), 0,
+                             CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+  DdNode* root = convert_expression_to_cudd(*mgr, program);
+  dagir::ir_graph ir;
+  {
+    cudd_read_only_dag_view view(mgr, nullptr, {root});
+    auto no_attrs = [](const auto&, const auto&) { return dagir::ir_attr_map{}; };
+    ir = dagir::build_ir(view, dagir::bdd_level_attributor{no_attrs},
+                         [](auto&&...) { return dagir::ir_attr_map{}; });
+  }
+  Cudd_RecursiveDeref(mgr, root);
+  Cudd_Quit(mgr);
+  return ir;
+}
+
+void report(const workload& w, unsigned max_threads, std::size_t restarts) {
+  auto run = [&](unsigned threads, std::size_t r) {
+    dagir::layout_options options;
+    options.threads = threads;
+    options.restarts = r;
+    const auto start = bench_clock::now();
+    dagir::graph_layout l = dagir::layered_layout(w.ir, options);
+    return std::pair{std::move(l), elapsed_seconds(start) * 1e3};
+  };
+  auto row = [&](unsigned threads, std::size_t r, const dagir::graph_layout& l, double ms,
+                 double speedup, bool same) {
+    std::cout << std::format("{:<32} {:>8} {:>7} {:>8} {:>10} {:>10.1f} {:>8.2f} {:>5}\n", w.name,
+                             w.ir.nodes.size(), threads, r, l.crossings, ms, speedup,
+                             same ? "yes" : "NO");
+  };
+
+  const auto [plain, plain_ms] = run(1, 0);
+  row(1, 0, plain, plain_ms, 1.0, true);
+  const auto [serial, serial_ms] = run(1, restarts);
+  row(1, restarts, serial, serial_ms, 1.0, true);
+  for (unsigned t = 2; t <= max_threads; t *= 2) {
+    const auto [l, ms] = run(t, restarts);
+    row(t, restarts, l, ms, serial_ms / ms, l.layers == serial.layers);
+  }
+}
+
+std::vector<workload> load_workloads(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".expr") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<workload> out;
+  for (const auto& f : files) {
+    out.push_back({f.stem().string(), bdd_graph(*read_expression_from_file(f.string()))});
+  }
+  out.push_back(
+      {"generated_10_queens", bdd_graph(*parse_expression(make_n_queens_expression(10)))});
+  out.push_back({"synthetic_20x1000", synthetic_graph(20, 1000, 1)});
+  out.push_back({"synthetic_40x5000", synthetic_graph(40, 5000, 2)});
+  out.push_back({"synthetic_10x50000", synthetic_graph(10, 50000, 3)});
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "Usage: " << argv[0] << " <expressions_dir> [max_threads] [restarts]\n";
+    return 1;
+  }
+
+  try {
+    const unsigned max_threads =
+        (argc >= 3) ? std::max(1u, static_cast<unsigned>(std::stoul(argv[2])))
+                    : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t restarts = (argc == 4) ? std::stoull(argv[3]) : 3;
+    const auto workloads = load_workloads(argv[1]);
+
+    std::cout << "Crossings between adjacent layers; speedup over one thread with restarts.\n";
+    std::cout << std::format("{:<32} {:>8} {:>7} {:>8} {:>10} {:>10} {:>8} {:>5}\n", "workload",
+                             "nodes", "threads", "restarts", "crossings", "ms", "speedup", "same");
+    for (const auto& w : workloads) report(w, max_threads, restarts);
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
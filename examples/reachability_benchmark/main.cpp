@@ -0,0 +1,177 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark: reachability queries by traversal versus bitset indexes.
+ *
+ * Usage: reachability_benchmark <expressions_dir> [queries]
+ *
+ * For every `*.expr` file in `expressions_dir` plus generated 8-Queens and
+ * 10-Queens constraints, builds the BDD with CUDD and answers random
+ * "does node a reach node b" queries over its read-only view with:
+ *
+ * - `dfs`: a fresh depth-first search through the view per query, stopping
+ *   early when `b` is found (at most 20000 queries);
+ * - `eager`: `reachability_index`, reporting build time, query rate and size;
+ * - `lazy`: `lazy_reachability_index` bounded to 1 MiB, closures built on
+ *   demand while answering the queries.
+ *
+ * All answers are checked against the eager index.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <dagir/algorithms.hpp>
+#include <dagir/reachability.hpp>
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+
+#include <dagir/utility/cudd/cudd_convert_expression.hpp>
+#include <dagir/utility/cudd/cudd_read_only_dag_view.hpp>
+
+namespace {
+
+using namespace dagir::utility;
+using bench_clock = std::chrono::steady_clock;
+
+constexpr std::size_t k_max_dfs_queries = 20000;
+constexpr std::size_t k_lazy_bytes = std::size_t{1} << 20;
+
+struct workload {
+  std::string name;
+  my_expression_ptr expr;
+};
+
+double elapsed_seconds(bench_clock::time_point start) {
+  return std::chrono::duration<double>(bench_clock::now() - start).count();
+}
+
+/**
+ * @brief Answer one query with a depth-first search through the view.
+ */
+template <class View>
+bool dfs_reaches(const View& view, typename View::handle from, typename View::handle to) {
+  std::unordered_set<std::uint64_t> seen{from.stable_key()};
+  std::vector<typename View::handle> stack{from};
+  while (!stack.empty()) {
+    const auto h = stack.back();
+    stack.pop_back();
+    if (h == to) return true;
+    for (auto const& e : view.children(h)) {
+      if (seen.insert(e.target().stable_key()).second) stack.push_back(e.target());
+    }
+  }
+  return false;
+}
+
+template <class View>
+void report(const std::string& name, const View& view, std::size_t queries, std::mt19937_64& rng) {
+  using H = typename View::handle;
+  const std::vector<H> nodes = dagir::kahn_topological_order(view);
+  std::vector<std::pair<H, H>> pairs;
+  pairs.reserve(queries);
+  for (std::size_t q = 0; q < queries; ++q) {
+    pairs.emplace_back(nodes[rng() % nodes.size()], nodes[rng() % nodes.size()]);
+  }
+
+  auto start = bench_clock::now();
+  const dagir::reachability_index<View> eager(view);
+  const double build_ms = elapsed_seconds(start) * 1e3;
+
+  start = bench_clock::now();
+  std::vector<char> expected(queries);
+  for (std::size_t q = 0; q < queries; ++q) {
+    expected[q] = eager.reaches(pairs[q].first, pairs[q].second);
+  }
+  const double eager_rate = static_cast<double>(queries) / elapsed_seconds(start);
+
+  bool same = true;
+  const std::size_t dfs_count = std::min(queries, k_max_dfs_queries);
+  start = bench_clock::now();
+  for (std::size_t q = 0; q < dfs_count; ++q) {
+    same = same && dfs_reaches(view, pairs[q].first, pairs[q].second) == (expected[q] != 0);
+  }
+  const double dfs_rate = static_cast<double>(dfs_count) / elapsed_seconds(start);
+
+  start = bench_clock::now();
+  dagir::lazy_reachability_index<View> lazy(view, k_lazy_bytes);
+  for (std::size_t q = 0; q < queries; ++q) {
+    same = same && lazy.reaches(pairs[q].first, pairs[q].second) == (expected[q] != 0);
+  }
+  const double lazy_rate = static_cast<double>(queries) / elapsed_seconds(start);
+
+  std::cout << std::format(
+      "{:<32} {:>8} {:>10.3f} {:>10.1f} {:>10.2f} {:>9.2f} {:>10.2f} {:>9.2f} {:>5}\n", name,
+      nodes.size(), dfs_rate / 1e6, build_ms, eager_rate / 1e6,
+      static_cast<double>(eager.memory_bytes()) / (1 << 20), lazy_rate / 1e6,
+      static_cast<double>(lazy.memory_bytes()) / (1 << 20), same ? "yes" : "NO");
+}
+
+std::vector<workload> load_workloads(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".expr") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<workload> out;
+  for (const auto& f : files) {
+    out.push_back({f.stem().string(), read_expression_from_file(f.string())});
+  }
+  out.push_back({"generated_8_queens", parse_expression(make_n_queens_expression(8))});
+  out.push_back({"generated_10_queens", parse_expression(make_n_queens_expression(10))});
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <expressions_dir> [queries]\n";
+    return 1;
+  }
+
+  try {
+    const std::size_t queries =
+        (argc == 3) ? std::max<std::size_t>(1, std::stoull(argv[2])) : 1000000;
+    auto workloads = load_workloads(argv[1]);
+    std::mt19937_64 rng(42);
+
+    std::cout << "Rates in million queries per second; sizes in MiB.\n";
+    std::cout << std::format("{:<32} {:>8} {:>10} {:>10} {:>10} {:>9} {:>10} {:>9} {:>5}\n",
+                             "workload", "nodes", "dfs", "build_ms", "eager", "eager_mb", "lazy",
+                             "lazy_mb", "same");
+    for (const auto& w : workloads) {
+      std::unordered_map<std::string, int> var_map;
+      const expression_program program = compile_expression(*w.expr, var_map);
+      DdManager* mgr = Cudd_Init(static_cast<unsigned int>(program.variable_count), 0,
+                                 CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+      DdNode* root = convert_expression_to_cudd(*mgr, program);
+      {
+        cudd_read_only_dag_view view(mgr, nullptr, {root});
+        report(w.name, view, queries, rng);
+      }
+      Cudd_RecursiveDeref(mgr, root);
+      Cudd_Quit(mgr);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark: static variable-ordering heuristics for expression BDDs.
+ *
+ * Usage: variable_order_benchmark <expressions_dir> [repetitions]
+ *
+ * For every `*.expr` file in `expressions_dir` plus generated 8-Queens and
+ * 10-Queens constraints, computes a variable order with each
+ * `variable_order_heuristic` and builds the BDD with both TeDDy and CUDD.
+ * Reports the time spent computing the order, the BDD build time and the
+ * resulting node count. Each build uses a fresh manager; the best of
+ * `repetitions` runs is reported.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+#include <dagir/utility/expressions/variable_order.hpp>
+
+#include <dagir/utility/cudd/cudd_convert_expression.hpp>
+#include <dagir/utility/teddy/teddy_convert_expression.hpp>
+
+namespace {
+
+using namespace dagir::utility;
+using bench_clock = std::chrono::steady_clock;
+
+struct workload {
+  std::string name;
+  my_expression_ptr expr;
+};
+
+struct measurement {
+  double order_ms = std::numeric_limits<double>::max();
+  double build_ms = std::numeric_limits<double>::max();
+  long long nodes = 0;
+};
+
+constexpr variable_order_heuristic k_heuristics[] = {
+    variable_order_heuristic::first_seen, variable_order_heuristic::dfs_fanin,
+    variable_order_heuristic::weighted_interleaving, variable_order_heuristic::force};
+
+double elapsed_ms(bench_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+/**
+ * @brief Compile `expr` with variables renumbered by `heuristic`.
+ */
+expression_program ordered_program(const my_expression& expr, variable_order_heuristic heuristic,
+                                   measurement& m) {
+  const auto start = bench_clock::now();
+  auto var_map = make_ordered_var_map(expr, heuristic);
+  m.order_ms = std::min(m.order_ms, elapsed_ms(start));
+  return compile_expression(expr, var_map);
+}
+
+measurement bench_teddy(const my_expression& expr, variable_order_heuristic heuristic,
+                        int repetitions) {
+  measurement m;
+  for (int rep = 0; rep < repetitions; ++rep) {
+    const auto program = ordered_program(expr, heuristic, m);
+    const auto var_count =
+        static_cast<teddy::int32>(std::max<std::size_t>(program.variable_count, 1));
+    teddy::bdd_manager mgr(var_count, 1024);
+    const auto start = bench_clock::now();
+    auto out = convert_expression_to_teddy(mgr, program);
+    m.build_ms = std::min(m.build_ms, elapsed_ms(start));
+    m.nodes = static_cast<long long>(mgr.get_node_count(out));
+  }
+  return m;
+}
+
+measurement bench_cudd(const my_expression& expr, variable_order_heuristic heuristic,
+                       int repetitions) {
+  measurement m;
+  for (int rep = 0; rep < repetitions; ++rep) {
+    const auto program = ordered_program(expr, heuristic, m);
+    DdManager* mgr = Cudd_Init(static_cast<unsigned int>(program.variable_count), 0,
+                               CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+    const auto start = bench_clock::now();
+    DdNode* out = convert_expression_to_cudd(*mgr, program);
+    m.build_ms = std::min(m.build_ms, elapsed_ms(start));
+    m.nodes = Cudd_DagSize(out);
+    Cudd_RecursiveDeref(mgr, out);
+    Cudd_Quit(mgr);
+  }
+  return m;
+}
+
+std::vector<workload> load_workloads(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".expr") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<workload> out;
+  for (const auto& f : files) {
+    out.push_back({f.stem().string(), read_expression_from_file(f.string())});
+  }
+  for (int n : {8, 10}) {
+    out.push_back({std::format("generated_{}_queens", n),
+                   parse_expression(make_n_queens_expression(n))});
+  }
+  return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <expressions_dir> [repetitions]\n";
+    return 1;
+  }
+
+  try {
+    const int repetitions = (argc == 3) ? std::max(1, std::stoi(argv[2])) : 3;
+    auto workloads = load_workloads(argv[1]);
+
+    std::cout << std::format("{:<32} {:<6} {:<11} {:>10} {:>12} {:>12}\n", "workload", "lib",
+                             "heuristic", "nodes", "order_ms", "build_ms");
+    for (const auto& w : workloads) {
+      for (const std::string lib : {"teddy", "cudd"}) {
+        for (auto h : k_heuristics) {
+          const measurement m = (lib == "teddy") ? bench_teddy(*w.expr, h, repetitions)
+                                                 : bench_cudd(*w.expr, h, repetitions);
+          std::cout << std::format("{:<32} {:<6} {:<11} {:>10} {:>12.3f} {:>12.3f}\n", w.name,
+                                   lib, to_string(h), m.nodes, m.order_ms, m.build_ms);
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
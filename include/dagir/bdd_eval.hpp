@@ -0,0 +1,240 @@
+/**
+ * @file bdd_eval.hpp
+ * @brief Flattened node tables and batch evaluation for BDD views.
+ *
+ * @details
+ * Evaluating a BDD through its library follows one pointer per level, and
+ * every step is a dependent cache miss. `flatten_bdd` copies the diagram
+ * reachable from a `bdd_view`'s roots into a compact `bdd_table` of
+ * `(var, lo, hi)` entries in topological order, with each low child placed
+ * right after its parent where possible, so that a path mostly walks forward
+ * through contiguous memory and bottom-up passes are a single reverse sweep.
+ * The table no longer refers to the library, so it can be evaluated while
+ * the manager is busy (or after it is gone).
+ *
+ * `evaluate_bdd_batch` walks `Lanes` assignments in lockstep: each step
+ * advances every lane by one level, so up to `Lanes` independent node loads
+ * are in flight at once instead of one. Terminals are self-loops, which
+ * keeps the inner loop branch-free; a group finishes when all its lanes sit
+ * on a terminal.
+ *
+ * Assignments are row-major bit vectors: assignment `j` occupies
+ * `words_per_assignment` consecutive words, and variable `v` is bit `v % 64`
+ * of word `v / 64`. Results are packed 64 per word, bit `j` for assignment `j`.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dagir/concepts/bdd_view.hpp"
+
+namespace dagir {
+
+/**
+ * @brief Decision node of a `bdd_table`.
+ */
+struct bdd_table_node {
+  std::uint32_t var = 0;                 ///< Variable index tested by the node
+  std::array<std::uint32_t, 2> child{};  ///< Low (0) and high (1) successor
+};
+
+/**
+ * @brief Library-independent snapshot of a BDD.
+ *
+ * Entries 0 and 1 are the false and true terminals; both are self-loops on
+ * variable 0. Decision nodes follow in topological order: every child has a
+ * larger index than its parent.
+ */
+struct bdd_table {
+  static constexpr std::uint32_t k_false = 0;
+  static constexpr std::uint32_t k_true = 1;
+
+  std::vector<bdd_table_node> nodes;
+  std::vector<std::uint32_t> roots;  ///< Table index of every view root, in view order
+
+  /// Number of variables: the manager's count for an `ordered_bdd_view`,
+  /// otherwise one past the largest variable index in use.
+  std::size_t variable_count = 0;
+
+  /// `levels[i]` is the level of variable index `i`; empty means level == index.
+  std::vector<std::uint32_t> levels;
+
+  /// Number of 64-bit words needed per row-major assignment.
+  std::size_t words_per_assignment() const noexcept { return (variable_count + 63) / 64; }
+
+  /// Level of variable index `var`.
+  std::uint32_t level_of(std::uint32_t var) const noexcept {
+    return levels.empty() ? var : levels[var];
+  }
+
+  /// Level of table node `node`; terminals sit at level `variable_count`.
+  std::uint32_t node_level(std::uint32_t node) const noexcept {
+    return node <= k_true ? static_cast<std::uint32_t>(variable_count)
+                          : level_of(nodes[node].var);
+  }
+};
+
+/**
+ * @brief Copy the diagram reachable from `view.roots()` into a `bdd_table`.
+ *
+ * For an `ordered_bdd_view` the manager's variable count and order are
+ * recorded as well.
+ *
+ * @tparam View A type modeling ::dagir::concepts::bdd_view
+ * @throws std::runtime_error If a decision node does not have two children or
+ *         the diagram exceeds 2^32 nodes.
+ */
+template <dagir::concepts::bdd_view View>
+bdd_table flatten_bdd(const View& view) {
+  using H = typename View::handle;
+
+  auto extract_child = []<class E>(const E& e) -> H {
+    if constexpr (std::convertible_to<E, H>) {
+      return static_cast<H>(e);
+    } else {
+      return e.target();
+    }
+  };
+
+  // Iterative DFS emitting decision nodes in postorder. The table is the
+  // reverse postorder; expanding the high child first and the last root
+  // first places the first root, and each low child, right after its parent.
+  std::unordered_map<std::uint64_t, std::uint32_t> position;  // stable key -> postorder index
+  std::vector<H> postorder;
+  std::vector<std::pair<H, bool>> stack;  // (handle, children already pushed)
+  for (const H& root : view.roots()) stack.emplace_back(root, false);
+  while (!stack.empty()) {
+    auto [h, expanded] = stack.back();
+    stack.pop_back();
+    if (expanded) {
+      if (postorder.size() >= 0xFFFFFFFDu) throw std::runtime_error("flatten_bdd: too many nodes");
+      position[h.stable_key()] = static_cast<std::uint32_t>(postorder.size());
+      postorder.push_back(h);
+      continue;
+    }
+    if (view.is_terminal(h) || !position.try_emplace(h.stable_key(), 0).second) continue;
+
+    std::vector<H> kids;
+    for (const auto& edge_like : view.children(h)) kids.push_back(extract_child(edge_like));
+    if (kids.size() != 2) {
+      throw std::runtime_error("flatten_bdd: decision node without two children");
+    }
+    stack.emplace_back(h, true);
+    stack.emplace_back(kids[0], false);
+    stack.emplace_back(kids[1], false);
+  }
+
+  const std::size_t count = postorder.size();
+  auto lookup = [&](const H& h) -> std::uint32_t {
+    if (view.is_terminal(h)) {
+      return view.terminal_value(h) ? bdd_table::k_true : bdd_table::k_false;
+    }
+    return static_cast<std::uint32_t>(count + 1 - position.at(h.stable_key()));
+  };
+
+  bdd_table table;
+  table.nodes.resize(count + 2);
+  table.nodes[bdd_table::k_false].child = {bdd_table::k_false, bdd_table::k_false};
+  table.nodes[bdd_table::k_true].child = {bdd_table::k_true, bdd_table::k_true};
+  for (std::size_t p = 0; p < count; ++p) {
+    bdd_table_node& node = table.nodes[count + 1 - p];
+    node.var = static_cast<std::uint32_t>(view.variable_index(postorder[p]));
+    std::size_t k = 0;
+    for (const auto& edge_like : view.children(postorder[p])) {
+      node.child[k++] = lookup(extract_child(edge_like));
+    }
+    table.variable_count = std::max<std::size_t>(table.variable_count, std::size_t{node.var} + 1);
+  }
+  for (const H& root : view.roots()) table.roots.push_back(lookup(root));
+
+  if constexpr (dagir::concepts::ordered_bdd_view<View>) {
+    table.variable_count = std::max<std::size_t>(table.variable_count, view.variable_count());
+    table.levels.resize(table.variable_count);
+    for (std::size_t i = 0; i < table.variable_count; ++i) {
+      table.levels[i] = static_cast<std::uint32_t>(view.variable_level(i));
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief Evaluate one root of `table` on a single row-major assignment.
+ */
+inline bool evaluate_bdd(const bdd_table& table, std::uint32_t node,
+                         const std::uint64_t* assignment) noexcept {
+  while (node > bdd_table::k_true) {
+    const bdd_table_node& n = table.nodes[node];
+    node = n.child[(assignment[n.var / 64] >> (n.var % 64)) & 1u];
+  }
+  return node == bdd_table::k_true;
+}
+
+/**
+ * @brief Evaluate root `root` of `table` on `count` row-major assignments.
+ *
+ * @tparam Lanes Number of assignments walked in lockstep.
+ * @param table Table produced by `flatten_bdd`.
+ * @param root Index into `table.roots`.
+ * @param assignments `count * words_per_assignment` words.
+ * @param words_per_assignment Row stride; at least `table.words_per_assignment()`.
+ * @param count Number of assignments.
+ * @return `ceil(count / 64)` words; bit `j` is the value for assignment `j`.
+ * @throws std::invalid_argument If `root` or `words_per_assignment` is out of range.
+ */
+template <std::size_t Lanes = 16>
+std::vector<std::uint64_t> evaluate_bdd_batch(const bdd_table& table, std::size_t root,
+                                              const std::uint64_t* assignments,
+                                              std::size_t words_per_assignment,
+                                              std::size_t count) {
+  static_assert(Lanes != 0 && 64 % Lanes == 0, "Lanes must divide 64");
+  if (root >= table.roots.size()) throw std::invalid_argument("evaluate_bdd_batch: bad root");
+  if (words_per_assignment < table.words_per_assignment()) {
+    throw std::invalid_argument("evaluate_bdd_batch: assignments are too narrow");
+  }
+
+  std::vector<std::uint64_t> out((count + 63) / 64, 0);
+  const bdd_table_node* nodes = table.nodes.data();
+  const std::uint32_t start = table.roots[root];
+
+  for (std::size_t base = 0; base < count; base += Lanes) {
+    const std::size_t lanes = std::min(Lanes, count - base);
+    std::array<const std::uint64_t*, Lanes> row;
+    std::array<std::uint32_t, Lanes> cur;
+    for (std::size_t k = 0; k < Lanes; ++k) {
+      // Lanes past `count` sit on the false terminal and re-read the first row.
+      row[k] = assignments + (base + (k < lanes ? k : 0)) * words_per_assignment;
+      cur[k] = k < lanes ? start : bdd_table::k_false;
+    }
+
+    bool active = start > bdd_table::k_true;
+    while (active) {
+      active = false;
+      for (std::size_t k = 0; k < Lanes; ++k) {
+        const bdd_table_node& n = nodes[cur[k]];
+        cur[k] = n.child[(row[k][n.var / 64] >> (n.var % 64)) & 1u];
+        active |= cur[k] > bdd_table::k_true;
+      }
+    }
+
+    std::uint64_t bits = 0;
+    for (std::size_t k = 0; k < Lanes; ++k) {
+      bits |= std::uint64_t{cur[k] == bdd_table::k_true} << k;
+    }
+    out[base / 64] |= bits << (base % 64);
+  }
+  return out;
+}
+
+}  // namespace dagir
@@ -0,0 +1,179 @@
+/**
+ * @file big_uint.hpp
+ * @brief Unsigned integers wider than 64 bits for counting results.
+ *
+ * @details
+ * Model counts of BDDs grow as 2^n in the number of variables, so they
+ * overflow `std::uint64_t` quickly. Two types are provided, both supporting
+ * exactly what counting needs (addition, left shift, comparison and decimal
+ * formatting):
+ *
+ * - `uint128`: fixed 128-bit value; operations that overflow throw
+ *   `std::overflow_error` instead of wrapping.
+ * - `big_uint`: arbitrary precision, stored as little-endian 32-bit limbs.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dagir {
+
+/**
+ * @brief 128-bit unsigned integer with checked addition and shifts.
+ */
+struct uint128 {
+  std::uint64_t hi = 0;
+  std::uint64_t lo = 0;
+
+  constexpr uint128() noexcept = default;
+  constexpr uint128(std::uint64_t value) noexcept : lo(value) {}  // NOLINT: implicit by design
+  constexpr uint128(std::uint64_t high, std::uint64_t low) noexcept : hi(high), lo(low) {}
+
+  friend constexpr bool operator==(const uint128&, const uint128&) noexcept = default;
+  friend constexpr std::strong_ordering operator<=>(const uint128& a, const uint128& b) noexcept {
+    if (auto c = a.hi <=> b.hi; c != 0) return c;
+    return a.lo <=> b.lo;
+  }
+
+  /// @throws std::overflow_error If the sum does not fit in 128 bits.
+  friend uint128 operator+(const uint128& a, const uint128& b) {
+    uint128 r{a.hi + b.hi, a.lo + b.lo};
+    const std::uint64_t carry = r.lo < a.lo ? 1 : 0;
+    if (r.hi < a.hi || r.hi + carry < r.hi) throw std::overflow_error("uint128: addition overflow");
+    r.hi += carry;
+    return r;
+  }
+
+  /// @throws std::overflow_error If set bits would be shifted out.
+  friend uint128 operator<<(const uint128& a, std::size_t k) {
+    if (a == uint128{}) return a;
+    const std::size_t width = a.hi ? 64 + std::bit_width(a.hi) : std::bit_width(a.lo);
+    if (k + width > 128) throw std::overflow_error("uint128: shift overflow");
+    if (k == 0) return a;
+    if (k >= 64) return {a.lo << (k - 64), 0};
+    return {(a.hi << k) | (a.lo >> (64 - k)), a.lo << k};
+  }
+
+  /// Decimal representation.
+  friend std::string to_string(uint128 v) {
+    if (v.hi == 0) return std::to_string(v.lo);
+    // Peel off 19 decimal digits at a time (10^19 fits in 64 bits).
+    constexpr std::uint64_t k_chunk = 10000000000000000000ull;
+    std::string out;
+    while (v.hi != 0) {
+      // Long division of the two 64-bit halves by k_chunk, bit by bit.
+      uint128 q;
+      std::uint64_t rem = 0;
+      for (int bit = 127; bit >= 0; --bit) {
+        const std::uint64_t b = bit >= 64 ? (v.hi >> (bit - 64)) & 1u : (v.lo >> bit) & 1u;
+        const bool top = rem >> 63;
+        rem = (rem << 1) | b;
+        if (top || rem >= k_chunk) {
+          rem -= k_chunk;
+          if (bit >= 64) {
+            q.hi |= std::uint64_t{1} << (bit - 64);
+          } else {
+            q.lo |= std::uint64_t{1} << bit;
+          }
+        }
+      }
+      std::string digits = std::to_string(rem);
+      out = std::string(19 - digits.size(), '0') + digits + out;
+      v = q;
+    }
+    return std::to_string(v.lo) + out;
+  }
+};
+
+/**
+ * @brief Arbitrary-precision unsigned integer.
+ */
+class big_uint {
+ public:
+  big_uint() = default;
+  big_uint(std::uint64_t value) {  // NOLINT: implicit by design
+    while (value != 0) {
+      limbs_.push_back(static_cast<std::uint32_t>(value));
+      value >>= 32;
+    }
+  }
+
+  bool is_zero() const noexcept { return limbs_.empty(); }
+
+  friend bool operator==(const big_uint&, const big_uint&) = default;
+  friend std::strong_ordering operator<=>(const big_uint& a, const big_uint& b) {
+    if (a.limbs_.size() != b.limbs_.size()) return a.limbs_.size() <=> b.limbs_.size();
+    for (std::size_t i = a.limbs_.size(); i-- > 0;) {
+      if (a.limbs_[i] != b.limbs_[i]) return a.limbs_[i] <=> b.limbs_[i];
+    }
+    return std::strong_ordering::equal;
+  }
+
+  big_uint& operator+=(const big_uint& other) {
+    if (limbs_.size() < other.limbs_.size()) limbs_.resize(other.limbs_.size(), 0);
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < limbs_.size(); ++i) {
+      const std::uint64_t sum =
+          std::uint64_t{limbs_[i]} + (i < other.limbs_.size() ? other.limbs_[i] : 0) + carry;
+      limbs_[i] = static_cast<std::uint32_t>(sum);
+      carry = sum >> 32;
+      if (carry == 0 && i >= other.limbs_.size()) break;
+    }
+    if (carry != 0) limbs_.push_back(static_cast<std::uint32_t>(carry));
+    return *this;
+  }
+  friend big_uint operator+(big_uint a, const big_uint& b) { return a += b; }
+
+  friend big_uint operator<<(const big_uint& a, std::size_t k) {
+    if (a.is_zero()) return a;
+    big_uint r;
+    const std::size_t words = k / 32;
+    const unsigned bits = static_cast<unsigned>(k % 32);
+    r.limbs_.assign(words, 0);
+    std::uint32_t carry = 0;
+    for (std::uint32_t limb : a.limbs_) {
+      r.limbs_.push_back(bits ? (limb << bits) | carry : limb);
+      carry = bits ? limb >> (32 - bits) : 0;
+    }
+    if (carry != 0) r.limbs_.push_back(carry);
+    return r;
+  }
+
+  /// Decimal representation.
+  friend std::string to_string(const big_uint& v) {
+    if (v.is_zero()) return "0";
+    std::vector<std::uint32_t> n = v.limbs_;
+    std::vector<std::uint32_t> chunks;  // base 10^9, least significant first
+    while (!n.empty()) {
+      std::uint64_t rem = 0;
+      for (std::size_t i = n.size(); i-- > 0;) {
+        const std::uint64_t cur = (rem << 32) | n[i];
+        n[i] = static_cast<std::uint32_t>(cur / 1000000000u);
+        rem = cur % 1000000000u;
+      }
+      while (!n.empty() && n.back() == 0) n.pop_back();
+      chunks.push_back(static_cast<std::uint32_t>(rem));
+    }
+    std::string out = std::to_string(chunks.back());
+    for (std::size_t i = chunks.size() - 1; i-- > 0;) {
+      const std::string digits = std::to_string(chunks[i]);
+      out += std::string(9 - digits.size(), '0') + digits;
+    }
+    return out;
+  }
+
+ private:
+  std::vector<std::uint32_t> limbs_;  // little-endian, no leading zero limbs
+};
+
+}  // namespace dagir
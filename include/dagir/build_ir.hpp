@@ -23,8 +23,11 @@
 #include <dagir/ir_attrs.hpp>
 #include <format>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <ranges>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -79,6 +82,84 @@ static H build_ir_extract_child(const E& e) {
   }
 }
 
+namespace build_ir_detail {
+
+/**
+ * @brief Attribute `h` with `node_policy` and fill in the default name and label.
+ *
+ * `idx` is the position of the node in the IR and numbers the default name.
+ */
+template <class View, class NodePolicy>
+ir_node make_node(const View& view, NodePolicy& node_policy, const typename View::handle& h,
+                  std::size_t idx) {
+  using H = typename View::handle;
+  const std::uint64_t k = h.stable_key();
+
+  // Optionally guard traversal for this node
+  if constexpr (requires(const View& v, H hh) { v.start_guard(hh); }) {
+    auto guard = view.start_guard(h);
+    (void)guard;
+  }
+
+  ir_node n;
+  n.id = k;
+
+  // Default canonical name assigned in topological order; policies must
+  // be node-attributors producing `dagir::ir_attr_map` that will populate
+  // `n.attributes`. We prefer attribute-provided values; otherwise the
+  // default name is used and a label from the stable key is written.
+  auto attributes = std::invoke(node_policy, view, h);
+
+  // Copy the returned attributes into the node. Note the type may not be directly compatible.
+  for (const auto& [attr_key, attr_value] : attributes) {
+    n.attributes[attr_key] = attr_value;
+  }
+
+  if (!n.attributes.count(ir_attrs::k_name))
+    n.attributes[ir_attrs::k_name] = std::format("node{:03}", idx);
+  if (!n.attributes.count(ir_attrs::k_label)) n.attributes[ir_attrs::k_label] = std::to_string(k);
+  return n;
+}
+
+/**
+ * @brief Invoke `edge_attr` with the first supported signature (see `build_ir`).
+ */
+template <class EdgePolicy, class View, class H, class E>
+ir_attr_map edge_attributes(EdgePolicy& edge_attr, const View& view, const H& parent,
+                            const E& edge_like, const H& child) {
+  if constexpr (std::invocable<EdgePolicy, const View&, const H&, const E&>) {
+    return std::invoke(edge_attr, view, parent, edge_like);
+  } else if constexpr (std::invocable<EdgePolicy, const View&, const H&, const H&>) {
+    return std::invoke(edge_attr, view, parent, child);
+  } else if constexpr (std::invocable<EdgePolicy, const H&, const E&>) {
+    return std::invoke(edge_attr, parent, edge_like);
+  } else if constexpr (std::invocable<EdgePolicy, const H&, const H&>) {
+    return std::invoke(edge_attr, parent, child);
+  } else {
+    return {};
+  }
+}
+
+/// Node policy of the convenience overloads: the stable key as label.
+struct default_node_attributor {
+  template <class View, class H>
+  dagir::ir_attr_map operator()(const View& /*view*/, const H& h) const {
+    dagir::ir_attr_map m;
+    m.emplace(ir_attrs::k_label, std::format("{}", h.stable_key()));
+    return m;
+  }
+};
+
+/// Edge policy of the convenience overloads: no attributes.
+struct default_edge_attributor {
+  template <class... Args>
+  dagir::ir_attr_map operator()(Args&&...) const {
+    return {};
+  }
+};
+
+}  // namespace build_ir_detail
+
 /**
  * @brief Construct an `ir_graph` from a read-only DAG view.
  *
@@ -121,34 +202,7 @@ ir_graph build_ir(const View& view, NodePolicy&& node_policy, EdgePolicy&& edge_
 
   // First, create nodes (memoized) using label policy
   for (std::size_t idx = 0; idx < topo.size(); ++idx) {
-    const H& h = topo[idx];
-    key_t k = h.stable_key();
-
-    // Optionally guard traversal for this node
-    if constexpr (requires(const View& v, H hh) { v.start_guard(hh); }) {
-      auto guard = view.start_guard(h);
-      (void)guard;
-    }
-
-    ir_node n;
-    n.id = k;
-
-    // Default canonical name assigned in topological order; policies must
-    // be node-attributors producing `dagir::ir_attr_map` that will populate
-    // `n.attributes`. We prefer attribute-provided values; otherwise the
-    // default name is used and a label from the stable key is written.
-    auto attributes = std::invoke(node_policy, view, h);
-
-    // Copy the returned attributes into the node. Note the type may not be directly compatible.
-    for (const auto& [attr_key, attr_value] : attributes) {
-      n.attributes[attr_key] = attr_value;
-    }
-
-    if (!n.attributes.count(ir_attrs::k_name))
-      n.attributes[ir_attrs::k_name] = std::format("node{:03}", idx);
-    if (!n.attributes.count(ir_attrs::k_label)) n.attributes[ir_attrs::k_label] = std::to_string(k);
-
-    graph.nodes.push_back(std::move(n));
+    graph.nodes.push_back(build_ir_detail::make_node(view, node_policy, topo[idx], idx));
   }
 
   // Now collect edges; reserve approximate size by summing child counts
@@ -172,21 +226,201 @@ ir_graph build_ir(const View& view, NodePolicy&& node_policy, EdgePolicy&& edge_
       ie.target = ck;
 
       // Determine attributes via flexible invocation forms
-      if constexpr (std::invocable<EdgePolicy, const View&, const H&, const decltype(edge_like)&>) {
-        ie.attributes = std::invoke(edge_attr, view, parent, edge_like);
-      } else if constexpr (std::invocable<EdgePolicy, const View&, const H&, const H&>) {
-        ie.attributes = std::invoke(edge_attr, view, parent, child);
-      } else if constexpr (std::invocable<EdgePolicy, const H&, const decltype(edge_like)&>) {
-        ie.attributes = std::invoke(edge_attr, parent, edge_like);
-      } else if constexpr (std::invocable<EdgePolicy, const H&, const H&>) {
-        ie.attributes = std::invoke(edge_attr, parent, child);
-      } else {
-        ie.attributes = {};
+      ie.attributes = build_ir_detail::edge_attributes(edge_attr, view, parent, edge_like, child);
+
+      graph.edges.push_back(std::move(ie));
+    }
+  }
+
+  return graph;
+}
+
+/**
+ * @brief Limits for a budgeted `build_ir`.
+ *
+ * Nodes are admitted breadth-first from the roots until the IR holds
+ * `max_nodes` of them; nodes more than `max_depth` edges below every root are
+ * never admitted. Only admitted nodes are attributed and expanded, so the
+ * cost is bounded by the budget and not by the size of the view.
+ *
+ * The children left out below an admitted node are replaced by one synthetic
+ * summary node (see `ir_attrs::k_summary`) carrying the number of hidden
+ * nodes and the depth of the hidden region. Sizing the hidden regions is a
+ * breadth-first probe sharing `summary_probe` node expansions across all
+ * summaries (in topological order of their parents); once it is spent the
+ * remaining counts are lower bounds and marked `partial`.
+ */
+struct build_ir_options {
+  static constexpr std::size_t k_unlimited = std::numeric_limits<std::size_t>::max();
+
+  std::size_t max_nodes = k_unlimited;  ///< View nodes admitted into the IR
+  std::size_t max_depth = k_unlimited;  ///< Edges between a root and an admitted node
+  std::size_t summary_probe = 4096;     ///< Node expansions spent sizing hidden regions
+
+  /// True if neither limit is set.
+  bool unlimited() const noexcept { return max_nodes == k_unlimited && max_depth == k_unlimited; }
+};
+
+/**
+ * @brief Construct an `ir_graph` of at most `options.max_nodes` view nodes.
+ *
+ * Policies are as for the unbudgeted overload, which this delegates to when
+ * no limit is set. Admitted nodes are emitted in topological order, followed
+ * by the summary nodes; summaries are named `summaryNNN`, drawn as dashed
+ * boxes and reached by a dashed edge from the node they summarize. Roots left
+ * out by a budget smaller than the number of roots share one summary without
+ * a parent. Summary ids never collide with the ids of admitted nodes.
+ *
+ * @throws std::runtime_error if a cycle is detected among the admitted nodes.
+ */
+template <dagir::concepts::read_only_dag_view View, class NodePolicy, class EdgePolicy>
+  requires dagir::concepts::node_attributor<NodePolicy, View>
+ir_graph build_ir(const View& view, NodePolicy&& node_policy, EdgePolicy&& edge_attr,
+                  const build_ir_options& options) {
+  if (options.unlimited()) return build_ir(view, node_policy, edge_attr);
+
+  using H = typename View::handle;
+  using key_t = std::uint64_t;
+  constexpr std::size_t k_hidden = build_ir_options::k_unlimited;
+
+  // Breadth-first discovery, admitting nodes while the budget lasts. Per
+  // admitted node we record, for every child edge, the admitted child index
+  // or `k_hidden`, and the children that were left out.
+  std::vector<H> nodes;
+  std::vector<std::size_t> depth;
+  std::unordered_map<key_t, std::size_t> index;
+  std::vector<std::vector<std::size_t>> kids;
+  std::vector<std::vector<H>> hidden;
+  std::vector<H> hidden_roots;
+
+  auto admit = [&](const H& h, std::size_t d) -> std::size_t {
+    if (auto it = index.find(h.stable_key()); it != index.end()) return it->second;
+    if (nodes.size() >= options.max_nodes || d > options.max_depth) return k_hidden;
+    index.emplace(h.stable_key(), nodes.size());
+    nodes.push_back(h);
+    depth.push_back(d);
+    return nodes.size() - 1;
+  };
+
+  for (auto const& r : view.roots()) {
+    const H h = r;
+    if (admit(h, 0) == k_hidden) hidden_roots.push_back(h);
+  }
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    const H parent = nodes[i];
+    std::vector<std::size_t> targets;
+    std::vector<H> left_out;
+    for (auto const& edge_like : view.children(parent)) {
+      const H child = build_ir_extract_child<H>(edge_like);
+      const std::size_t j = admit(child, depth[i] + 1);
+      targets.push_back(j);
+      if (j == k_hidden) left_out.push_back(child);
+    }
+    kids.push_back(std::move(targets));
+    hidden.push_back(std::move(left_out));
+  }
+
+  // Kahn's algorithm over the admitted subgraph.
+  std::vector<std::size_t> indeg(nodes.size(), 0);
+  for (const auto& targets : kids) {
+    for (std::size_t j : targets) {
+      if (j != k_hidden) ++indeg[j];
+    }
+  }
+  std::vector<std::size_t> order;
+  order.reserve(nodes.size());
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    if (indeg[i] == 0) order.push_back(i);
+  }
+  for (std::size_t q = 0; q < order.size(); ++q) {
+    for (std::size_t j : kids[order[q]]) {
+      if (j != k_hidden && --indeg[j] == 0) order.push_back(j);
+    }
+  }
+  if (order.size() != nodes.size()) {
+    throw std::runtime_error("build_ir: cycle detected in reachable graph");
+  }
+
+  ir_graph graph;
+  graph.nodes.reserve(nodes.size());
+  for (std::size_t idx = 0; idx < order.size(); ++idx) {
+    graph.nodes.push_back(build_ir_detail::make_node(view, node_policy, nodes[order[idx]], idx));
+  }
+
+  std::unordered_set<key_t> used_ids;
+  for (const H& h : nodes) used_ids.insert(h.stable_key());
+  std::size_t probe_left = options.summary_probe;
+  std::size_t summary_count = 0;
+
+  // Summary node for the hidden region below `seeds`, sized by a bounded
+  // breadth-first probe that never enters admitted nodes.
+  auto summarize = [&](std::span<const H> seeds, key_t anchor) -> ir_node {
+    std::unordered_set<key_t> seen;
+    std::vector<H> level;
+    for (const H& s : seeds) {
+      if (seen.insert(s.stable_key()).second) level.push_back(s);
+    }
+    std::size_t levels = 0;
+    bool exact = true;
+    while (exact && !level.empty()) {
+      ++levels;
+      std::vector<H> next;
+      for (const H& h : level) {
+        if (probe_left == 0) {
+          exact = false;
+          break;
+        }
+        --probe_left;
+        for (auto const& edge_like : view.children(h)) {
+          const H c = build_ir_extract_child<H>(edge_like);
+          const key_t k = c.stable_key();
+          if (!index.contains(k) && seen.insert(k).second) next.push_back(c);
+        }
       }
+      level = std::move(next);
+    }
 
+    ir_node n;
+    n.id = anchor ^ 0x9e3779b97f4a7c15ULL;
+    while (!used_ids.insert(n.id).second) ++n.id;
+    const std::string_view plus = exact ? "" : "+";
+    n.attributes[ir_attrs::k_name] = std::format("summary{:03}", summary_count++);
+    n.attributes[ir_attrs::k_label] =
+        std::format("{}{} hidden, depth {}{}", seen.size(), plus, levels, plus);
+    n.attributes[ir_attrs::k_summary] = exact ? "exact" : "partial";
+    n.attributes[ir_attrs::k_hidden_nodes] = std::to_string(seen.size());
+    n.attributes[ir_attrs::k_hidden_depth] = std::to_string(levels);
+    n.attributes[ir_attrs::k_shape] = "box";
+    n.attributes[ir_attrs::k_style] = "dashed";
+    return n;
+  };
+
+  for (std::size_t i : order) {
+    const H& parent = nodes[i];
+    const key_t pk = parent.stable_key();
+    std::size_t e = 0;
+    for (auto const& edge_like : view.children(parent)) {
+      const std::size_t j = kids[i][e++];
+      if (j == k_hidden) continue;
+      ir_edge ie;
+      ie.source = pk;
+      ie.target = nodes[j].stable_key();
+      ie.attributes =
+          build_ir_detail::edge_attributes(edge_attr, view, parent, edge_like, nodes[j]);
+      graph.edges.push_back(std::move(ie));
+    }
+    if (!hidden[i].empty()) {
+      graph.nodes.push_back(summarize(hidden[i], pk));
+      ir_edge ie;
+      ie.source = pk;
+      ie.target = graph.nodes.back().id;
+      ie.attributes[ir_attrs::k_style] = "dashed";
       graph.edges.push_back(std::move(ie));
     }
   }
+  if (!hidden_roots.empty()) {
+    graph.nodes.push_back(summarize(hidden_roots, hidden_roots.front().stable_key()));
+  }
 
   return graph;
 }
@@ -199,13 +433,17 @@ ir_graph build_ir(const View& view, NodePolicy&& node_policy, EdgePolicy&& edge_
  */
 template <dagir::concepts::read_only_dag_view View>
 ir_graph build_ir(const View& view) {
-  auto node_attr = [](auto const& /*view*/, auto const& h) -> dagir::ir_attr_map {
-    dagir::ir_attr_map m;
-    m.emplace(ir_attrs::k_label, std::format("{}", h.stable_key()));
-    return m;
-  };
-  auto edge_attr = [](auto&&...) -> dagir::ir_attr_map { return {}; };
-  return build_ir(view, node_attr, edge_attr);
+  return build_ir(view, build_ir_detail::default_node_attributor{},
+                  build_ir_detail::default_edge_attributor{});
+}
+
+/**
+ * @brief Budgeted `build_ir` using the default policies.
+ */
+template <dagir::concepts::read_only_dag_view View>
+ir_graph build_ir(const View& view, const build_ir_options& options) {
+  return build_ir(view, build_ir_detail::default_node_attributor{},
+                  build_ir_detail::default_edge_attributor{}, options);
 }
 
 }  // namespace dagir
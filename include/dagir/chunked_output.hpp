@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief Parallel formatting of element lines with in-order output.
+ *
+ * The text renderers write one line (or array entry) per node and per edge,
+ * and each one depends only on the graph and on indexes built before the
+ * loop. `write_chunked` formats consecutive elements in chunks of
+ * `k_render_chunk` on up to `threads` workers, each chunk into its own
+ * buffer, and writes the buffers to the stream in element order. The output
+ * is byte-identical to the serial loop for every thread count.
+ *
+ * The workers are started once per call and take chunks in order; the
+ * calling thread writes each chunk as soon as it and all earlier chunks are
+ * done. A worker waits before starting a chunk more than a few chunks per
+ * worker ahead of the writer, so the buffered output stays bounded. Workers
+ * only format; all writes to the stream happen on the calling thread.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <dagir/parallel.hpp>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dagir {
+
+/// Elements formatted per chunk by one worker.
+inline constexpr std::size_t k_render_chunk = 4096;
+
+namespace chunked_output_detail {
+
+/// Chunks per worker that may be formatted ahead of the writer.
+inline constexpr std::size_t k_chunks_per_worker = 4;
+
+}  // namespace chunked_output_detail
+
+/**
+ * @brief Write `format(out, i)` for every `i < count` to `os`, in order of `i`.
+ *
+ * With `threads > 1` and more than one chunk of elements, `format` is
+ * called concurrently on streams that copy the formatting state of `os`,
+ * so it must only read shared state. Exceptions thrown by `format` are
+ * rethrown on the calling thread; the output is then incomplete.
+ *
+ * @param os Stream receiving the text.
+ * @param count Number of elements.
+ * @param threads Worker threads (1 = format directly into `os`).
+ * @param format Callable as `format(std::ostream&, std::size_t)`.
+ */
+template <class Format>
+void write_chunked(std::ostream& os, std::size_t count, unsigned threads, Format&& format) {
+  const std::size_t chunks = (count + k_render_chunk - 1) / k_render_chunk;
+  const std::size_t workers = std::min<std::size_t>(threads, chunks);
+  if (workers <= 1) {
+    for (std::size_t i = 0; i < count; ++i) format(os, i);
+    return;
+  }
+
+  // Chunk c is formatted into slot c % window once chunk c - window is written.
+  const std::size_t window = workers * chunked_output_detail::k_chunks_per_worker;
+  std::vector<std::string> slots(window);
+  std::vector<char> ready(window, 0);
+  std::size_t claimed = 0;  // chunks handed to workers
+  std::size_t written = 0;  // chunks written to `os`
+  bool failed = false;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::ostringstream prototype;
+  prototype.copyfmt(os);
+
+  auto fail = [&] {
+    std::lock_guard lock(mutex);
+    failed = true;
+    changed.notify_all();
+  };
+
+  // Worker 0 is the calling thread and writes; the others format.
+  parallel_detail::run_workers(workers + 1, [&](std::size_t w) {
+    try {
+      if (w == 0) {
+        for (std::size_t c = 0; c < chunks; ++c) {
+          std::string text;
+          {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return ready[c % window] || failed; });
+            if (failed) return;
+            text = std::move(slots[c % window]);
+            ready[c % window] = 0;
+          }
+          os.write(text.data(), static_cast<std::streamsize>(text.size()));
+          std::lock_guard lock(mutex);
+          ++written;
+          changed.notify_all();
+        }
+        return;
+      }
+      std::ostringstream out;
+      out.copyfmt(prototype);
+      for (;;) {
+        std::size_t c = 0;
+        {
+          std::unique_lock lock(mutex);
+          if (claimed == chunks || failed) return;
+          c = claimed++;
+          changed.wait(lock, [&] { return c < written + window || failed; });
+          if (failed) return;
+        }
+        const std::size_t begin = c * k_render_chunk;
+        const std::size_t end = std::min(count, begin + k_render_chunk);
+        for (std::size_t i = begin; i < end; ++i) format(static_cast<std::ostream&>(out), i);
+        std::string text = std::move(out).str();
+        out.str(std::string());
+        std::lock_guard lock(mutex);
+        slots[c % window] = std::move(text);
+        ready[c % window] = 1;
+        changed.notify_all();
+      }
+    } catch (...) {
+      fail();
+      throw;
+    }
+  });
+}
+
+}  // namespace dagir
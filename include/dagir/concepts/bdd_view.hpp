@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file
+ * @brief Concept for read-only views over binary decision diagrams.
+ *
+ * A `bdd_view` is a `read_only_dag_view` whose nodes are BDD decision nodes
+ * or Boolean terminals. Besides the graph accessors it answers three
+ * questions about a handle: whether it is a terminal, the value of a
+ * terminal, and the variable index tested by a decision node. For decision
+ * nodes `children(h)` yields exactly two edges, the low (variable = 0)
+ * child first and the high (variable = 1) child second. Complement edges, if
+ * the underlying library has them, must already be resolved by the view.
+ *
+ * An `ordered_bdd_view` additionally reports the manager's variable count
+ * and the level (position in the current variable order) of every variable,
+ * which algorithms need to account for levels skipped between a node and
+ * its children.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <dagir/concepts/read_only_dag_view.hpp>
+
+namespace dagir::concepts {
+
+/**
+ * @concept bdd_view
+ * @tparam G Candidate view type.
+ * @brief True if `G` is a read-only DAG view exposing BDD node semantics.
+ *
+ * Requirements:
+ *  - `G` models `read_only_dag_view`.
+ *  - `g.is_terminal(h)` is true for terminal handles.
+ *  - `g.terminal_value(h)` is the Boolean value of a terminal handle.
+ *  - `g.variable_index(h)` is the variable index of a decision node.
+ */
+template <class G>
+concept bdd_view = read_only_dag_view<G> && requires(const G& g, typename G::handle h) {
+  { g.is_terminal(h) } -> std::convertible_to<bool>;
+  { g.terminal_value(h) } -> std::convertible_to<bool>;
+  { g.variable_index(h) } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @concept ordered_bdd_view
+ * @tparam G Candidate view type.
+ * @brief True if `G` is a `bdd_view` that also exposes the variable order.
+ *
+ * Requirements:
+ *  - `G` models `bdd_view`.
+ *  - `g.variable_count()` is the number of variables of the manager.
+ *  - `g.variable_level(i)` is the level of variable index `i`, in
+ *    `[0, variable_count())`; level 0 is tested first.
+ */
+template <class G>
+concept ordered_bdd_view = bdd_view<G> && requires(const G& g, std::size_t index) {
+  { g.variable_count() } -> std::convertible_to<std::size_t>;
+  { g.variable_level(index) } -> std::convertible_to<std::size_t>;
+};
+
+}  // namespace dagir::concepts
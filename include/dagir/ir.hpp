@@ -13,6 +13,7 @@
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "dagir/ir_attrs.hpp"
@@ -134,6 +135,32 @@ struct ir_graph {
   [[maybe_unused]] ir_attr_map global_attrs;
 };
 
+/**
+ * @brief An `ir_graph` that owns the attribute keys it uses.
+ *
+ * `ir_attr_map` keys are views, normally of the `dagir::ir_attrs` constants.
+ * Graphs read back from a file carry keys that only exist in the input;
+ * `intern` copies such a key into storage owned by the document, so the
+ * views in `graph` stay valid for the lifetime of the document, including
+ * across moves. Copying is disabled since the copy would view the original.
+ */
+class ir_document {
+ public:
+  ir_document() = default;
+  ir_document(const ir_document&) = delete;
+  ir_document& operator=(const ir_document&) = delete;
+  ir_document(ir_document&&) = default;
+  ir_document& operator=(ir_document&&) = default;
+
+  /// A view of `key` that lives as long as this document.
+  std::string_view intern(std::string_view key) { return *keys_.emplace(key).first; }
+
+  ir_graph graph;  ///< The graph; its attribute keys view `dagir::ir_attrs` or `intern` storage.
+
+ private:
+  std::unordered_set<std::string> keys_;
+};
+
 // Touch pointer-to-members for fields that may be unused in some TUs.
 // This provides a compile-time usage pattern that satisfies static
 // analyzers without impacting runtime behaviour.
@@ -185,6 +185,42 @@ inline constexpr std::string_view k_name{"name"};
  */
 inline constexpr std::string_view k_group{"group"};
 
+/**
+ * @brief Layer hint for layered layouts.
+ *
+ * Interpretation: decimal layer index, 0 at the top (for BDDs, the level of
+ * the tested variable). `layered_layout` places a node at this layer or
+ * lower; renderers that compute their own layout may ignore it.
+ */
+inline constexpr std::string_view k_level{"level"};
+
+/**
+ * @brief Marks a synthetic node summarizing a truncated region.
+ *
+ * Interpretation: present only on nodes inserted by a budgeted `build_ir`
+ * in place of nodes beyond its node or depth limit. The value is `exact` when
+ * the hidden counts below are exact and `partial` when they are lower bounds.
+ * Backends may style such nodes specially; otherwise they render as ordinary
+ * nodes.
+ */
+inline constexpr std::string_view k_summary{"summary"};
+
+/**
+ * @brief Number of distinct nodes hidden behind a summary node.
+ *
+ * Interpretation: decimal count; a lower bound when `k_summary` is `partial`.
+ */
+inline constexpr std::string_view k_hidden_nodes{"hidden_nodes"};
+
+/**
+ * @brief Depth of the region hidden behind a summary node.
+ *
+ * Interpretation: decimal number of breadth-first levels below the summarized
+ * parent (direct hidden children are level 1); a lower bound when
+ * `k_summary` is `partial`.
+ */
+inline constexpr std::string_view k_hidden_depth{"hidden_depth"};
+
 // Graph-level keys
 /**
  * @brief Graph-level human-readable label.
@@ -0,0 +1,129 @@
+/**
+ * @file ir_compact.hpp
+ * @brief Helpers shared by the renderers for compact output.
+ *
+ * @details
+ * On multi-million-node graphs most elements repeat the same few attribute
+ * values (`shape`, `style`, `fillcolor`, ...), and output size drives disk
+ * use, transfer and load time. `common_attributes` finds, for every key that
+ * all elements carry, its most common value; renderers write those once as
+ * defaults (DOT `node [...]` / `edge [...]`, a JSON `defaults` object) and
+ * only the differences per element. A key missing from some element is
+ * never hoisted, since that element would inherit the default.
+ *
+ * Candidate values are found with a Misra-Gries summary of
+ * `k_default_candidates` counters per key, then counted exactly in a second
+ * pass, so memory stays bounded when values are mostly unique (labels). A
+ * value held by more than 1/(k+1) of the elements is always found.
+ *
+ * `compact_id` numbers elements with short identifiers that are valid,
+ * unquoted, in DOT, Mermaid and JSON ids, and never a keyword of either.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dagir {
+
+/// (key, value) pairs of one element in output order, or sorted defaults.
+using attr_list = std::vector<std::pair<std::string_view, std::string>>;
+
+/// Counters per key of the candidate search in `common_attributes`.
+inline constexpr std::size_t k_default_candidates = 8;
+
+/**
+ * @brief Defaults worth hoisting out of `count` attribute lists.
+ *
+ * `list_of(i)` returns the (key, value) pairs of element `i`; it is called
+ * twice per element. A key qualifies only if every list carries it; its most
+ * common value is hoisted when it occurs at least twice. Ties go to the
+ * smaller value. The result is sorted, for `is_default`.
+ */
+template <class ListOf>
+attr_list common_attributes(std::size_t count, ListOf&& list_of) {
+  struct key_stats {
+    std::size_t present = 0;
+    std::unordered_map<std::string, std::size_t> candidates;
+  };
+  std::unordered_map<std::string_view, key_stats> stats;
+  for (std::size_t i = 0; i < count; ++i) {
+    for (auto& [k, v] : list_of(i)) {
+      auto& ks = stats[k];
+      ++ks.present;
+      if (auto it = ks.candidates.find(v); it != ks.candidates.end()) {
+        ++it->second;
+      } else if (ks.candidates.size() < k_default_candidates) {
+        ks.candidates.emplace(std::move(v), 1);
+      } else {
+        for (auto it = ks.candidates.begin(); it != ks.candidates.end();) {
+          it = --it->second == 0 ? ks.candidates.erase(it) : std::next(it);
+        }
+      }
+    }
+  }
+  std::erase_if(stats, [&](const auto& s) { return s.second.present != count; });
+  if (stats.empty()) return {};
+
+  // Exact counts of the candidates.
+  for (auto& [k, ks] : stats) {
+    for (auto& c : ks.candidates) c.second = 0;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    for (const auto& [k, v] : list_of(i)) {
+      auto ks = stats.find(k);
+      if (ks == stats.end()) continue;
+      auto& candidates = ks->second.candidates;
+      if (auto it = candidates.find(v); it != candidates.end()) ++it->second;
+    }
+  }
+
+  attr_list out;
+  for (const auto& [k, ks] : stats) {
+    const std::pair<const std::string, std::size_t>* best = nullptr;
+    for (const auto& c : ks.candidates) {
+      if (!best || c.second > best->second ||
+          (c.second == best->second && c.first < best->first)) {
+        best = &c;
+      }
+    }
+    if (best && best->second >= 2) out.emplace_back(k, best->first);
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+/// True if `(key, value)` is one of the sorted `defaults`.
+inline bool is_default(const attr_list& defaults, std::string_view key, std::string_view value) {
+  auto it = std::lower_bound(defaults.begin(), defaults.end(), key,
+                             [](const auto& d, std::string_view k) { return d.first < k; });
+  return it != defaults.end() && it->first == key && it->second == value;
+}
+
+/**
+ * @brief Short identifier of element `i`: `_` followed by `i` in base 62.
+ */
+inline std::string compact_id(std::size_t i) {
+  static constexpr std::string_view digits =
+      "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  std::string out;
+  do {
+    out.push_back(digits[i % digits.size()]);
+    i /= digits.size();
+  } while (i != 0);
+  out.push_back('_');
+  std::reverse(out.begin(), out.end());
+  return out;
+}
+
+}  // namespace dagir
@@ -0,0 +1,503 @@
+/**
+ * @file layout.hpp
+ * @brief Layered (Sugiyama-style) layout of an `ir_graph`.
+ *
+ * @details
+ * `layered_layout` positions the nodes of an `ir_graph` without an external
+ * tool, in time close to linear in the size of the graph:
+ *
+ * 1. Layering. A node's layer is its `ir_attrs::k_level` attribute when it
+ *    has one (see `bdd_level_attributor`, which writes BDD levels), raised
+ *    where needed so that every edge points to a deeper layer; nodes without
+ *    a level get the longest-path layer.
+ * 2. Crossing reduction. Alternating downward and upward barycenter sweeps;
+ *    a node's key is the mean relative position of its neighbours in the
+ *    layers already fixed by the sweep. The ordering with the fewest
+ *    crossings between adjacent layers is kept. `layout_options::restarts`
+ *    adds runs from randomly shuffled layers, and `layout_options::threads`
+ *    runs them concurrently and splits large layers and the crossing counts
+ *    among workers. Ties between runs go to the lowest run, and chunks of a
+ *    layer are merged by the same total order a serial sort uses, so the
+ *    layout depends on the seed but never on the thread count.
+ * 3. Coordinate assignment. Alternating passes move every node towards the
+ *    mean x of its neighbours, keeping the layer order and the minimum gap.
+ *
+ * Long edges are not split into dummy nodes: they take part in the sweeps
+ * through their endpoints and are drawn as straight lines. This keeps the
+ * cost at O((V log V + E) * sweeps) for BDDs whose terminal edges span many
+ * levels, at the price of occasional edges crossing unrelated nodes.
+ * `crossings` therefore only counts crossings among edges between adjacent
+ * layers. The layout is top to bottom; sizes are in SVG user units.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dagir/concepts/bdd_view.hpp"
+#include "dagir/ir.hpp"
+#include "dagir/ir_attrs.hpp"
+#include "dagir/parallel.hpp"
+
+namespace dagir {
+
+/**
+ * @brief Node policy adaptor adding the BDD level of every node as `k_level`.
+ *
+ * Terminals are placed one level below the last variable. Wrap the node
+ * policy only for layouts; other renderers would emit the extra attribute.
+ */
+template <class NodePolicy>
+struct bdd_level_attributor {
+  NodePolicy inner;
+
+  template <dagir::concepts::ordered_bdd_view View>
+  ir_attr_map operator()(const View& view, const typename View::handle& h) const {
+    ir_attr_map out;
+    for (const auto& [key, value] : std::invoke(inner, view, h)) out[key] = value;
+    const std::size_t level = view.is_terminal(h) ? view.variable_count()
+                                                  : view.variable_level(view.variable_index(h));
+    out[ir_attrs::k_level] = std::to_string(level);
+    return out;
+  }
+};
+
+template <class NodePolicy>
+bdd_level_attributor(NodePolicy) -> bdd_level_attributor<NodePolicy>;
+
+/**
+ * @brief Sizes and effort limits of `layered_layout`.
+ */
+struct layout_options {
+  double node_height = 36.0;     ///< Height of every node
+  double min_node_width = 36.0;  ///< Width of nodes with short labels
+  double char_width = 7.0;       ///< Estimated width of one label character
+  double node_padding = 16.0;    ///< Horizontal padding around a label
+  double node_spacing = 20.0;    ///< Minimum gap between neighbours in a layer
+  double layer_spacing = 72.0;   ///< Distance between the centers of two layers
+  double margin = 16.0;          ///< Space around the drawing
+  std::size_t sweeps = 12;       ///< Crossing-reduction sweeps (each down or up)
+  std::size_t coordinate_passes = 4;
+  unsigned threads = 1;        ///< Worker threads for crossing reduction
+  std::size_t restarts = 0;    ///< Extra crossing-reduction runs from shuffled layers
+  std::uint64_t seed = 1;      ///< Seed of the shuffles of the restarts
+};
+
+/**
+ * @brief Positions computed by `layered_layout`; nodes are indices into `ir.nodes`.
+ */
+struct graph_layout {
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::vector<std::size_t> layer;                ///< Layer of every node
+  std::vector<std::size_t> position;             ///< Position of every node in its layer
+  std::vector<std::vector<std::size_t>> layers;  ///< Nodes of every layer, left to right
+  /// Endpoints of every edge of `ir.edges`; `npos` for unknown ids.
+  std::vector<std::pair<std::size_t, std::size_t>> edges;
+  std::vector<double> x;       ///< Center of every node
+  std::vector<double> y;       ///< Center of every node
+  std::vector<double> width;   ///< Width of every node
+  std::vector<double> height;  ///< Height of every node
+  double canvas_width = 0.0;
+  double canvas_height = 0.0;
+  std::size_t crossings = 0;  ///< Crossings between edges joining adjacent layers
+};
+
+namespace layout_detail {
+
+inline constexpr std::size_t npos = graph_layout::npos;
+
+/// Number of UTF-8 code points in `s`.
+inline std::size_t display_length(const std::string& s) {
+  return static_cast<std::size_t>(std::count_if(
+      s.begin(), s.end(), [](char c) { return (static_cast<unsigned char>(c) & 0xC0) != 0x80; }));
+}
+
+/// Value of a decimal attribute, or `npos` if absent or malformed.
+inline std::size_t numeric_attribute(const ir_node& n, std::string_view key) {
+  auto it = n.attributes.find(key);
+  if (it == n.attributes.end()) return npos;
+  std::size_t value = 0;
+  const char* first = it->second.data();
+  const char* last = first + it->second.size();
+  auto [ptr, ec] = std::from_chars(first, last, value);
+  return (ec == std::errc{} && ptr == last) ? value : npos;
+}
+
+/// Layers grow parallel only from this many nodes (or edges) per worker.
+inline constexpr std::size_t k_parallel_grain = 4096;
+
+/// Order of the nodes within every layer.
+struct layer_order {
+  std::vector<std::vector<std::size_t>> layers;
+  std::vector<std::size_t> position;
+
+  void renumber(std::size_t r) {
+    for (std::size_t i = 0; i < layers[r].size(); ++i) position[layers[r][i]] = i;
+  }
+};
+
+/**
+ * @brief Crossings among the edges between layers `r` and `r + 1`, for all `r`.
+ *
+ * Per layer pair the edges are sorted by source position and the inversions
+ * of their target positions are counted with a Fenwick tree. Layer pairs are
+ * distributed over up to `threads` workers for large graphs.
+ */
+inline std::size_t count_crossings(const std::vector<std::size_t>& layer_of,
+                                   const layer_order& order,
+                                   const std::vector<std::vector<std::size_t>>& down,
+                                   unsigned threads = 1) {
+  const std::size_t gaps = order.layers.empty() ? 0 : order.layers.size() - 1;
+  const std::size_t workers =
+      std::min<std::size_t>({threads, gaps, layer_of.size() / k_parallel_grain + 1});
+  std::vector<std::size_t> partial(std::max<std::size_t>(workers, 1), 0);
+  parallel_detail::run_workers(workers, [&](std::size_t w) {
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    std::vector<std::size_t> tree;
+    for (std::size_t r = w; r < gaps; r += workers) {
+      pairs.clear();
+      for (std::size_t u : order.layers[r]) {
+        for (std::size_t v : down[u]) {
+          if (layer_of[v] == r + 1) pairs.emplace_back(order.position[u], order.position[v]);
+        }
+      }
+      std::sort(pairs.begin(), pairs.end());
+      const std::size_t width = order.layers[r + 1].size();
+      tree.assign(width + 1, 0);
+      std::size_t seen = 0;
+      for (const auto& [pu, pv] : pairs) {
+        // Earlier edges with a target position <= pv do not cross this one.
+        std::size_t not_crossing = 0;
+        for (std::size_t i = pv + 1; i > 0; i -= i & (~i + 1)) not_crossing += tree[i];
+        partial[w] += seen - not_crossing;
+        for (std::size_t i = pv + 1; i <= width; i += i & (~i + 1)) ++tree[i];
+        ++seen;
+      }
+    }
+  });
+  std::size_t total = 0;
+  for (std::size_t c : partial) total += c;
+  return total;
+}
+
+/**
+ * @brief Reorder layer `r` by the barycenters of its neighbours in `side`.
+ *
+ * Only neighbours in layer `adjacent` count when there are any, as in the
+ * classical method; otherwise all neighbours in `side` count, by their
+ * relative position in their own layers. Nodes without neighbours keep their
+ * relative position. Keys are (barycenter, current position), a total order,
+ * so sorting chunks of a large layer on separate workers and merging them
+ * gives the same order as one serial sort.
+ */
+inline void reorder_layer(const std::vector<std::size_t>& layer_of, layer_order& order,
+                          std::size_t r, std::size_t adjacent,
+                          const std::vector<std::vector<std::size_t>>& side, unsigned threads,
+                          std::vector<std::pair<double, std::size_t>>& keyed) {
+  std::vector<std::size_t>& layer = order.layers[r];
+  const std::size_t m = layer.size();
+  keyed.resize(m);
+  const std::size_t workers = std::clamp<std::size_t>(m / k_parallel_grain, 1, threads);
+  parallel_detail::run_workers(workers, [&](std::size_t w) {
+    const std::size_t begin = m * w / workers;
+    const std::size_t end = m * (w + 1) / workers;
+    for (std::size_t i = begin; i < end; ++i) {
+      const std::size_t v = layer[i];
+      double key = (static_cast<double>(i) + 0.5) / static_cast<double>(m);
+      double near_sum = 0.0;
+      double far_sum = 0.0;
+      std::size_t near = 0;
+      for (std::size_t n : side[v]) {
+        const double relative = (static_cast<double>(order.position[n]) + 0.5) /
+                                static_cast<double>(order.layers[layer_of[n]].size());
+        if (layer_of[n] == adjacent) {
+          near_sum += relative;
+          ++near;
+        } else {
+          far_sum += relative;
+        }
+      }
+      if (near > 0) {
+        key = near_sum / static_cast<double>(near);
+      } else if (!side[v].empty()) {
+        key = far_sum / static_cast<double>(side[v].size());
+      }
+      keyed[i] = {key, i};
+    }
+    std::sort(keyed.begin() + static_cast<std::ptrdiff_t>(begin),
+              keyed.begin() + static_cast<std::ptrdiff_t>(end));
+  });
+  // Merge the sorted chunks pairwise.
+  for (std::size_t width = 1; width < workers; width *= 2) {
+    for (std::size_t w = 0; w + width < workers; w += 2 * width) {
+      const auto first = keyed.begin() + static_cast<std::ptrdiff_t>(m * w / workers);
+      const auto middle = keyed.begin() + static_cast<std::ptrdiff_t>(m * (w + width) / workers);
+      const auto last = keyed.begin() + static_cast<std::ptrdiff_t>(
+                                            m * std::min(w + 2 * width, workers) / workers);
+      std::inplace_merge(first, middle, last);
+    }
+  }
+  std::vector<std::size_t> reordered;
+  reordered.reserve(m);
+  for (const auto& [key, pos] : keyed) reordered.push_back(layer[pos]);
+  layer = std::move(reordered);
+  order.renumber(r);
+}
+
+/**
+ * @brief Alternating barycenter sweeps; leaves `order` at the best ordering seen.
+ * @return Crossings of the returned ordering.
+ */
+inline std::size_t reduce_crossings(const std::vector<std::size_t>& layer_of, layer_order& order,
+                                    const std::vector<std::vector<std::size_t>>& up,
+                                    const std::vector<std::vector<std::size_t>>& down,
+                                    std::size_t sweeps, unsigned threads) {
+  std::vector<std::vector<std::size_t>> best_layers = order.layers;
+  std::size_t best = count_crossings(layer_of, order, down, threads);
+  std::vector<std::pair<double, std::size_t>> keyed;
+  for (std::size_t s = 0; s < sweeps && best > 0; ++s) {
+    if (s % 2 == 0) {
+      for (std::size_t r = 1; r < order.layers.size(); ++r) {
+        reorder_layer(layer_of, order, r, r - 1, up, threads, keyed);
+      }
+    } else {
+      for (std::size_t r = order.layers.size(); r-- > 1;) {
+        reorder_layer(layer_of, order, r - 1, r, down, threads, keyed);
+      }
+    }
+    const std::size_t c = count_crossings(layer_of, order, down, threads);
+    if (c < best) {
+      best = c;
+      best_layers = order.layers;
+    }
+  }
+  order.layers = std::move(best_layers);
+  for (std::size_t r = 0; r < order.layers.size(); ++r) order.renumber(r);
+  return best;
+}
+
+/**
+ * @brief Move the nodes of one layer towards `desired` without reordering them.
+ *
+ * Averages the left-most and right-most feasible placements, each obtained
+ * by clamping the desired positions in one sweep across the layer.
+ */
+inline void place_layer(graph_layout& l, std::size_t r, const std::vector<double>& desired,
+                        double gap) {
+  const std::vector<std::size_t>& layer = l.layers[r];
+  if (layer.empty()) return;
+  std::vector<double> push_right(layer.size());
+  std::vector<double> push_left(layer.size());
+  for (std::size_t i = 0; i < layer.size(); ++i) {
+    push_right[i] = desired[i];
+    if (i > 0) {
+      const double sep = (l.width[layer[i - 1]] + l.width[layer[i]]) / 2.0 + gap;
+      push_right[i] = std::max(push_right[i], push_right[i - 1] + sep);
+    }
+  }
+  for (std::size_t i = layer.size(); i-- > 0;) {
+    push_left[i] = desired[i];
+    if (i + 1 < layer.size()) {
+      const double sep = (l.width[layer[i]] + l.width[layer[i + 1]]) / 2.0 + gap;
+      push_left[i] = std::min(push_left[i], push_left[i + 1] - sep);
+    }
+  }
+  for (std::size_t i = 0; i < layer.size(); ++i) {
+    l.x[layer[i]] = (push_right[i] + push_left[i]) / 2.0;
+  }
+}
+
+}  // namespace layout_detail
+
+/**
+ * @brief Compute a layered layout of `ir`.
+ *
+ * Edges whose endpoints are not nodes of `ir`, and self-loops, are ignored by
+ * the layout (their entry in `edges` is still filled where possible).
+ *
+ * @throws std::runtime_error if the graph has a cycle.
+ */
+inline graph_layout layered_layout(const ir_graph& ir, const layout_options& options = {}) {
+  using layout_detail::npos;
+  const std::size_t n = ir.nodes.size();
+  graph_layout l;
+
+  std::unordered_map<std::uint64_t, std::size_t> index;
+  index.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) index.emplace(ir.nodes[i].id, i);
+
+  std::vector<std::vector<std::size_t>> down(n);
+  std::vector<std::vector<std::size_t>> up(n);
+  l.edges.reserve(ir.edges.size());
+  for (const ir_edge& e : ir.edges) {
+    auto s = index.find(e.source);
+    auto t = index.find(e.target);
+    const std::size_t u = s == index.end() ? npos : s->second;
+    const std::size_t v = t == index.end() ? npos : t->second;
+    l.edges.emplace_back(u, v);
+    if (u == npos || v == npos || u == v) continue;
+    down[u].push_back(v);
+    up[v].push_back(u);
+  }
+
+  // Layering: Kahn's algorithm, each node at least one layer below its parents.
+  l.layer.assign(n, 0);
+  std::vector<std::size_t> indeg(n);
+  std::vector<std::size_t> order;
+  order.reserve(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    indeg[v] = up[v].size();
+    const std::size_t level = layout_detail::numeric_attribute(ir.nodes[v], ir_attrs::k_level);
+    if (level != npos) l.layer[v] = level;
+    if (indeg[v] == 0) order.push_back(v);
+  }
+  for (std::size_t q = 0; q < order.size(); ++q) {
+    const std::size_t u = order[q];
+    for (std::size_t v : down[u]) {
+      l.layer[v] = std::max(l.layer[v], l.layer[u] + 1);
+      if (--indeg[v] == 0) order.push_back(v);
+    }
+  }
+  if (order.size() != n) throw std::runtime_error("layered_layout: cycle detected in graph");
+
+  // Compact away empty layers (levels skipped by the whole graph).
+  std::vector<std::size_t> used;
+  used.reserve(n);
+  for (std::size_t v = 0; v < n; ++v) used.push_back(l.layer[v]);
+  std::sort(used.begin(), used.end());
+  used.erase(std::unique(used.begin(), used.end()), used.end());
+  l.layers.assign(used.size(), {});
+  l.position.assign(n, 0);
+  for (std::size_t v : order) {
+    l.layer[v] = static_cast<std::size_t>(
+        std::lower_bound(used.begin(), used.end(), l.layer[v]) - used.begin());
+    l.position[v] = l.layers[l.layer[v]].size();
+    l.layers[l.layer[v]].push_back(v);
+  }
+
+  // Crossing reduction: run 0 starts from the discovery order, every restart
+  // from shuffled layers. Runs are spread over the workers and the remaining
+  // threads split large layers; the result does not depend on `threads`.
+  const std::size_t runs = 1 + options.restarts;
+  const unsigned threads = std::max(1u, options.threads);
+  const std::size_t workers = std::min<std::size_t>(threads, runs);
+  const unsigned inner = static_cast<unsigned>(std::max<std::size_t>(1, threads / workers));
+  layout_detail::layer_order initial{std::move(l.layers), std::move(l.position)};
+  std::vector<layout_detail::layer_order> results(runs);
+  std::vector<std::size_t> crossings(runs);
+  parallel_detail::run_workers(workers, [&](std::size_t w) {
+    for (std::size_t run = w; run < runs; run += workers) {
+      layout_detail::layer_order order = initial;
+      if (run > 0) {
+        std::mt19937_64 rng(options.seed + run);
+        for (std::size_t r = 0; r < order.layers.size(); ++r) {
+          std::shuffle(order.layers[r].begin(), order.layers[r].end(), rng);
+          order.renumber(r);
+        }
+      }
+      crossings[run] =
+          layout_detail::reduce_crossings(l.layer, order, up, down, options.sweeps, inner);
+      results[run] = std::move(order);
+    }
+  });
+  const std::size_t best = static_cast<std::size_t>(
+      std::min_element(crossings.begin(), crossings.end()) - crossings.begin());
+  l.layers = std::move(results[best].layers);
+  l.position = std::move(results[best].position);
+  l.crossings = crossings[best];
+
+  // Node sizes; circles are as wide as they are high.
+  l.width.resize(n);
+  l.height.assign(n, options.node_height);
+  for (std::size_t v = 0; v < n; ++v) {
+    const auto& attrs = ir.nodes[v].attributes;
+    auto label = attrs.find(ir_attrs::k_label);
+    const std::size_t chars = label != attrs.end()
+                                  ? layout_detail::display_length(label->second)
+                                  : std::to_string(ir.nodes[v].id).size();
+    double w = std::max(options.min_node_width,
+                        options.char_width * static_cast<double>(chars) + options.node_padding);
+    auto shape = attrs.find(ir_attrs::k_shape);
+    if (shape != attrs.end() && (shape->second == "circle" || shape->second == "doublecircle")) {
+      w = std::max(w, options.node_height);
+      l.height[v] = w;
+    }
+    l.width[v] = w;
+  }
+
+  // Coordinates: pack every layer, then alternate barycentric passes.
+  l.x.assign(n, 0.0);
+  std::vector<double> desired;
+  for (std::size_t r = 0; r < l.layers.size(); ++r) {
+    desired.clear();
+    double next = 0.0;
+    for (std::size_t v : l.layers[r]) {
+      desired.push_back(next + l.width[v] / 2.0);
+      next += l.width[v] + options.node_spacing;
+    }
+    layout_detail::place_layer(l, r, desired, options.node_spacing);
+  }
+  for (std::size_t pass = 0; pass < options.coordinate_passes; ++pass) {
+    const bool downward = pass % 2 == 0;
+    const auto& side = downward ? up : down;
+    for (std::size_t k = 0; k < l.layers.size(); ++k) {
+      const std::size_t r = downward ? k : l.layers.size() - 1 - k;
+      desired.clear();
+      for (std::size_t v : l.layers[r]) {
+        double target = l.x[v];
+        if (!side[v].empty()) {
+          double sum = 0.0;
+          for (std::size_t u : side[v]) sum += l.x[u];
+          target = sum / static_cast<double>(side[v].size());
+        }
+        desired.push_back(target);
+      }
+      layout_detail::place_layer(l, r, desired, options.node_spacing);
+    }
+  }
+
+  // Translate into the canvas.
+  double left = std::numeric_limits<double>::max();
+  double right = std::numeric_limits<double>::lowest();
+  for (std::size_t v = 0; v < n; ++v) {
+    left = std::min(left, l.x[v] - l.width[v] / 2.0);
+    right = std::max(right, l.x[v] + l.width[v] / 2.0);
+  }
+  std::vector<double> layer_height(l.layers.size(), options.node_height);
+  for (std::size_t v = 0; v < n; ++v) {
+    layer_height[l.layer[v]] = std::max(layer_height[l.layer[v]], l.height[v]);
+  }
+  std::vector<double> layer_y(l.layers.size());
+  double top = options.margin;
+  for (std::size_t r = 0; r < l.layers.size(); ++r) {
+    layer_y[r] = top + layer_height[r] / 2.0;
+    top += layer_height[r] + (options.layer_spacing - options.node_height);
+  }
+  l.y.resize(n);
+  for (std::size_t v = 0; v < n; ++v) {
+    l.x[v] += options.margin - left;
+    l.y[v] = layer_y[l.layer[v]];
+  }
+  l.canvas_width = n == 0 ? 2.0 * options.margin : right - left + 2.0 * options.margin;
+  l.canvas_height = n == 0 ? 2.0 * options.margin
+                           : top - (options.layer_spacing - options.node_height) + options.margin;
+  return l;
+}
+
+}  // namespace dagir
@@ -0,0 +1,460 @@
+/**
+ * @file
+ * @brief Header-only loader for the Graphviz DOT subset that `render_dot` writes.
+ *
+ * `load_dot` reads a `digraph` into an `ir_document`, so files produced by
+ * DOT-only tools can go through the DagIR renderers and algorithms without
+ * Graphviz. It reads every form of `render_dot` output (readable, minified,
+ * with defaults, rank subgraphs and sink copies) and the common hand-written
+ * syntax around it: comments, `strict`, `graph [...]`, edge chains
+ * `a -> b -> c`, `"a" + "b"` concatenation and `;`/`,` separators. Ports,
+ * undirected graphs, HTML labels and subgraphs as edge endpoints are
+ * rejected.
+ *
+ * The mapping inverts `render_dot`, so `render_dot(load_dot(text))`
+ * reproduces `render_dot` output:
+ *
+ * - Nodes are numbered by position of first mention, as in `load_json`.
+ *   A node name is kept as the `name` attribute, except the unquoted names
+ *   `render_dot` generates (`n<id>` and minified `compact_id`s). The node attribute
+ *   `name` becomes `k_id`, the key `render_dot` writes as `name`.
+ * - Top-level `k = v` statements and `graph [...]` set global attributes;
+ *   `label` becomes `k_graph_label`. `rankdir = TB`, the Graphviz default
+ *   that `render_dot` always writes, is not stored.
+ * - `node [...]` and `edge [...]` set defaults for the nodes (edges) created
+ *   after them in the same braces, as in Graphviz. Sink copies of
+ *   `dot_options::duplicate_sinks` therefore load as separate nodes.
+ * - Nodes of the i-th `{ rank = same; ... }` subgraph get `k_level` i.
+ * - Quoted strings are unescaped as `render_dot` escapes them (`\\`, `\"`,
+ *   `\n`, `\r`, `\t`, `\f`, `\v`, `\xNN`); other escapes such as `\l` are
+ *   kept as written.
+ *
+ * Quoted strings are scanned with `load_json_detail::find_quote_or_escape`
+ * and node names are looked up in a `load_json_detail::id_table`.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/ir_attrs.hpp>
+#include <dagir/load_json.hpp>
+#include <deque>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace dagir {
+
+namespace load_dot_detail {
+
+/// Deepest nesting of subgraphs and `{ }` blocks accepted; bounds the recursion.
+inline constexpr std::size_t k_max_nesting = 1000;
+
+/// Attribute assignments in statement order, keys interned.
+using assignments = std::vector<std::pair<std::string_view, std::string>>;
+
+/// True if `id` equals the DOT keyword `kw` (keywords are case-insensitive).
+inline bool is_keyword(std::string_view id, std::string_view kw) {
+  return id.size() == kw.size() && std::equal(id.begin(), id.end(), kw.begin(), [](char a, char b) {
+           return (a >= 'A' && a <= 'Z' ? static_cast<char>(a + 32) : a) == b;
+         });
+}
+
+/// True for the names `render_dot` generates: `n<id>` and minified `compact_id`s.
+inline bool is_generated_name(std::string_view id) {
+  if (id.size() < 2) return false;
+  if (id.front() == 'n') {
+    return std::all_of(id.begin() + 1, id.end(), [](char c) { return c >= '0' && c <= '9'; });
+  }
+  return id.front() == '_' && std::all_of(id.begin() + 1, id.end(), [](char c) {
+           return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+         });
+}
+
+/// Single-pass reader of one `digraph` into an `ir_document`.
+class parser {
+ public:
+  parser(std::string_view text, ir_document& doc) : text_(text), doc_(doc) {}
+
+  void document() {
+    bool quoted = false;
+    std::string_view word = id(quoted);
+    if (!quoted && is_keyword(word, "strict")) word = id(quoted);
+    if (quoted || !is_keyword(word, "digraph")) {
+      fail(!quoted && is_keyword(word, "graph") ? "only digraphs are supported"
+                                                : "expected 'digraph'");
+    }
+    if (!consume('{')) {
+      id(quoted);  // graph name
+      expect('{');
+    }
+    scopes_.emplace_back();
+    statements();
+    skip_ws();
+    if (pos_ != text_.size()) fail("trailing characters");
+
+    // Node names, unless generated or equal to the `id` they were written from.
+    for (std::size_t i = 0; i < names_.size(); ++i) {
+      if (names_[i].empty()) continue;
+      auto& attrs = doc_.graph.nodes[i].attributes;
+      auto id = attrs.find(ir_attrs::k_id);
+      if (id == attrs.end() || id->second != names_[i]) {
+        attrs.emplace(ir_attrs::k_name, names_[i]);
+      }
+    }
+  }
+
+ private:
+  /// Defaults and rank of one pair of braces; members only below the top level.
+  struct scope {
+    assignments node_defaults;
+    assignments edge_defaults;
+    std::vector<std::uint64_t> members;
+    bool rank_same = false;
+  };
+
+  [[noreturn]] void fail(std::string_view what) const {
+    const std::string_view before = text_.substr(0, pos_);
+    const auto line = 1 + std::count(before.begin(), before.end(), '\n');
+    throw std::runtime_error(std::format("load_dot: {} at line {}", what, line));
+  }
+
+  /// Skip whitespace, `//` and `/* */` comments and `#` lines.
+  void skip_ws() {
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_];
+      if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        ++pos_;
+      } else if (c == '#' && (pos_ == 0 || text_[pos_ - 1] == '\n')) {
+        pos_ = std::min(text_.find('\n', pos_), text_.size());
+      } else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/') {
+        pos_ = std::min(text_.find('\n', pos_), text_.size());
+      } else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '*') {
+        const std::size_t end = text_.find("*/", pos_ + 2);
+        if (end == std::string_view::npos) fail("unterminated comment");
+        pos_ = end + 2;
+      } else {
+        break;
+      }
+    }
+  }
+
+  bool consume(char c) {
+    skip_ws();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) fail(std::format("expected '{}'", c));
+  }
+
+  /// True (and consumed) if the next token is the edge operator `->`.
+  bool arrow() {
+    skip_ws();
+    if (text_.substr(pos_, 2) == "->") {
+      pos_ += 2;
+      return true;
+    }
+    if (text_.substr(pos_, 2) == "--") fail("only digraphs are supported");
+    return false;
+  }
+
+  /// Append the body of the quoted string whose opening quote was just read.
+  void quoted_body(std::string& out) {
+    for (;;) {
+      const std::size_t run =
+          load_json_detail::find_quote_or_escape(text_.data() + pos_, text_.size() - pos_);
+      out.append(text_.data() + pos_, run);
+      pos_ += run;
+      if (pos_ == text_.size()) fail("unterminated string");
+      if (text_[pos_++] == '"') return;
+      if (pos_ == text_.size()) fail("unterminated string");
+      const char e = text_[pos_++];
+      switch (e) {
+        case '"':
+        case '\\':
+          out += e;
+          break;
+        case 'n':
+          out += '\n';
+          break;
+        case 'r':
+          out += '\r';
+          break;
+        case 't':
+          out += '\t';
+          break;
+        case 'f':
+          out += '\f';
+          break;
+        case 'v':
+          out += '\v';
+          break;
+        case '\n':  // line continuation
+          break;
+        case '\r':
+          if (pos_ < text_.size() && text_[pos_] == '\n') ++pos_;
+          break;
+        case 'x': {
+          const auto hex = [](char c) {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+          };
+          if (text_.size() - pos_ >= 2 && hex(text_[pos_]) && hex(text_[pos_ + 1])) {
+            out += static_cast<char>(std::stoi(std::string(text_.substr(pos_, 2)), nullptr, 16));
+            pos_ += 2;
+          } else {
+            out += "\\x";
+          }
+          break;
+        }
+        default:
+          out += '\\';
+          out += e;
+          break;
+      }
+    }
+  }
+
+  /**
+   * @brief The next DOT ID: a quoted string, an identifier or a numeral.
+   *
+   * Points into the input unless the string has escapes or is concatenated;
+   * then it points into `scratch_`, valid until the next ID is read.
+   */
+  std::string_view id(bool& quoted) {
+    skip_ws();
+    if (pos_ == text_.size()) fail("unexpected end of input");
+    const char c = text_[pos_];
+    if (c == '"') {
+      quoted = true;
+      const std::size_t start = ++pos_;
+      const std::size_t run =
+          load_json_detail::find_quote_or_escape(text_.data() + pos_, text_.size() - pos_);
+      std::string_view out;
+      if (pos_ + run < text_.size() && text_[pos_ + run] == '"') {
+        pos_ += run + 1;
+        out = text_.substr(start, run);
+        if (!continues()) return out;
+        scratch_.assign(out);
+      } else {
+        scratch_.clear();
+        quoted_body(scratch_);
+        if (!continues()) return scratch_;
+      }
+      do {
+        quoted_body(scratch_);
+      } while (continues());
+      return scratch_;
+    }
+    if (c == '<') fail("HTML strings are not supported");
+    quoted = false;
+    const std::size_t start = pos_;
+    while (pos_ < text_.size()) {
+      const auto u = static_cast<unsigned char>(text_[pos_]);
+      const bool word = (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') ||
+                        (u >= '0' && u <= '9') || u == '_' || u == '.' || u >= 0x80 ||
+                        (u == '-' && pos_ == start);
+      if (!word) break;
+      ++pos_;
+    }
+    if (pos_ == start) fail("expected an ID");
+    return text_.substr(start, pos_ - start);
+  }
+
+  /// True (and the next opening quote consumed) if a `+` concatenation follows.
+  bool continues() {
+    const std::size_t at = pos_;
+    skip_ws();
+    if (pos_ < text_.size() && text_[pos_] == '+') {
+      ++pos_;
+      skip_ws();
+      if (pos_ == text_.size() || text_[pos_] != '"') fail("expected a string after '+'");
+      ++pos_;
+      return true;
+    }
+    pos_ = at;
+    return false;
+  }
+
+  std::string_view intern(std::string_view key) {
+    if (auto it = keys_.find(key); it != keys_.end()) return *it;
+    return *keys_.insert(doc_.intern(key)).first;
+  }
+
+  /// `[k = v, ...]` lists, each assignment passed to `set(key, value)`.
+  template <class Set>
+  void attributes(Set&& set) {
+    while (consume('[')) {
+      while (!consume(']')) {
+        bool quoted = false;
+        const std::string_view key = intern(id(quoted));
+        expect('=');
+        set(key, std::string(id(quoted)));
+        if (!consume(',')) consume(';');
+      }
+    }
+  }
+
+  /// Position of the node named `name`, created with the current defaults if new.
+  std::uint64_t node(std::string_view name, bool quoted) {
+    std::uint64_t position = ids_.find(name);
+    if (position == load_json_detail::id_table::npos) {
+      position = doc_.graph.nodes.size();
+      ir_node& n = doc_.graph.nodes.emplace_back();
+      n.id = position;
+      for (const auto& [k, v] : scopes_.back().node_defaults) set_node_attribute(n, k, v);
+      if (name.data() == scratch_.data()) name = owned_.emplace_back(name);
+      ids_.insert(name, position);
+      names_.push_back(quoted || !is_generated_name(name) ? name : std::string_view{});
+    }
+    if (scopes_.size() > 1) scopes_.back().members.push_back(position);
+    return position;
+  }
+
+  static void set_node_attribute(ir_node& n, std::string_view k, std::string v) {
+    n.attributes.insert_or_assign(k == ir_attrs::k_name ? ir_attrs::k_id : k, std::move(v));
+  }
+
+  void statements() {
+    while (!consume('}')) {
+      statement();
+      if (!consume(';')) consume(',');
+    }
+  }
+
+  void subgraph() {
+    if (scopes_.size() > k_max_nesting) fail("subgraphs nested too deeply");
+    scope inner;
+    inner.node_defaults = scopes_.back().node_defaults;
+    inner.edge_defaults = scopes_.back().edge_defaults;
+    scopes_.push_back(std::move(inner));
+    statements();
+    scope done = std::move(scopes_.back());
+    scopes_.pop_back();
+    if (done.rank_same) {
+      const std::string level = std::to_string(next_rank_++);
+      for (std::uint64_t m : done.members) {
+        doc_.graph.nodes[static_cast<std::size_t>(m)].attributes.insert_or_assign(ir_attrs::k_level,
+                                                                                  level);
+      }
+    }
+    if (scopes_.size() > 1) {
+      auto& members = scopes_.back().members;
+      members.insert(members.end(), done.members.begin(), done.members.end());
+    }
+  }
+
+  void statement() {
+    if (consume('{')) return subgraph();
+    bool quoted = false;
+    const std::string_view first = id(quoted);
+    if (!quoted) {
+      if (is_keyword(first, "subgraph")) {
+        if (!consume('{')) {
+          id(quoted);
+          expect('{');
+        }
+        return subgraph();
+      }
+      const bool is_node = is_keyword(first, "node");
+      const bool is_edge = is_keyword(first, "edge");
+      if (is_node || is_edge) {
+        auto& defaults = is_node ? scopes_.back().node_defaults : scopes_.back().edge_defaults;
+        attributes(
+            [&](std::string_view k, std::string v) { defaults.emplace_back(k, std::move(v)); });
+        return;
+      }
+      if (is_keyword(first, "graph")) {
+        attributes([&](std::string_view k, std::string v) { graph_attribute(k, std::move(v)); });
+        return;
+      }
+    }
+    if (consume('=')) {
+      const std::string_view key = intern(first);
+      graph_attribute(key, std::string(id(quoted)));
+      return;
+    }
+
+    std::uint64_t from = node(first, quoted);
+    if (!arrow()) {
+      ir_node& n = doc_.graph.nodes[static_cast<std::size_t>(from)];
+      attributes(
+          [&](std::string_view k, std::string v) { set_node_attribute(n, k, std::move(v)); });
+      return;
+    }
+    // Edge chain: every edge of `a -> b -> c` gets the same attributes.
+    const std::size_t first_edge = doc_.graph.edges.size();
+    do {
+      skip_ws();
+      if (pos_ < text_.size() && text_[pos_] == '{') {
+        fail("subgraph edge endpoints are not supported");
+      }
+      const std::string_view name = id(quoted);
+      const std::uint64_t to = node(name, quoted);
+      ir_edge& e = doc_.graph.edges.emplace_back();
+      e.source = from;
+      e.target = to;
+      for (const auto& [k, v] : scopes_.back().edge_defaults) e.attributes.insert_or_assign(k, v);
+      from = to;
+    } while (arrow());
+    auto& edges = doc_.graph.edges;
+    attributes([&](std::string_view k, std::string v) {
+      for (std::size_t i = first_edge + 1; i < edges.size(); ++i) {
+        edges[i].attributes.insert_or_assign(k, v);
+      }
+      edges[first_edge].attributes.insert_or_assign(k, std::move(v));
+    });
+  }
+
+  /// A `k = v` statement: global attribute at the top level, rank in subgraphs.
+  void graph_attribute(std::string_view key, std::string value) {
+    if (scopes_.size() > 1) {
+      if (key == "rank" && value == "same") scopes_.back().rank_same = true;
+      return;
+    }
+    if (key == ir_attrs::k_rankdir && value == "TB") return;
+    doc_.graph.global_attrs.insert_or_assign(
+        key == ir_attrs::k_label ? ir_attrs::k_graph_label : key, std::move(value));
+  }
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+  ir_document& doc_;
+  std::string scratch_;
+  std::deque<std::string> owned_;  ///< Escaped node names.
+  std::unordered_set<std::string_view> keys_;
+  load_json_detail::id_table ids_;
+  std::vector<std::string_view> names_;  ///< By position; empty if generated.
+  std::vector<scope> scopes_;
+  std::size_t next_rank_ = 0;
+};
+
+}  // namespace load_dot_detail
+
+/**
+ * @brief Load a `digraph` in the DOT subset described in this header.
+ *
+ * @throws std::runtime_error with the line number if `text` is outside the
+ *         subset or malformed.
+ */
+inline ir_document load_dot(std::string_view text) {
+  ir_document doc;
+  load_dot_detail::parser(text, doc).document();
+  return doc;
+}
+
+}  // namespace dagir
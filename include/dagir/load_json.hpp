@@ -0,0 +1,514 @@
+/**
+ * @file
+ * @brief Header-only loader for `render_json` output (`docs/dagir_json_schema.json`).
+ *
+ * `load_json` reads a document written by `render_json`, in any of its
+ * forms (indented, minified, with hoisted `defaults`), back into an
+ * `ir_document` in one pass over the text, so archived output can be
+ * rendered again with another backend or compared.
+ *
+ * - Attribute values come back as the text of the JSON value: strings
+ *   unescaped, numbers, `true`, `false` and `null` as written. Values in
+ *   `defaults` are applied to every node (edge) that does not list the key.
+ * - Nodes are numbered by position, as in `decode_cbor`. Edge `source` and
+ *   `target` are resolved by node `id`; ids that name no node get ids past
+ *   the last node, in order of first use. A node `label` member replaces
+ *   the `label` attribute: it holds the exact text, which the attribute
+ *   may not (`render_json` writes the label `007` as the number `7` there).
+ * - `roots` and members not in the schema are skipped.
+ *
+ * Most bytes of a document are inside strings (ids, keys, labels); their
+ * ends are found 32 (AVX2) or 16 (SSE2) bytes at a time when available, with
+ * a scalar fallback. Attribute keys are interned once per distinct key.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/ir_attrs.hpp>
+#include <deque>
+#include <format>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace dagir {
+
+namespace load_json_detail {
+
+/// Offset of the first `"` or `\` in `p[0, n)`, or `n`.
+inline std::size_t find_quote_or_escape(const char* p, std::size_t n) noexcept {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i quote32 = _mm256_set1_epi8('"');
+  const __m256i escape32 = _mm256_set1_epi8('\\');
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, quote32), _mm256_cmpeq_epi8(v, escape32))));
+    if (mask != 0) return i + static_cast<std::size_t>(std::countr_zero(mask));
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i quote16 = _mm_set1_epi8('"');
+  const __m128i escape16 = _mm_set1_epi8('\\');
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    const auto mask = static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote16), _mm_cmpeq_epi8(v, escape16))));
+    if (mask != 0) return i + static_cast<std::size_t>(std::countr_zero(mask));
+  }
+#endif
+  for (; i < n; ++i) {
+    if (p[i] == '"' || p[i] == '\\') return i;
+  }
+  return n;
+}
+
+/// Append the UTF-8 encoding of code point `cp` to `out`.
+inline void append_utf8(std::string& out, std::uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xc0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xe0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (cp & 0x3f));
+  }
+}
+
+/**
+ * @brief Map from node id text to node position, with first insertion winning.
+ *
+ * Open addressing with linear probing; the hash is stored next to the key,
+ * so a lookup of one of millions of ids usually costs a single cache miss.
+ */
+class id_table {
+ public:
+  static constexpr std::uint64_t npos = ~std::uint64_t{0};
+
+  void insert(std::string_view id, std::uint64_t position) {
+    if (2 * (size_ + 1) > slots_.size()) grow();
+    const std::size_t hash = std::hash<std::string_view>{}(id);
+    slot& s = slots_[probe(id, hash)];
+    if (s.key.data() != nullptr) return;
+    s = slot{id, hash, position};
+    ++size_;
+  }
+
+  std::uint64_t find(std::string_view id) const {
+    if (slots_.empty()) return npos;
+    const slot& s = slots_[probe(id, std::hash<std::string_view>{}(id))];
+    return s.key.data() != nullptr ? s.value : npos;
+  }
+
+ private:
+  struct slot {
+    std::string_view key;  ///< `data() == nullptr` marks an empty slot.
+    std::size_t hash = 0;
+    std::uint64_t value = 0;
+  };
+
+  /// Index of the slot holding `id`, or of the empty slot where it belongs.
+  std::size_t probe(std::string_view id, std::size_t hash) const {
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+      const slot& s = slots_[i];
+      if (s.key.data() == nullptr || (s.hash == hash && s.key == id)) return i;
+    }
+  }
+
+  void grow() {
+    std::vector<slot> old(std::max<std::size_t>(16, 2 * slots_.size()));
+    old.swap(slots_);
+    const std::size_t mask = slots_.size() - 1;
+    for (const slot& s : old) {
+      if (s.key.data() == nullptr) continue;
+      std::size_t i = s.hash & mask;
+      while (slots_[i].key.data() != nullptr) i = (i + 1) & mask;
+      slots_[i] = s;
+    }
+  }
+
+  std::vector<slot> slots_;
+  std::size_t size_ = 0;
+};
+
+/// Single-pass reader of one document into an `ir_document`.
+class parser {
+ public:
+  parser(std::string_view text, ir_document& doc) : text_(text), doc_(doc) {}
+
+  void document() {
+    expect('{');
+    if (!consume('}')) {
+      do {
+        const std::string member(string());
+        expect(':');
+        if (member == "nodes") {
+          nodes();
+        } else if (member == "edges") {
+          edges();
+        } else if (member == "graphAttributes") {
+          attributes(doc_.graph.global_attrs);
+        } else if (member == "defaults") {
+          defaults();
+        } else {
+          skip_value();
+        }
+      } while (consume(','));
+      expect('}');
+    }
+    skip_ws();
+    if (pos_ != text_.size()) fail("trailing characters");
+    resolve_edges();
+    apply_defaults();
+  }
+
+ private:
+  [[noreturn]] void fail(std::string_view what) const {
+    throw std::runtime_error(std::format("load_json: {} at offset {}", what, pos_));
+  }
+
+  void skip_ws() {
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_];
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+      ++pos_;
+    }
+  }
+
+  bool consume(char c) {
+    skip_ws();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) fail(std::format("expected '{}'", c));
+  }
+
+  std::uint32_t hex4() {
+    if (text_.size() - pos_ < 4) fail("truncated \\u escape");
+    std::uint32_t cp = 0;
+    for (int k = 0; k < 4; ++k) {
+      const char c = text_[pos_++];
+      cp <<= 4;
+      if (c >= '0' && c <= '9') {
+        cp |= static_cast<std::uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        cp |= static_cast<std::uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        cp |= static_cast<std::uint32_t>(c - 'A' + 10);
+      } else {
+        fail("bad \\u escape");
+      }
+    }
+    return cp;
+  }
+
+  /**
+   * @brief The string whose opening quote was just read.
+   *
+   * Points into the input unless the string has escapes; then it points
+   * into `scratch_`, valid until the next string is read.
+   */
+  std::string_view string_body() {
+    const std::size_t start = pos_;
+    std::size_t run = find_quote_or_escape(text_.data() + pos_, text_.size() - pos_);
+    pos_ += run;
+    if (pos_ == text_.size()) fail("unterminated string");
+    if (text_[pos_] == '"') {
+      ++pos_;
+      return text_.substr(start, run);
+    }
+    scratch_.assign(text_.data() + start, run);
+    while (text_[pos_] == '\\') {
+      if (++pos_ == text_.size()) fail("unterminated string");
+      const char e = text_[pos_++];
+      switch (e) {
+        case '"':
+        case '\\':
+        case '/':
+          scratch_ += e;
+          break;
+        case 'b':
+          scratch_ += '\b';
+          break;
+        case 'f':
+          scratch_ += '\f';
+          break;
+        case 'n':
+          scratch_ += '\n';
+          break;
+        case 'r':
+          scratch_ += '\r';
+          break;
+        case 't':
+          scratch_ += '\t';
+          break;
+        case 'u': {
+          std::uint32_t cp = hex4();
+          if (cp >= 0xd800 && cp < 0xdc00 && text_.substr(pos_, 2) == "\\u") {
+            pos_ += 2;
+            const std::uint32_t low = hex4();
+            if (low < 0xdc00 || low >= 0xe000) fail("bad surrogate pair");
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+          }
+          append_utf8(scratch_, cp);
+          break;
+        }
+        default:
+          fail("bad escape");
+      }
+      run = find_quote_or_escape(text_.data() + pos_, text_.size() - pos_);
+      scratch_.append(text_.data() + pos_, run);
+      pos_ += run;
+      if (pos_ == text_.size()) fail("unterminated string");
+    }
+    ++pos_;
+    return scratch_;
+  }
+
+  std::string_view string() {
+    if (!consume('"')) fail("expected a string");
+    return string_body();
+  }
+
+  /// The attribute key starting here, interned once per distinct spelling.
+  std::string_view key() {
+    if (!consume('"')) fail("expected a key");
+    const std::size_t start = pos_;
+    const std::string_view key = string_body();
+    const std::string_view raw = text_.substr(start, pos_ - 1 - start);
+    if (auto it = keys_.find(raw); it != keys_.end()) return it->second;
+    return keys_.emplace(raw, doc_.intern(key)).first->second;
+  }
+
+  /// A string, number, boolean or null, as text.
+  void value(std::string& out) {
+    skip_ws();
+    if (pos_ == text_.size()) fail("expected a value");
+    const char c = text_[pos_];
+    if (c == '"') {
+      ++pos_;
+      out.assign(string_body());
+      return;
+    }
+    const std::string_view token = literal();
+    const bool number = c == '-' || (c >= '0' && c <= '9');
+    if (!number && token != "true" && token != "false" && token != "null") {
+      fail("attribute values must be strings, numbers, booleans or null");
+    }
+    out.assign(token);
+  }
+
+  std::string_view literal() {
+    const std::size_t start = pos_;
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_];
+      const bool word = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+                        (c >= 'A' && c <= 'Z') || c == '-' || c == '+' || c == '.';
+      if (!word) break;
+      ++pos_;
+    }
+    if (pos_ == start) fail("unexpected character");
+    return text_.substr(start, pos_ - start);
+  }
+
+  void attributes(ir_attr_map& out) {
+    expect('{');
+    if (consume('}')) return;
+    do {
+      const std::string_view k = key();
+      expect(':');
+      value(out[k]);
+    } while (consume(','));
+    expect('}');
+  }
+
+  /// `s` with a lifetime beyond the next string read.
+  std::string_view keep(std::string_view s) {
+    if (s.data() == scratch_.data()) return owned_.emplace_back(s);
+    return s;
+  }
+
+  void nodes() {
+    expect('[');
+    if (consume(']')) return;
+    do {
+      const std::uint64_t position = doc_.graph.nodes.size();
+      ir_node& n = doc_.graph.nodes.emplace_back();
+      n.id = position;
+      std::string label;
+      bool has_label = false;
+      expect('{');
+      if (!consume('}')) {
+        do {
+          const std::string_view member = string();
+          expect(':');
+          if (member == "id") {
+            ids_.insert(keep(string()), position);
+          } else if (member == "label") {
+            label.assign(string());
+            has_label = true;
+          } else if (member == "attributes") {
+            attributes(n.attributes);
+          } else {
+            skip_value();
+          }
+        } while (consume(','));
+        expect('}');
+      }
+      if (has_label) n.attributes.insert_or_assign(ir_attrs::k_label, std::move(label));
+    } while (consume(','));
+    expect(']');
+  }
+
+  void edges() {
+    expect('[');
+    if (consume(']')) return;
+    do {
+      ir_edge& e = doc_.graph.edges.emplace_back();
+      std::string_view source;
+      std::string_view target;
+      expect('{');
+      if (!consume('}')) {
+        do {
+          const std::string_view member = string();
+          expect(':');
+          if (member == "source") {
+            source = keep(string());
+          } else if (member == "target") {
+            target = keep(string());
+          } else if (member == "attributes") {
+            attributes(e.attributes);
+          } else {
+            skip_value();
+          }
+        } while (consume(','));
+        expect('}');
+      }
+      if (source.data() == nullptr || target.data() == nullptr) fail("edge without endpoints");
+      endpoints_.emplace_back(source, target);
+    } while (consume(','));
+    expect(']');
+  }
+
+  void defaults() {
+    expect('{');
+    if (consume('}')) return;
+    do {
+      const std::string_view member = string();
+      expect(':');
+      if (member == "node") {
+        attributes(node_defaults_);
+      } else if (member == "edge") {
+        attributes(edge_defaults_);
+      } else {
+        skip_value();
+      }
+    } while (consume(','));
+    expect('}');
+  }
+
+  /// Skip one value of any shape (for members outside the schema).
+  void skip_value() {
+    std::size_t depth = 0;
+    do {
+      skip_ws();
+      if (pos_ == text_.size()) fail("unexpected end of input");
+      const char c = text_[pos_];
+      if (c == '{' || c == '[') {
+        ++depth;
+        ++pos_;
+      } else if (c == '}' || c == ']') {
+        if (depth == 0) fail("unbalanced brackets");
+        --depth;
+        ++pos_;
+      } else if (c == ',' || c == ':') {
+        ++pos_;
+      } else if (c == '"') {
+        ++pos_;
+        string_body();
+      } else {
+        literal();
+      }
+    } while (depth > 0);
+  }
+
+  void resolve_edges() {
+    std::unordered_map<std::string_view, std::uint64_t> dangling;
+    auto resolve = [&](std::string_view id) {
+      if (const std::uint64_t position = ids_.find(id); position != id_table::npos) {
+        return position;
+      }
+      return doc_.graph.nodes.size() + dangling.try_emplace(id, dangling.size()).first->second;
+    };
+    for (std::size_t i = 0; i < endpoints_.size(); ++i) {
+      doc_.graph.edges[i].source = resolve(endpoints_[i].first);
+      doc_.graph.edges[i].target = resolve(endpoints_[i].second);
+    }
+  }
+
+  void apply_defaults() {
+    for (const auto& [k, v] : node_defaults_) {
+      for (auto& n : doc_.graph.nodes) n.attributes.try_emplace(k, v);
+    }
+    for (const auto& [k, v] : edge_defaults_) {
+      for (auto& e : doc_.graph.edges) e.attributes.try_emplace(k, v);
+    }
+  }
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+  ir_document& doc_;
+  std::string scratch_;
+  std::deque<std::string> owned_;  ///< Escaped ids and endpoints.
+  std::unordered_map<std::string_view, std::string_view> keys_;
+  id_table ids_;
+  std::vector<std::pair<std::string_view, std::string_view>> endpoints_;
+  ir_attr_map node_defaults_;
+  ir_attr_map edge_defaults_;
+};
+
+}  // namespace load_json_detail
+
+/**
+ * @brief Load a document written by `render_json`.
+ *
+ * @throws std::runtime_error with the byte offset if `text` is not valid
+ *         JSON of the expected shape.
+ */
+inline ir_document load_json(std::string_view text) {
+  ir_document doc;
+  load_json_detail::parser(text, doc).document();
+  return doc;
+}
+
+}  // namespace dagir
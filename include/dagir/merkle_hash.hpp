@@ -0,0 +1,311 @@
+/**
+ * @file merkle_hash.hpp
+ * @brief Structural 128-bit (Merkle) hashes of the nodes of a DAG view.
+ *
+ * @details
+ * `stable_key()` identifies a node only within one process (it is usually a
+ * pointer). `merkle_hashes` instead computes a structural hash for every node
+ * reachable from `view.roots()`, bottom-up:
+ *
+ *   hash(n) = H(label(n), hash(child_0), ..., hash(child_k-1), k)
+ *
+ * where `label(n)` is a `hash128` supplied by a label-hash policy and child
+ * order is significant. Two nodes have the same hash when (up to hash
+ * collisions) they root identical labelled subgraphs, in this run or any
+ * other, which makes the hashes usable as cross-run cache keys, for finding
+ * duplicate subgraphs and for O(1) comparison of whole graphs
+ * (`merkle_graph_hash`).
+ *
+ * `H` is a fast non-cryptographic hash built on 64x64->128-bit multiply
+ * folding (in the style of wyhash), run as two independently keyed 64-bit
+ * lanes. Input bytes are read little-endian, so hashes are identical across
+ * platforms. It is not collision resistant against adversarial input.
+ *
+ * With `threads > 1`, label hashes are computed in parallel and nodes are then
+ * combined height by height (all children of a node have a smaller height),
+ * each level split across the threads. The label-hash policy must then be safe
+ * to call concurrently; the view is only used from the calling thread.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dagir/algorithms.hpp"
+#include "dagir/concepts/bdd_view.hpp"
+#include "dagir/concepts/read_only_dag_view.hpp"
+#include "dagir/parallel.hpp"
+
+namespace dagir {
+
+/**
+ * @brief 128-bit hash value.
+ */
+struct hash128 {
+  std::uint64_t lo = 0;
+  std::uint64_t hi = 0;
+
+  friend constexpr bool operator==(const hash128&, const hash128&) noexcept = default;
+  friend constexpr auto operator<=>(const hash128& a, const hash128& b) noexcept {
+    if (a.hi != b.hi) return a.hi <=> b.hi;
+    return a.lo <=> b.lo;
+  }
+};
+
+/// 32 lowercase hex digits, most significant first (usable as a file name).
+inline std::string to_string(const hash128& h) {
+  static constexpr char digits[] = "0123456789abcdef";
+  std::string out(32, '0');
+  for (int i = 0; i < 16; ++i) {
+    out[15 - i] = digits[(h.hi >> (4 * i)) & 0xF];
+    out[31 - i] = digits[(h.lo >> (4 * i)) & 0xF];
+  }
+  return out;
+}
+
+namespace merkle_detail {
+
+inline constexpr std::uint64_t k_secret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                              0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+/// Multiply to 128 bits and fold the halves with xor.
+inline std::uint64_t mum_fold(std::uint64_t a, std::uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+  __extension__ using u128 = unsigned __int128;
+  const u128 r = static_cast<u128>(a) * b;
+  return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+  const std::uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+  const std::uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+  const std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+  const std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+  const std::uint64_t lo = (ll & 0xFFFFFFFFu) | (mid << 32);
+  const std::uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  return lo ^ hi;
+#endif
+}
+
+inline std::uint64_t load_le64(const unsigned char* p) noexcept {
+  std::uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+}  // namespace merkle_detail
+
+/**
+ * @brief Incremental 128-bit hasher over 64-bit word pairs.
+ *
+ * Used for both label bytes and node combination; `finish` folds in a
+ * caller-supplied length so inputs of different lengths never collide
+ * trivially.
+ */
+class hash128_builder {
+ public:
+  explicit hash128_builder(std::uint64_t seed = 0) noexcept
+      : a_(seed ^ merkle_detail::k_secret[0]),
+        b_(merkle_detail::mum_fold(seed ^ merkle_detail::k_secret[1],
+                                   merkle_detail::k_secret[2])) {}
+
+  /// Absorb two words.
+  void add(std::uint64_t w0, std::uint64_t w1) noexcept {
+    using merkle_detail::k_secret;
+    using merkle_detail::mum_fold;
+    const std::uint64_t a = mum_fold(a_ ^ w0 ^ k_secret[1], w1 ^ k_secret[2]);
+    const std::uint64_t b = mum_fold(b_ ^ w1 ^ k_secret[3], w0 ^ k_secret[0]);
+    a_ = a;
+    b_ = b;
+  }
+
+  /// Absorb a 128-bit hash.
+  void add(const hash128& h) noexcept { add(h.lo, h.hi); }
+
+  /// Final avalanche; `length` is mixed in as the last input.
+  hash128 finish(std::uint64_t length) const noexcept {
+    using merkle_detail::k_secret;
+    using merkle_detail::mum_fold;
+    return {mum_fold(a_ ^ length ^ k_secret[3], b_ ^ k_secret[1]),
+            mum_fold(b_ ^ length ^ k_secret[0], a_ ^ k_secret[2])};
+  }
+
+ private:
+  std::uint64_t a_, b_;
+};
+
+/**
+ * @brief Hash a byte string.
+ */
+inline hash128 hash_bytes(std::string_view bytes, std::uint64_t seed = 0) noexcept {
+  const auto* p = reinterpret_cast<const unsigned char*>(bytes.data());
+  std::size_t n = bytes.size();
+  hash128_builder h(seed);
+  for (; n >= 16; p += 16, n -= 16) {
+    h.add(merkle_detail::load_le64(p), merkle_detail::load_le64(p + 8));
+  }
+  if (n != 0) {
+    unsigned char tail[16] = {};
+    std::copy(p, p + n, tail);
+    h.add(merkle_detail::load_le64(tail), merkle_detail::load_le64(tail + 8));
+  }
+  return h.finish(bytes.size());
+}
+
+/**
+ * @brief Hash a 64-bit integer (for labels that are numbers).
+ */
+inline hash128 hash_integer(std::uint64_t value, std::uint64_t seed = 0) noexcept {
+  hash128_builder h(seed);
+  h.add(value, ~value);
+  return h.finish(8);
+}
+
+/**
+ * @brief Label-hash policy for BDD views: terminals hash their value,
+ *        decision nodes their variable index.
+ */
+struct bdd_label_hash {
+  template <dagir::concepts::bdd_view View>
+  hash128 operator()(const View& view, const typename View::handle& h) const {
+    if (view.is_terminal(h)) return hash_integer(view.terminal_value(h) ? 1 : 0, 1);
+    return hash_integer(static_cast<std::uint64_t>(view.variable_index(h)), 2);
+  }
+};
+
+/// Result of `merkle_hashes`: node `stable_key()` -> structural hash.
+using merkle_hash_map = std::unordered_map<std::uint64_t, hash128>;
+
+namespace merkle_detail {
+
+/// Run `body(i)` for `i` in `[0, n)` on up to `threads` threads.
+template <class Body>
+void parallel_for(std::size_t n, unsigned threads, Body&& body) {
+  constexpr std::size_t k_min_per_thread = 1024;
+  const std::size_t workers =
+      std::max<std::size_t>(1, std::min<std::size_t>(threads, n / k_min_per_thread));
+  parallel_detail::run_workers(workers, [&](std::size_t w) {
+    for (std::size_t i = n * w / workers; i < n * (w + 1) / workers; ++i) body(i);
+  });
+}
+
+}  // namespace merkle_detail
+
+/**
+ * @brief Compute structural hashes of every node reachable from `view.roots()`.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ * @tparam LabelHash Callable as `hash128(const View&, const View::handle&)`
+ * @param view The read-only DAG view
+ * @param label_hash Hash of everything about a node except its children
+ * @param threads Worker threads (1 = run on the calling thread)
+ * @return Map from node `stable_key()` to its structural hash.
+ * @throws std::runtime_error if a cycle is detected in the reachable subgraph.
+ */
+template <dagir::concepts::read_only_dag_view View, class LabelHash>
+  requires std::convertible_to<
+      std::invoke_result_t<LabelHash&, const View&, const typename View::handle&>, hash128>
+merkle_hash_map merkle_hashes(const View& view, LabelHash label_hash, unsigned threads = 1) {
+  using H = typename View::handle;
+
+  // Dense numbering in topological order and CSR children (calling thread only).
+  const std::vector<H> topo = kahn_topological_order(view);
+  const std::size_t n = topo.size();
+  std::unordered_map<std::uint64_t, std::uint32_t> index;
+  index.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    index.emplace(topo[i].stable_key(), static_cast<std::uint32_t>(i));
+  }
+
+  auto extract_child = []<class E>(const E& e) -> H {
+    if constexpr (std::convertible_to<E, H>) {
+      return static_cast<H>(e);
+    } else {
+      return e.target();
+    }
+  };
+  std::vector<std::uint32_t> first(n + 1, 0);
+  std::vector<std::uint32_t> child;
+  for (std::size_t i = 0; i < n; ++i) {
+    for (auto const& edge_like : view.children(topo[i])) {
+      child.push_back(index.at(extract_child(edge_like).stable_key()));
+    }
+    first[i + 1] = static_cast<std::uint32_t>(child.size());
+  }
+
+  // Height buckets: children always sit in a lower bucket than their parents.
+  std::vector<std::uint32_t> height(n, 0);
+  std::uint32_t max_height = 0;
+  for (std::size_t i = n; i-- > 0;) {
+    for (std::uint32_t e = first[i]; e < first[i + 1]; ++e) {
+      height[i] = std::max(height[i], height[child[e]] + 1);
+    }
+    max_height = std::max(max_height, height[i]);
+  }
+  std::vector<std::vector<std::uint32_t>> levels(n == 0 ? 0 : max_height + 1);
+  for (std::size_t i = 0; i < n; ++i) levels[height[i]].push_back(static_cast<std::uint32_t>(i));
+
+  std::vector<hash128> hashes(n);
+  merkle_detail::parallel_for(n, threads, [&](std::size_t i) {
+    hashes[i] = std::invoke(label_hash, view, topo[i]);
+  });
+  for (const auto& level : levels) {
+    merkle_detail::parallel_for(level.size(), threads, [&](std::size_t k) {
+      const std::uint32_t i = level[k];
+      hash128_builder h;
+      h.add(hashes[i]);
+      for (std::uint32_t e = first[i]; e < first[i + 1]; ++e) h.add(hashes[child[e]]);
+      hashes[i] = h.finish(first[i + 1] - first[i]);
+    });
+  }
+
+  merkle_hash_map out;
+  out.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) out.emplace(topo[i].stable_key(), hashes[i]);
+  return out;
+}
+
+/**
+ * @brief Hash of a whole graph: the structural hashes of `view.roots()`, in order.
+ *
+ * Two views with equal graph hashes have (up to collisions) identical
+ * labelled graphs and roots.
+ */
+template <dagir::concepts::read_only_dag_view View>
+hash128 merkle_graph_hash(const View& view, const merkle_hash_map& hashes) {
+  hash128_builder h(merkle_detail::k_secret[3]);
+  std::uint64_t count = 0;
+  for (auto const& r : view.roots()) {
+    const typename View::handle root = r;
+    h.add(hashes.at(root.stable_key()));
+    ++count;
+  }
+  return h.finish(count);
+}
+
+/// Convenience overload computing the node hashes first.
+template <dagir::concepts::read_only_dag_view View, class LabelHash>
+hash128 merkle_graph_hash(const View& view, LabelHash label_hash, unsigned threads = 1) {
+  return merkle_graph_hash(view, merkle_hashes(view, std::move(label_hash), threads));
+}
+
+}  // namespace dagir
+
+template <>
+struct std::hash<dagir::hash128> {
+  std::size_t operator()(const dagir::hash128& h) const noexcept {
+    return static_cast<std::size_t>(h.lo ^ (h.hi * 0x9E3779B97F4A7C15ull));
+  }
+};
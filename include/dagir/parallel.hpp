@@ -0,0 +1,57 @@
+/**
+ * @file parallel.hpp
+ * @brief Fork-join helper shared by the multi-threaded layout and renderers.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace dagir {
+namespace parallel_detail {
+
+/**
+ * @brief Run `body(w)` for every `w < workers` and wait for all of them.
+ *
+ * `body(0)` runs on the calling thread and every other worker on a thread of
+ * its own. All workers are joined before the first error (lowest `w`) is
+ * rethrown.
+ */
+template <class Body>
+void run_workers(std::size_t workers, Body&& body) {
+  if (workers <= 1) {
+    if (workers == 1) body(std::size_t{0});
+    return;
+  }
+  std::vector<std::exception_ptr> errors(workers);
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w) {
+      pool.emplace_back([&, w] {
+        try {
+          body(w);
+        } catch (...) {
+          errors[w] = std::current_exception();
+        }
+      });
+    }
+    try {
+      body(std::size_t{0});
+    } catch (...) {
+      errors[0] = std::current_exception();
+    }
+  }
+  for (const auto& e : errors) {
+    if (e) std::rethrow_exception(e);
+  }
+}
+
+}  // namespace parallel_detail
+}  // namespace dagir
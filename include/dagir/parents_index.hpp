@@ -0,0 +1,173 @@
+/**
+ * @file parents_index.hpp
+ * @brief Reverse adjacency (parents) index and a reversed DAG view.
+ *
+ * @details
+ * `read_only_dag_view` only exposes `children()`, so bottom-up queries
+ * (ancestors of a terminal, in-degree distribution, impact analysis) would
+ * otherwise re-traverse the whole graph. `parents_index` walks the subgraph
+ * reachable from `view.roots()` once and stores the parents of every node in
+ * compressed sparse row form: one offset array plus one contiguous array of
+ * parent edges. A node reached through k edges lists k parents (in discovery
+ * order), so `in_degree` counts edges, not distinct parents.
+ *
+ * `reversed_view` adapts an index to `read_only_dag_view` with the edges
+ * flipped and, by default, the sinks of the original graph as roots. The
+ * existing algorithms (`kahn_topological_order`, `postorder_fold`,
+ * `build_ir`, ...) then run bottom-up unchanged; passing explicit roots
+ * restricts them to the ancestors of those nodes.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dagir/concepts/read_only_dag_view.hpp"
+
+namespace dagir {
+
+/**
+ * @brief CSR index of the parents of every node reachable from `view.roots()`.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ */
+template <dagir::concepts::read_only_dag_view View>
+class parents_index {
+ public:
+  using handle = typename View::handle;
+  using edge = basic_edge<handle>;
+
+  /// Build the index in one traversal of `view`.
+  explicit parents_index(const View& view) {
+    auto extract_child = []<class E>(const E& e) -> handle {
+      if constexpr (std::convertible_to<E, handle>) {
+        return static_cast<handle>(e);
+      } else {
+        return e.target();
+      }
+    };
+    auto discover = [&](const handle& h) -> std::uint32_t {
+      auto [it, inserted] =
+          index_.try_emplace(h.stable_key(), static_cast<std::uint32_t>(nodes_.size()));
+      if (inserted) nodes_.push_back(h);
+      return it->second;
+    };
+
+    for (auto const& r : view.roots()) discover(r);
+
+    // (parent, child) pairs of every edge, then a counting sort by child.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+    std::vector<bool> has_children;
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      const handle node = nodes_[i];
+      bool any = false;
+      for (auto const& edge_like : view.children(node)) {
+        edges.emplace_back(static_cast<std::uint32_t>(i), discover(extract_child(edge_like)));
+        any = true;
+      }
+      has_children.push_back(any);
+    }
+
+    offsets_.assign(nodes_.size() + 1, 0);
+    for (const auto& [parent, child] : edges) ++offsets_[child + 1];
+    for (std::size_t i = 0; i < nodes_.size(); ++i) offsets_[i + 1] += offsets_[i];
+    std::vector<std::uint32_t> fill(offsets_.begin(), offsets_.end() - 1);
+    std::vector<std::uint32_t> parent_of(edges.size());
+    for (const auto& [parent, child] : edges) parent_of[fill[child]++] = parent;
+    parents_.reserve(edges.size());
+    for (std::uint32_t parent : parent_of) parents_.push_back(edge{nodes_[parent]});
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      if (!has_children[i]) sinks_.push_back(nodes_[i]);
+    }
+  }
+
+  /// Number of indexed nodes.
+  std::size_t size() const noexcept { return nodes_.size(); }
+
+  /// Number of indexed edges.
+  std::size_t edge_count() const noexcept { return parents_.size(); }
+
+  /// Indexed nodes in discovery (breadth-first) order.
+  std::span<const handle> nodes() const noexcept { return nodes_; }
+
+  /// Nodes without children, in discovery order.
+  std::span<const handle> sinks() const noexcept { return sinks_; }
+
+  /// True if `h` is reachable from the roots of the indexed view.
+  bool contains(const handle& h) const { return index_.contains(h.stable_key()); }
+
+  /**
+   * @brief Parent edges of `h`; each `target()` is a parent.
+   * @throws std::out_of_range If `h` is not indexed.
+   */
+  std::span<const edge> parents(const handle& h) const {
+    const std::uint32_t i = index_.at(h.stable_key());
+    return std::span<const edge>(parents_).subspan(offsets_[i], offsets_[i + 1] - offsets_[i]);
+  }
+
+  /**
+   * @brief Number of edges entering `h`.
+   * @throws std::out_of_range If `h` is not indexed.
+   */
+  std::size_t in_degree(const handle& h) const {
+    const std::uint32_t i = index_.at(h.stable_key());
+    return offsets_[i + 1] - offsets_[i];
+  }
+
+ private:
+  std::vector<handle> nodes_;
+  std::vector<handle> sinks_;
+  std::unordered_map<std::uint64_t, std::uint32_t> index_;
+  std::vector<std::uint32_t> offsets_;
+  std::vector<edge> parents_;
+};
+
+/**
+ * @brief `read_only_dag_view` over a `parents_index` with every edge reversed.
+ *
+ * Handles are those of the original view. The index must outlive the view.
+ */
+template <dagir::concepts::read_only_dag_view View>
+class reversed_view {
+ public:
+  using handle = typename View::handle;
+
+  /// Reversed view rooted at the sinks of the original graph.
+  explicit reversed_view(const parents_index<View>& index)
+      : index_(&index), roots_(index.sinks().begin(), index.sinks().end()) {}
+
+  /**
+   * @brief Reversed view rooted at `roots` (e.g. to enumerate their ancestors).
+   * @throws std::invalid_argument If a root is not indexed.
+   */
+  reversed_view(const parents_index<View>& index, std::vector<handle> roots)
+      : index_(&index), roots_(std::move(roots)) {
+    for (const handle& r : roots_) {
+      if (!index.contains(r)) throw std::invalid_argument("reversed_view: root is not indexed");
+    }
+  }
+
+  /// Parents of `h` in the original graph.
+  std::span<const basic_edge<handle>> children(const handle& h) const {
+    return index_->parents(h);
+  }
+
+  std::span<const handle> roots() const noexcept { return roots_; }
+
+ private:
+  const parents_index<View>* index_;
+  std::vector<handle> roots_;
+};
+
+}  // namespace dagir
@@ -0,0 +1,393 @@
+/**
+ * @file reachability.hpp
+ * @brief Bitset reachability (transitive closure) indexes over DAG views.
+ *
+ * @details
+ * Questions such as "is X in the cone of Y" or "which roots share this
+ * subgraph" would otherwise cost a traversal through the adapter per query.
+ * Both indexes below number the nodes reachable from `view.roots()` in
+ * depth-first reverse postorder, so every node precedes its descendants and
+ * the descendants of a node tend to sit in a narrow band of indexes. The
+ * closure of a node is then stored as a windowed bitset: only the words from
+ * the node's own position up to its last descendant are kept.
+ *
+ * - `reachability_index` computes every closure eagerly in reverse
+ *   topological order by OR-ing the windows of the children (AVX2 when
+ *   available), after which `reaches` is O(1).
+ * - `lazy_reachability_index` computes the closure of a source on its first
+ *   query, reusing closures already cached for its descendants, and keeps the
+ *   closures in an LRU cache bounded by `max_bytes`.
+ *
+ * Every node reaches itself. Handles are looked up by `stable_key()`.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "dagir/concepts/read_only_dag_view.hpp"
+
+namespace dagir {
+
+namespace reachability_detail {
+
+/// `dst[i] |= src[i]` for `i` in `[0, n)`.
+inline void or_words(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+  }
+#endif
+  for (; i < n; ++i) dst[i] |= src[i];
+}
+
+/**
+ * @brief Reachable subgraph numbered in depth-first reverse postorder, with
+ *        children in CSR form.
+ */
+template <class H>
+struct dag_numbering {
+  std::vector<H> nodes;  ///< `nodes[i]` has index `i`; parents precede children
+  std::unordered_map<std::uint64_t, std::uint32_t> index;
+  std::vector<std::uint32_t> first;  ///< `child[first[i] .. first[i + 1])`
+  std::vector<std::uint32_t> child;
+  std::vector<std::uint32_t> roots;
+
+  std::uint32_t at(const H& h) const { return index.at(h.stable_key()); }
+};
+
+/**
+ * @throws std::runtime_error if a cycle is detected in the reachable subgraph.
+ */
+template <dagir::concepts::read_only_dag_view View>
+dag_numbering<typename View::handle> number_dag(const View& view) {
+  using H = typename View::handle;
+  auto extract_child = []<class E>(const E& e) -> H {
+    if constexpr (std::convertible_to<E, H>) {
+      return static_cast<H>(e);
+    } else {
+      return e.target();
+    }
+  };
+
+  // Discovery ids; each node's children are appended once, on first visit.
+  std::vector<H> handles;
+  std::unordered_map<std::uint64_t, std::uint32_t> disc;
+  std::vector<std::uint32_t> first, count, child;
+  std::vector<std::uint8_t> state;  // 0 new, 1 on stack, 2 finished
+  auto discover = [&](const H& h) {
+    auto [it, inserted] =
+        disc.try_emplace(h.stable_key(), static_cast<std::uint32_t>(handles.size()));
+    if (inserted) {
+      handles.push_back(h);
+      first.push_back(0);
+      count.push_back(0);
+      state.push_back(0);
+    }
+    return it->second;
+  };
+
+  std::vector<std::uint32_t> root_disc;
+  for (auto const& r : view.roots()) root_disc.push_back(discover(r));
+
+  std::vector<std::uint32_t> postorder;
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;  // (node, next child)
+  for (std::uint32_t r : root_disc) {
+    if (state[r] != 0) continue;
+    stack.push_back({r, 0});
+    while (!stack.empty()) {
+      auto& [n, next] = stack.back();
+      if (state[n] == 0) {
+        state[n] = 1;
+        first[n] = static_cast<std::uint32_t>(child.size());
+        for (auto const& edge_like : view.children(handles[n])) {
+          child.push_back(discover(extract_child(edge_like)));
+        }
+        count[n] = static_cast<std::uint32_t>(child.size()) - first[n];
+      }
+      if (next < count[n]) {
+        const std::uint32_t c = child[first[n] + next++];
+        if (state[c] == 1) {
+          throw std::runtime_error("number_dag: cycle detected in reachable graph");
+        }
+        if (state[c] == 0) stack.push_back({c, 0});
+      } else {
+        state[n] = 2;
+        postorder.push_back(n);
+        stack.pop_back();
+      }
+    }
+  }
+
+  // Relabel: index = position in reverse postorder.
+  const std::size_t n = handles.size();
+  std::vector<std::uint32_t> label(n);
+  for (std::size_t p = 0; p < n; ++p) label[postorder[p]] = static_cast<std::uint32_t>(n - 1 - p);
+
+  dag_numbering<H> out;
+  out.nodes.reserve(n);
+  for (std::size_t p = n; p-- > 0;) out.nodes.push_back(handles[postorder[p]]);
+  out.index.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    out.index.emplace(out.nodes[i].stable_key(), static_cast<std::uint32_t>(i));
+  }
+  out.first.assign(n + 1, 0);
+  out.child.reserve(child.size());
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::uint32_t d = postorder[n - 1 - i];
+    for (std::uint32_t k = 0; k < count[d]; ++k) out.child.push_back(label[child[first[d] + k]]);
+    out.first[i + 1] = static_cast<std::uint32_t>(out.child.size());
+  }
+  for (std::uint32_t r : root_disc) out.roots.push_back(label[r]);
+  return out;
+}
+
+}  // namespace reachability_detail
+
+/**
+ * @brief Eager reachability index with O(1) queries.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ */
+template <dagir::concepts::read_only_dag_view View>
+class reachability_index {
+ public:
+  using handle = typename View::handle;
+
+  /**
+   * @brief Number the reachable subgraph and compute every closure.
+   * @throws std::runtime_error if a cycle is detected in the reachable subgraph.
+   */
+  explicit reachability_index(const View& view) : dag_(reachability_detail::number_dag(view)) {
+    const std::size_t n = dag_.nodes.size();
+    windows_.resize(n);
+    // Window extents first (children have larger indexes), then the words.
+    std::size_t total = 0;
+    for (std::size_t i = n; i-- > 0;) {
+      window& w = windows_[i];
+      w.first_word = static_cast<std::uint32_t>(i / 64);
+      std::uint32_t end = w.first_word + 1;
+      for (std::uint32_t e = dag_.first[i]; e < dag_.first[i + 1]; ++e) {
+        const window& c = windows_[dag_.child[e]];
+        end = std::max(end, c.first_word + c.word_count);
+      }
+      w.word_count = end - w.first_word;
+    }
+    for (window& w : windows_) {
+      w.offset = total;
+      total += w.word_count;
+    }
+    words_.assign(total, 0);
+    for (std::size_t i = n; i-- > 0;) {
+      const window& w = windows_[i];
+      std::uint64_t* dst = words_.data() + w.offset;
+      dst[0] |= std::uint64_t{1} << (i % 64);
+      for (std::uint32_t e = dag_.first[i]; e < dag_.first[i + 1]; ++e) {
+        const window& c = windows_[dag_.child[e]];
+        reachability_detail::or_words(dst + (c.first_word - w.first_word), words_.data() + c.offset,
+                                      c.word_count);
+      }
+    }
+  }
+
+  /// Number of indexed nodes.
+  std::size_t size() const noexcept { return dag_.nodes.size(); }
+
+  /// True if `h` is reachable from the roots of the indexed view.
+  bool contains(const handle& h) const { return dag_.index.contains(h.stable_key()); }
+
+  /**
+   * @brief True if `to` is reachable from `from` (including `from == to`).
+   * @throws std::out_of_range If either handle is not indexed.
+   */
+  bool reaches(const handle& from, const handle& to) const {
+    return test(dag_.at(from), dag_.at(to));
+  }
+
+  /**
+   * @brief Number of nodes reachable from `h`, including `h`.
+   * @throws std::out_of_range If `h` is not indexed.
+   */
+  std::size_t descendant_count(const handle& h) const {
+    const window& w = windows_[dag_.at(h)];
+    std::size_t total = 0;
+    for (std::uint32_t k = 0; k < w.word_count; ++k) {
+      total += static_cast<std::size_t>(std::popcount(words_[w.offset + k]));
+    }
+    return total;
+  }
+
+  /**
+   * @brief Roots of the view (in order) from which `h` is reachable.
+   * @throws std::out_of_range If `h` is not indexed.
+   */
+  std::vector<handle> roots_reaching(const handle& h) const {
+    const std::uint32_t to = dag_.at(h);
+    std::vector<handle> out;
+    for (std::uint32_t r : dag_.roots) {
+      if (test(r, to)) out.push_back(dag_.nodes[r]);
+    }
+    return out;
+  }
+
+  /// Bytes used by the closure bitsets and their windows.
+  std::size_t memory_bytes() const noexcept {
+    return words_.size() * sizeof(std::uint64_t) + windows_.size() * sizeof(window);
+  }
+
+ private:
+  struct window {
+    std::size_t offset = 0;
+    std::uint32_t first_word = 0;
+    std::uint32_t word_count = 0;
+  };
+
+  bool test(std::uint32_t from, std::uint32_t to) const noexcept {
+    const window& w = windows_[from];
+    const std::uint32_t word = to / 64;
+    if (word < w.first_word || word >= w.first_word + w.word_count) return false;
+    return (words_[w.offset + (word - w.first_word)] >> (to % 64)) & 1u;
+  }
+
+  reachability_detail::dag_numbering<handle> dag_;
+  std::vector<window> windows_;
+  std::vector<std::uint64_t> words_;
+};
+
+/**
+ * @brief Reachability index that builds closures on demand within a memory bound.
+ *
+ * Queries are O(1) once the closure of `from` is cached. Not thread-safe:
+ * `reaches` updates the cache.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ */
+template <dagir::concepts::read_only_dag_view View>
+class lazy_reachability_index {
+ public:
+  using handle = typename View::handle;
+
+  /**
+   * @param view The read-only DAG view
+   * @param max_bytes Bound on the bytes held by cached closures; the most
+   *        recently computed closure is always kept.
+   * @throws std::runtime_error if a cycle is detected in the reachable subgraph.
+   */
+  explicit lazy_reachability_index(const View& view, std::size_t max_bytes = std::size_t{64} << 20)
+      : dag_(reachability_detail::number_dag(view)),
+        max_bytes_(max_bytes),
+        cache_(dag_.nodes.size()),
+        scratch_((dag_.nodes.size() + 63) / 64, 0) {}
+
+  /// Number of indexed nodes.
+  std::size_t size() const noexcept { return dag_.nodes.size(); }
+
+  /**
+   * @brief True if `to` is reachable from `from` (including `from == to`).
+   * @throws std::out_of_range If either handle is not indexed.
+   */
+  bool reaches(const handle& from, const handle& to) {
+    const std::uint32_t f = dag_.at(from);
+    const std::uint32_t t = dag_.at(to);
+    if (t < f) return false;  // descendants always have larger indexes
+    const entry& e = closure(f);
+    const std::uint32_t word = t / 64;
+    if (word >= e.first_word + e.words.size()) return false;
+    return (e.words[word - e.first_word] >> (t % 64)) & 1u;
+  }
+
+  /// Number of closures currently cached.
+  std::size_t cached_closures() const noexcept { return lru_.size(); }
+
+  /// Bytes held by cached closures.
+  std::size_t memory_bytes() const noexcept { return bytes_; }
+
+ private:
+  struct entry {
+    std::uint32_t first_word = 0;
+    std::vector<std::uint64_t> words;  // empty: not cached
+    std::list<std::uint32_t>::iterator lru;
+  };
+
+  const entry& closure(std::uint32_t source) {
+    entry& e = cache_[source];
+    if (!e.words.empty()) {
+      lru_.splice(lru_.begin(), lru_, e.lru);
+      return e;
+    }
+
+    // DFS below `source`; set bits double as the visited set and cached
+    // closures are OR-ed in instead of being walked again.
+    const std::uint32_t lo = source / 64;
+    std::uint32_t hi = lo;
+    auto mark = [&](std::uint32_t n) {
+      scratch_[n / 64] |= std::uint64_t{1} << (n % 64);
+      hi = std::max(hi, n / 64);
+    };
+    auto marked = [&](std::uint32_t n) { return (scratch_[n / 64] >> (n % 64)) & 1u; };
+    mark(source);
+    stack_.assign(1, source);
+    while (!stack_.empty()) {
+      const std::uint32_t n = stack_.back();
+      stack_.pop_back();
+      for (std::uint32_t k = dag_.first[n]; k < dag_.first[n + 1]; ++k) {
+        const std::uint32_t c = dag_.child[k];
+        if (marked(c)) continue;
+        const entry& ce = cache_[c];
+        if (!ce.words.empty()) {
+          reachability_detail::or_words(scratch_.data() + ce.first_word, ce.words.data(),
+                                        ce.words.size());
+          hi = std::max<std::uint32_t>(
+              hi, ce.first_word + static_cast<std::uint32_t>(ce.words.size()) - 1);
+          continue;
+        }
+        mark(c);
+        stack_.push_back(c);
+      }
+    }
+
+    e.first_word = lo;
+    e.words.assign(scratch_.begin() + lo, scratch_.begin() + hi + 1);
+    std::fill(scratch_.begin() + lo, scratch_.begin() + hi + 1, 0);
+    lru_.push_front(source);
+    e.lru = lru_.begin();
+    bytes_ += e.words.size() * sizeof(std::uint64_t);
+
+    while (bytes_ > max_bytes_ && lru_.size() > 1) {
+      entry& victim = cache_[lru_.back()];
+      bytes_ -= victim.words.size() * sizeof(std::uint64_t);
+      victim.words = {};
+      lru_.pop_back();
+    }
+    return e;
+  }
+
+  reachability_detail::dag_numbering<handle> dag_;
+  std::size_t max_bytes_;
+  std::vector<entry> cache_;
+  std::list<std::uint32_t> lru_;  // most recently used first
+  std::size_t bytes_ = 0;
+  std::vector<std::uint64_t> scratch_;
+  std::vector<std::uint32_t> stack_;
+};
+
+}  // namespace dagir
@@ -0,0 +1,565 @@
+/**
+ * @file
+ * @brief Header-only CBOR renderer and decoder for `dagir::ir_graph`.
+ *
+ * `render_cbor` writes the content of `render_json` as CBOR (RFC 8949), which
+ * is smaller and cheaper to read back:
+ *
+ * @code
+ * 55799({                        ; self-described CBOR
+ *   "strings": [text, ...],      ; shared string table
+ *   "nodes": [[id, attrs], ...],
+ *   "edges": [[source, target, attrs], ...],
+ *   "graphAttributes": attrs     ; only when the graph has global attributes
+ * })
+ * attrs = {key index: value, ...}
+ * value = integer / float / bool / null / text / [string index]
+ * @endcode
+ *
+ * - The string table holds every attribute key and every string value used
+ *   more than once, most used first so frequent strings get one-byte
+ *   indices. Keys are table indices; a tabled value is written as the
+ *   one-element array `[index]`, other strings inline. No tags other than
+ *   the self-describe tag are used, so generic CBOR tools read the
+ *   document as plain data.
+ * - Values are typed as in `render_json`: what `try_emit_primitive`
+ *   accepts is written as a CBOR integer, float (single precision when
+ *   exact), boolean or null, provided its primitive text is the value itself.
+ *   Values that would change in the process (`007`, `1e300`) stay strings.
+ * - Node ids are the `name` attribute or the numeric id, as in
+ *   `render_json`. Edge endpoints are node positions in `nodes`; an endpoint
+ *   that is not a node is written as its numeric id in text.
+ * - Node labels are only written as attributes; `render_json`'s `label`
+ *   member is derived from them.
+ *
+ * `decode_cbor` reads this encoding back into an `ir_document` with every
+ * attribute value restored exactly. Nodes are numbered by position, so
+ * numeric ids of unnamed nodes are not preserved; names are. Endpoints that
+ * were not nodes get ids past the last node.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <dagir/ir.hpp>
+#include <dagir/ir_attrs.hpp>
+#include <dagir/render_json.hpp>
+#include <format>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dagir {
+
+namespace render_cbor_detail {
+
+/// CBOR major types used by the encoding.
+enum class major : std::uint8_t {
+  k_uint = 0,
+  k_negint = 1,
+  k_bytes = 2,
+  k_text = 3,
+  k_array = 4,
+  k_map = 5,
+  k_tag = 6,
+  k_simple = 7,
+};
+
+inline constexpr std::uint64_t k_self_describe_tag = 55799;
+inline constexpr std::uint8_t k_false = 0xf4;
+inline constexpr std::uint8_t k_true = 0xf5;
+inline constexpr std::uint8_t k_null = 0xf6;
+
+/// Bytes buffered by `writer` before they are handed to the stream.
+inline constexpr std::size_t k_write_buffer = std::size_t{1} << 16;
+
+/// Buffered CBOR writer; call `flush` when done.
+class writer {
+ public:
+  explicit writer(std::ostream& os) : os_(os) { buf_.reserve(k_write_buffer + 64); }
+
+  /// An item head: major type and argument, in the shortest form.
+  void head(major m, std::uint64_t v) {
+    const auto mt = static_cast<std::uint8_t>(static_cast<std::uint8_t>(m) << 5);
+    if (v < 24) {
+      byte(static_cast<std::uint8_t>(mt | v));
+    } else if (v <= 0xff) {
+      byte(mt | 24);
+      big_endian(v, 1);
+    } else if (v <= 0xffff) {
+      byte(mt | 25);
+      big_endian(v, 2);
+    } else if (v <= 0xffffffff) {
+      byte(mt | 26);
+      big_endian(v, 4);
+    } else {
+      byte(mt | 27);
+      big_endian(v, 8);
+    }
+  }
+
+  void text(std::string_view s) {
+    head(major::k_text, s.size());
+    buf_.append(s);
+    if (buf_.size() >= k_write_buffer) flush();
+  }
+
+  /// A float, in single precision when that is exact.
+  void real(double d) {
+    const auto f = static_cast<float>(d);
+    if (static_cast<double>(f) == d || d != d) {
+      byte(0xfa);
+      big_endian(std::bit_cast<std::uint32_t>(f), 4);
+    } else {
+      byte(0xfb);
+      big_endian(std::bit_cast<std::uint64_t>(d), 8);
+    }
+  }
+
+  void byte(std::uint8_t b) {
+    buf_.push_back(static_cast<char>(b));
+    if (buf_.size() >= k_write_buffer) flush();
+  }
+
+  void flush() {
+    os_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    buf_.clear();
+  }
+
+ private:
+  void big_endian(std::uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) buf_.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+  }
+
+  std::ostream& os_;
+  std::string buf_;
+};
+
+/// Attributes of an element in key order, as views into the element.
+using member_list = std::vector<std::pair<std::string_view, const std::string*>>;
+
+inline member_list sorted_members(const ir_attr_map& m, bool skip_id) {
+  member_list out;
+  out.reserve(m.size());
+  for (const auto& [k, v] : m) {
+    if (!skip_id || k != ir_attrs::k_id) out.emplace_back(k, &v);
+  }
+  std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+  return out;
+}
+
+/// `v` as a primitive when `render_json` types it and its text survives.
+inline std::optional<std::string> exact_primitive(const std::string& v) {
+  auto prim = render_json_detail::try_emit_primitive(v);
+  if (prim && *prim != v) prim.reset();
+  return prim;
+}
+
+/// The shared string table and the index of every tabled string.
+struct string_table {
+  std::vector<std::string_view> strings;
+  std::unordered_map<std::string_view, std::uint64_t> index;
+};
+
+/**
+ * @brief Table of all keys and the repeated string values of `g`.
+ *
+ * Ordered by use count, then by content, so it does not depend on hash
+ * iteration order.
+ */
+inline string_table make_string_table(const ir_graph& g) {
+  std::unordered_map<std::string_view, std::size_t> key_uses;
+  std::unordered_map<std::string_view, std::size_t> value_uses;
+  auto scan = [&](const ir_attr_map& m, bool skip_id) {
+    for (const auto& [k, v] : m) {
+      if (skip_id && k == ir_attrs::k_id) continue;
+      ++key_uses[k];
+      ++value_uses[v];
+    }
+  };
+  for (const auto& n : g.nodes) scan(n.attributes, true);
+  for (const auto& e : g.edges) scan(e.attributes, true);
+  scan(g.global_attrs, false);
+
+  // Keys and values share entries; a value that is also a key is tabled anyway.
+  for (auto& [v, uses] : value_uses) {
+    if (auto k = key_uses.find(v); k != key_uses.end()) {
+      k->second += uses;
+    } else if (uses >= 2 && !exact_primitive(std::string(v))) {
+      key_uses.emplace(v, uses);
+    }
+  }
+  std::vector<std::pair<std::string_view, std::size_t>> entries(key_uses.begin(), key_uses.end());
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+
+  string_table table;
+  table.strings.reserve(entries.size());
+  table.index.reserve(entries.size());
+  for (const auto& [s, uses] : entries) {
+    table.index.emplace(s, table.strings.size());
+    table.strings.push_back(s);
+  }
+  return table;
+}
+
+/// Write `v` typed as `render_json` would, or as a string.
+inline void write_value(writer& w, const std::string& v, const string_table& table) {
+  if (auto prim = exact_primitive(v)) {
+    if (*prim == "null") return w.byte(k_null);
+    if (*prim == "true") return w.byte(k_true);
+    if (*prim == "false") return w.byte(k_false);
+    long long iv = 0;
+    auto res = std::from_chars(prim->data(), prim->data() + prim->size(), iv);
+    if (res.ec == std::errc() && res.ptr == prim->data() + prim->size()) {
+      if (iv >= 0) return w.head(major::k_uint, static_cast<std::uint64_t>(iv));
+      return w.head(major::k_negint, static_cast<std::uint64_t>(-(iv + 1)));
+    }
+    return w.real(std::strtod(prim->c_str(), nullptr));
+  }
+  if (auto it = table.index.find(v); it != table.index.end()) {
+    w.head(major::k_array, 1);
+    return w.head(major::k_uint, it->second);
+  }
+  w.text(v);
+}
+
+inline void write_attributes(writer& w, const member_list& members, const string_table& table) {
+  w.head(major::k_map, members.size());
+  for (const auto& [k, v] : members) {
+    w.head(major::k_uint, table.index.at(k));
+    write_value(w, *v, table);
+  }
+}
+
+/// Bounds-checked reader over an encoded document.
+class reader {
+ public:
+  explicit reader(std::string_view bytes) : bytes_(bytes) {}
+
+  struct item {
+    major type;
+    std::uint8_t info;  ///< Additional information (low five bits).
+    std::uint64_t value;
+  };
+
+  /// The next item head. Indefinite lengths are rejected.
+  item head() {
+    const std::uint8_t initial = byte();
+    item it{static_cast<major>(initial >> 5), static_cast<std::uint8_t>(initial & 0x1f), 0};
+    if (it.info < 24) {
+      it.value = it.info;
+    } else if (it.info <= 27) {
+      it.value = big_endian(std::size_t{1} << (it.info - 24));
+    } else {
+      fail("unsupported item encoding");
+    }
+    return it;
+  }
+
+  std::string_view take(std::uint64_t n) {
+    if (n > bytes_.size() - pos_) fail("truncated input");
+    std::string_view out = bytes_.substr(pos_, static_cast<std::size_t>(n));
+    pos_ += static_cast<std::size_t>(n);
+    return out;
+  }
+
+  std::string_view text() {
+    const item it = head();
+    if (it.type != major::k_text) fail("expected a text string");
+    return take(it.value);
+  }
+
+  std::uint64_t length(major type) {
+    const item it = head();
+    if (it.type != type) fail(type == major::k_map ? "expected a map" : "expected an array");
+    // Every element takes at least one byte; larger lengths are corrupt.
+    if (it.value > bytes_.size() - pos_) fail("truncated input");
+    return it.value;
+  }
+
+  /// Skip one complete item (used for members added by later versions).
+  /// Nested items are counted rather than recursed into, so depth is unbounded.
+  void skip() {
+    std::uint64_t pending = 1;
+    while (pending != 0) {
+      --pending;
+      const item it = head();
+      // Every pending item takes at least one byte; larger counts are corrupt.
+      const std::uint64_t left = bytes_.size() - pos_;
+      if (pending > left) fail("truncated input");
+      const std::uint64_t room = left - pending;
+      switch (it.type) {
+        case major::k_text:
+        case major::k_bytes:
+          take(it.value);
+          break;
+        case major::k_array:
+          if (it.value > room) fail("truncated input");
+          pending += it.value;
+          break;
+        case major::k_map:
+          if (it.value > room / 2) fail("truncated input");
+          pending += 2 * it.value;
+          break;
+        case major::k_tag:
+          ++pending;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  bool done() const { return pos_ == bytes_.size(); }
+
+  [[noreturn]] static void fail(std::string_view what) {
+    throw std::runtime_error(std::format("decode_cbor: {}", what));
+  }
+
+ private:
+  std::uint8_t byte() {
+    if (pos_ == bytes_.size()) fail("truncated input");
+    return static_cast<std::uint8_t>(bytes_[pos_++]);
+  }
+
+  std::uint64_t big_endian(std::size_t n) {
+    std::uint64_t v = 0;
+    for (char c : take(n)) v = (v << 8) | static_cast<std::uint8_t>(c);
+    return v;
+  }
+
+  std::string_view bytes_;
+  std::size_t pos_ = 0;
+};
+
+/// `d` as `try_emit_primitive` prints it.
+inline std::string real_text(double d) {
+  std::ostringstream os;
+  os << std::setprecision(15) << d;
+  return os.str();
+}
+
+/// Decoding state: the document being built and the string table.
+struct decoder {
+  reader in;
+  ir_document& doc;
+  std::vector<std::string_view> strings;
+  std::vector<std::string_view> keys;  ///< Interned keys; empty data() when not yet interned.
+
+  std::string_view string_ref(std::uint64_t index) const {
+    if (index >= strings.size()) reader::fail("string reference out of range");
+    return strings[static_cast<std::size_t>(index)];
+  }
+
+  std::string_view key(std::uint64_t index) {
+    const std::string_view s = string_ref(index);
+    auto& k = keys[static_cast<std::size_t>(index)];
+    if (k.data() == nullptr) k = doc.intern(s);
+    return k;
+  }
+
+  std::string value() {
+    const auto it = in.head();
+    switch (it.type) {
+      case major::k_uint:
+        return std::to_string(it.value);
+      case major::k_negint:
+        if (it.value > static_cast<std::uint64_t>(std::numeric_limits<long long>::max())) {
+          reader::fail("integer out of range");
+        }
+        return std::to_string(-1 - static_cast<long long>(it.value));
+      case major::k_text:
+        return std::string(in.take(it.value));
+      case major::k_array: {
+        if (it.value != 1) reader::fail("expected a string index");
+        const auto ref = in.head();
+        if (ref.type != major::k_uint) reader::fail("expected a string index");
+        return std::string(string_ref(ref.value));
+      }
+      case major::k_simple:
+        if (it.info == 20) return "false";
+        if (it.info == 21) return "true";
+        if (it.info == 22) return "null";
+        if (it.info == 26) {
+          return real_text(std::bit_cast<float>(static_cast<std::uint32_t>(it.value)));
+        }
+        if (it.info == 27) return real_text(std::bit_cast<double>(it.value));
+        reader::fail("unsupported simple value");
+      default:
+        reader::fail("unexpected attribute value");
+    }
+  }
+
+  void attributes(ir_attr_map& out) {
+    const std::uint64_t n = in.length(major::k_map);
+    out.reserve(static_cast<std::size_t>(n));
+    for (std::uint64_t i = 0; i < n; ++i) {
+      const auto k = in.head();
+      if (k.type != major::k_uint) reader::fail("expected a key index");
+      const std::string_view name = key(k.value);
+      out.insert_or_assign(name, value());
+    }
+  }
+};
+
+}  // namespace render_cbor_detail
+
+/**
+ * @brief Render `g` as CBOR to `os`; see the file documentation for the layout.
+ */
+inline void render_cbor(std::ostream& os, const ir_graph& g) {
+  using render_cbor_detail::major;
+  const render_cbor_detail::string_table table = render_cbor_detail::make_string_table(g);
+  render_cbor_detail::writer w(os);
+
+  w.head(major::k_tag, render_cbor_detail::k_self_describe_tag);
+  w.head(major::k_map, g.global_attrs.empty() ? 3 : 4);
+
+  w.text("strings");
+  w.head(major::k_array, table.strings.size());
+  for (std::string_view s : table.strings) w.text(s);
+
+  // Node identifiers: prefer attribute "name"; fall back to numeric id.
+  std::unordered_map<std::uint64_t, std::size_t> position;
+  position.reserve(g.nodes.size());
+  w.text("nodes");
+  w.head(major::k_array, g.nodes.size());
+  for (std::size_t i = 0; i < g.nodes.size(); ++i) {
+    const ir_node& n = g.nodes[i];
+    position.try_emplace(n.id, i);
+    w.head(major::k_array, 2);
+    if (auto name = n.attributes.find(ir_attrs::k_name); name != n.attributes.end()) {
+      w.text(name->second);
+    } else {
+      w.text(std::to_string(n.id));
+    }
+    render_cbor_detail::write_attributes(w, render_cbor_detail::sorted_members(n.attributes, true),
+                                         table);
+  }
+
+  auto endpoint = [&](std::uint64_t id) {
+    if (auto it = position.find(id); it != position.end()) {
+      w.head(major::k_uint, it->second);
+    } else {
+      w.text(std::to_string(id));
+    }
+  };
+  w.text("edges");
+  w.head(major::k_array, g.edges.size());
+  for (const auto& e : g.edges) {
+    w.head(major::k_array, 3);
+    endpoint(e.source);
+    endpoint(e.target);
+    render_cbor_detail::write_attributes(w, render_cbor_detail::sorted_members(e.attributes, true),
+                                         table);
+  }
+
+  if (!g.global_attrs.empty()) {
+    w.text("graphAttributes");
+    render_cbor_detail::write_attributes(
+        w, render_cbor_detail::sorted_members(g.global_attrs, false), table);
+  }
+  w.flush();
+}
+
+/**
+ * @brief Load a document written by `render_cbor`.
+ *
+ * Members may come in any order as long as `strings` precedes its first use;
+ * unknown members are skipped.
+ *
+ * @throws std::runtime_error if `bytes` is not a valid encoding.
+ */
+inline ir_document decode_cbor(std::string_view bytes) {
+  using render_cbor_detail::major;
+  using render_cbor_detail::reader;
+  ir_document doc;
+  render_cbor_detail::decoder d{reader(bytes), doc, {}, {}};
+
+  auto top = d.in.head();
+  if (top.type == major::k_tag && top.value == render_cbor_detail::k_self_describe_tag) {
+    top = d.in.head();
+  }
+  if (top.type != major::k_map) reader::fail("expected a map");
+
+  // Endpoints are (value, dangling): a node position, or the index of a
+  // non-node endpoint, numbered after the nodes once their count is known.
+  std::unordered_map<std::string_view, std::uint64_t> dangling;
+  std::vector<std::pair<std::uint64_t, bool>> endpoints;
+  for (std::uint64_t member = 0; member < top.value; ++member) {
+    const std::string_view name = d.in.text();
+    if (name == "strings") {
+      const std::uint64_t n = d.in.length(major::k_array);
+      d.strings.clear();
+      for (std::uint64_t i = 0; i < n; ++i) d.strings.push_back(d.in.text());
+      d.keys.assign(d.strings.size(), std::string_view{});
+    } else if (name == "nodes") {
+      const std::uint64_t n = d.in.length(major::k_array);
+      doc.graph.nodes.resize(static_cast<std::size_t>(n));
+      for (std::uint64_t i = 0; i < n; ++i) {
+        if (d.in.length(major::k_array) != 2) reader::fail("malformed node");
+        d.in.text();  // The `name` attribute, or the numeric id that is not kept.
+        ir_node& node = doc.graph.nodes[static_cast<std::size_t>(i)];
+        node.id = i;
+        d.attributes(node.attributes);
+      }
+    } else if (name == "edges") {
+      const std::uint64_t n = d.in.length(major::k_array);
+      doc.graph.edges.resize(static_cast<std::size_t>(n));
+      endpoints.clear();
+      endpoints.reserve(static_cast<std::size_t>(2 * n));
+      for (std::uint64_t i = 0; i < n; ++i) {
+        if (d.in.length(major::k_array) != 3) reader::fail("malformed edge");
+        for (int end = 0; end < 2; ++end) {
+          const auto it = d.in.head();
+          if (it.type == major::k_uint) {
+            endpoints.emplace_back(it.value, false);
+          } else if (it.type == major::k_text) {
+            const auto ref = dangling.try_emplace(d.in.take(it.value), dangling.size()).first;
+            endpoints.emplace_back(ref->second, true);
+          } else {
+            reader::fail("malformed edge endpoint");
+          }
+        }
+        d.attributes(doc.graph.edges[static_cast<std::size_t>(i)].attributes);
+      }
+    } else if (name == "graphAttributes") {
+      d.attributes(doc.graph.global_attrs);
+    } else {
+      d.in.skip();
+    }
+  }
+  if (!d.in.done()) reader::fail("trailing bytes");
+
+  const std::uint64_t node_count = doc.graph.nodes.size();
+  auto resolve = [&](const std::pair<std::uint64_t, bool>& end) {
+    if (end.second) return node_count + end.first;
+    if (end.first >= node_count) reader::fail("edge endpoint out of range");
+    return end.first;
+  };
+  for (std::size_t i = 0; i < doc.graph.edges.size(); ++i) {
+    doc.graph.edges[i].source = resolve(endpoints[2 * i]);
+    doc.graph.edges[i].target = resolve(endpoints[2 * i + 1]);
+  }
+  return doc;
+}
+
+}  // namespace dagir
@@ -19,16 +19,20 @@
 #pragma once
 
 #include <algorithm>
+#include <dagir/chunked_output.hpp>
 #include <dagir/ir.hpp>
 #include <dagir/ir_attrs.hpp>
+#include <dagir/ir_compact.hpp>
 #include <format>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <ostream>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace dagir {
@@ -89,148 +93,357 @@ inline std::string escape_dot(const std::string& s) {
   return out;
 }
 
+/// Keys of `m` in lexicographic order.
+inline std::vector<std::string_view> sorted_keys(const ir_attr_map& m) {
+  std::vector<std::string_view> keys;
+  keys.reserve(m.size());
+  std::transform(m.begin(), m.end(), std::back_inserter(keys),
+                 [](auto const& p) { return p.first; });
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
 /**
- * @brief Helper that emits a comma-separated list of attributes to `os`.
+ * @brief Attributes written for a node: the label first, then the remaining
+ *        keys in lexicographic order, with `style = "filled"` by default.
  *
- * Each attribute is emitted as `key="escaped value"`. This is an internal
- * helper used during node/edge emission.
+ * `k_id` is written as DOT `name`; a literal `name` key is dropped. With
+ * `drop_level`, the layout-only `k_level` is dropped as well.
  */
+inline attr_list node_attributes(const ir_node& n, bool drop_level) {
+  const auto& amap = n.attributes;
+  attr_list out;
+  out.reserve(amap.size() + 2);
+  out.emplace_back("label", amap.count(ir_attrs::k_label) ? amap.at(ir_attrs::k_label)
+                                                          : std::format("{}", n.id));
+  bool styled = false;
+  for (const auto& k : sorted_keys(amap)) {
+    if (k == ir_attrs::k_label || k == ir_attrs::k_name) continue;
+    if (drop_level && k == ir_attrs::k_level) continue;
+    if (k == ir_attrs::k_style) styled = true;
+    if (!styled && k > ir_attrs::k_style) {
+      out.emplace_back(ir_attrs::k_style, "filled");
+      styled = true;
+    }
+    out.emplace_back(k == ir_attrs::k_id ? std::string_view("name") : k, amap.at(k));
+  }
+  if (!styled) out.emplace_back(ir_attrs::k_style, "filled");
+  return out;
+}
+
+/// Attributes written for an edge: the label first, then the rest in lexicographic order.
+inline attr_list edge_attributes(const ir_edge& e) {
+  const auto& amap = e.attributes;
+  attr_list out;
+  out.reserve(amap.size());
+  if (amap.count(ir_attrs::k_label)) out.emplace_back("label", amap.at(ir_attrs::k_label));
+  for (const auto& k : sorted_keys(amap)) {
+    if (k != ir_attrs::k_label) out.emplace_back(k, amap.at(k));
+  }
+  return out;
+}
+
+/// Order of `k_level` values: decimal numbers first, numerically, then every
+/// other value lexicographically.
+struct level_less {
+  static bool is_number(const std::string& v) {
+    return !v.empty() &&
+           std::all_of(v.begin(), v.end(), [](char c) { return c >= '0' && c <= '9'; });
+  }
+  bool operator()(const std::string& a, const std::string& b) const {
+    const bool a_number = is_number(a);
+    if (a_number != is_number(b)) return a_number;
+    if (a_number) {
+      // Leading zeros do not change the value; equal values keep a strict order.
+      const auto a_digits = std::min(a.find_first_not_of('0'), a.size());
+      const auto b_digits = std::min(b.find_first_not_of('0'), b.size());
+      const std::string_view av = std::string_view(a).substr(a_digits);
+      const std::string_view bv = std::string_view(b).substr(b_digits);
+      if (av.size() != bv.size()) return av.size() < bv.size();
+      if (av != bv) return av < bv;
+    }
+    return a < b;
+  }
+};
+
+/// Separators of the readable and of the minified syntax.
+struct dot_syntax {
+  std::string_view indent;
+  std::string_view newline;
+  std::string_view space;
+  std::string_view equals;
+  std::string_view comma;
+  std::string_view arrow;
+  bool quote_all;
+};
+
+inline constexpr dot_syntax k_readable{"  ", "\n", " ", " = ", ", ", " -> ", true};
+inline constexpr dot_syntax k_minified{"", "", "", "=", ",", "->", false};
+
+/// True if `v` is a DOT ID that needs no quotes: a non-keyword identifier or a number.
+inline bool is_plain_id(std::string_view v) {
+  if (v.empty()) return false;
+  const auto alpha = [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+  };
+  const auto digit = [](char c) { return c >= '0' && c <= '9'; };
+  if (alpha(v.front())) {
+    if (!std::all_of(v.begin(), v.end(), [&](char c) { return alpha(c) || digit(c); })) {
+      return false;
+    }
+    std::string lower(v);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c; });
+    return lower != "node" && lower != "edge" && lower != "graph" && lower != "digraph" &&
+           lower != "subgraph" && lower != "strict";
+  }
+  std::string_view num = v.front() == '-' ? v.substr(1) : v;
+  const std::size_t dots = static_cast<std::size_t>(std::count(num.begin(), num.end(), '.'));
+  return dots <= 1 && num.size() > dots &&
+         std::all_of(num.begin(), num.end(), [&](char c) { return c == '.' || digit(c); });
+}
+
+/// An attribute value, quoted unless the syntax allows a plain ID.
+inline std::string dot_value(const std::string& v, const dot_syntax& syntax) {
+  if (!syntax.quote_all && is_plain_id(v)) return v;
+  return "\"" + escape_dot(v) + "\"";
+}
+
+/// `[k = "v", ...]` without the entries equal to a hoisted default; empty if none remain.
+inline std::string attribute_text(const attr_list& attrs, const attr_list& defaults,
+                                  const dot_syntax& syntax) {
+  std::string out;
+  for (const auto& [k, v] : attrs) {
+    if (is_default(defaults, k, v)) continue;
+    out += out.empty() ? "[" : syntax.comma;
+    out += k;
+    out += syntax.equals;
+    out += dot_value(v, syntax);
+  }
+  if (!out.empty()) out += "]";
+  return out;
+}
+
+}  // namespace render_dot_detail
+
 /**
- * @brief Convert an attribute vector into a lookup map.
+ * @brief Layout hints and budgets for `render_dot`.
  *
- * This convenience helper is used by the simple emitter logic in this file
- * to perform presence checks and indexed lookups. It is intentionally
- * straightforward and trades a small amount of work for code clarity.
+ * All options are off by default, which reproduces the plain output. Each
+ * one trades fidelity to the IR for less work in Graphviz `dot`:
+ *
+ * - `rank_by_level` writes a `rank = same` subgraph per `ir_attrs::k_level`
+ *   value (see `bdd_level_attributor`), so `dot` does not solve the ranking,
+ *   and drops `level` from the node attributes.
+ * - `duplicate_sinks` writes a separate copy of every node without children
+ *   and with at least that many incoming edges (the 0/1 terminals of a BDD)
+ *   per incoming edge, which removes the long edges that dominate crossing
+ *   minimization. Copies are named `<name>_<k>` and share their attributes
+ *   through the `node [...]` defaults of an anonymous subgraph.
+ * - `hoist_defaults` writes the most common value of attributes every node
+ *   (edge) has once as a `node [...]` (`edge [...]`) default and omits it
+ *   from the elements.
+ * - `splines`, `nslimit`, `nslimit1` and `mclimit` are written as graph
+ *   attributes when set; they bound edge routing and the network simplex and
+ *   mincross iterations.
+ * - `minified` names nodes with `compact_id`, drops optional whitespace and
+ *   leaves values unquoted where DOT allows it. It changes the text only.
+ * - `threads` formats the nodes and edges in chunks on up to that many
+ *   threads (see `write_chunked`); the output does not depend on it.
  */
-// Attributes are stored as `ir_attr_map` in the IR; helpers are not needed.
+struct dot_options {
+  bool rank_by_level = false;
+  std::size_t duplicate_sinks = 0;  ///< Minimum in-degree of duplicated sinks; 0 disables
+  bool hoist_defaults = false;
+  std::string splines;  ///< e.g. `line`, `polyline`, `false`; empty for the Graphviz default
+  double nslimit = 0.0;   ///< 0 for the Graphviz default
+  double nslimit1 = 0.0;  ///< 0 for the Graphviz default
+  double mclimit = 0.0;   ///< 0 for the Graphviz default
+  bool minified = false;
+  unsigned threads = 1;
 
-}  // namespace render_dot_detail
+  /// All hints on, straight edges and reduced iteration budgets.
+  static dot_options fast() {
+    dot_options o;
+    o.rank_by_level = true;
+    o.duplicate_sinks = 2;
+    o.hoist_defaults = true;
+    o.splines = "line";
+    o.nslimit = 2.0;
+    o.nslimit1 = 2.0;
+    o.mclimit = 0.5;
+    return o;
+  }
+};
 
-// Writes a GraphViz DOT representation of `g` to `os`.
-// `graph_name` is used as the DOT graph identifier.
-inline void render_dot(std::ostream& os, const ir_graph& g, std::string_view graph_name = "G") {
-  os << "digraph " << graph_name << " {\n";
+/**
+ * @brief Write a GraphViz DOT representation of `g` to `os` with layout hints.
+ *
+ * `graph_name` is used as the DOT graph identifier.
+ */
+inline void render_dot(std::ostream& os, const ir_graph& g, const dot_options& options,
+                       std::string_view graph_name = "G") {
+  const render_dot_detail::dot_syntax& syntax =
+      options.minified ? render_dot_detail::k_minified : render_dot_detail::k_readable;
+  const std::string_view indent = syntax.indent;
+  const std::string_view nl = syntax.newline;
+  const std::string_view sp = syntax.space;
+  os << "digraph " << graph_name << sp << "{" << nl;
 
   // Emit default rankdir only if the graph-level attributes do not provide one.
   if (!g.global_attrs.count(ir_attrs::k_rankdir)) {
-    os << "  rankdir=TB;\n";  // default top-to-bottom layout
+    os << indent << "rankdir=TB;" << nl;  // default top-to-bottom layout
+  }
+
+  // Global graph attributes (map known keys) in lexicographic order, then
+  // the layout budgets.
+  auto graph_attribute = [&](std::string_view k, const std::string& v) {
+    os << indent << k << "=" << render_dot_detail::dot_value(v, syntax) << ";" << nl;
+  };
+  for (const auto& k : render_dot_detail::sorted_keys(g.global_attrs)) {
+    graph_attribute(k == ir_attrs::k_graph_label ? "label" : k, g.global_attrs.at(k));
   }
+  if (!options.splines.empty()) graph_attribute("splines", options.splines);
+  if (options.nslimit > 0.0) graph_attribute("nslimit", std::format("{}", options.nslimit));
+  if (options.nslimit1 > 0.0) graph_attribute("nslimit1", std::format("{}", options.nslimit1));
+  if (options.mclimit > 0.0) graph_attribute("mclimit", std::format("{}", options.mclimit));
 
-  // First, emit global graph attributes (map known keys) in lexicographic order
-  if (!g.global_attrs.empty()) {
-    std::vector<std::string_view> gkeys;
-    gkeys.reserve(g.global_attrs.size());
-    std::transform(g.global_attrs.begin(), g.global_attrs.end(), std::back_inserter(gkeys),
-                   [](auto const& p) { return p.first; });
-    std::sort(gkeys.begin(), gkeys.end(), [](std::string_view a, std::string_view b) {
-      return std::string_view(a) < std::string_view(b);
+  const bool drop_level = options.rank_by_level;
+  attr_list node_defaults;
+  attr_list edge_defaults;
+  if (options.hoist_defaults) {
+    node_defaults = common_attributes(g.nodes.size(), [&](std::size_t i) {
+      return render_dot_detail::node_attributes(g.nodes[i], drop_level);
+    });
+    edge_defaults = common_attributes(g.edges.size(), [&](std::size_t i) {
+      return render_dot_detail::edge_attributes(g.edges[i]);
     });
-    for (const auto& k : gkeys) {
-      const auto& v = g.global_attrs.at(k);
-      if (k == ir_attrs::k_graph_label) {
-        os << "  label=\"" << render_dot_detail::escape_dot(v) << "\";\n";
-      } else {
-        os << "  " << k << "=\"" << render_dot_detail::escape_dot(v) << "\";\n";
-      }
+    if (!node_defaults.empty()) {
+      os << indent << "node" << sp << render_dot_detail::attribute_text(node_defaults, {}, syntax)
+         << ";" << nl;
+    }
+    if (!edge_defaults.empty()) {
+      os << indent << "edge" << sp << render_dot_detail::attribute_text(edge_defaults, {}, syntax)
+         << ";" << nl;
     }
   }
 
-  std::unordered_map<std::uint64_t, std::string> name_map;
-  // Gather node names for use in edge emission.
+  // Sinks with enough parents to be written once per incoming edge.
+  std::unordered_map<std::uint64_t, std::size_t> copies;
+  if (options.duplicate_sinks > 0) {
+    std::unordered_map<std::uint64_t, bool> has_children;
+    for (const auto& e : g.edges) {
+      ++copies[e.target];
+      has_children[e.source] = true;
+    }
+    std::erase_if(copies, [&](const auto& c) {
+      return c.second < options.duplicate_sinks || has_children.count(c.first);
+    });
+  }
 
-  // Emit nodes
-  for (const auto& n : g.nodes) {
-    // Attribute map from node
+  // Node names, by position and (for edges) by id; duplicated sinks keep the
+  // base name of their copies. Rank subgraphs list the names per level.
+  std::vector<std::string> node_names(g.nodes.size());
+  std::unordered_map<std::uint64_t, std::string_view> name_map;
+  auto copy_name = [](std::string_view base, std::size_t k) {
+    return base.back() == '"' ? std::format("{}_{}\"", base.substr(0, base.size() - 1), k)
+                              : std::format("{}_{}", base, k);
+  };
+  std::map<std::string, std::vector<std::string>, render_dot_detail::level_less> ranks;
+  for (std::size_t i = 0; i < g.nodes.size(); ++i) {
+    const ir_node& n = g.nodes[i];
     const auto& amap = n.attributes;
 
-    // Determine the node identifier: prefer attribute "name", then fall back
-    // to a generated id. We also populate a printable label via k_label.
-    // Prefer canonical `k_id` as the stable node identifier; for
-    // historical compatibility also accept a literal "name" attribute.
+    // Prefer canonical `k_id` as the stable node identifier; for historical
+    // compatibility also accept a literal "name" attribute. Names provided by
+    // a policy are escaped and quoted so arbitrary strings remain valid DOT
+    // identifiers; generated names (n{id}) stay unquoted to preserve the
+    // historical emission format. Minified output numbers the nodes instead.
     const bool has_explicit_name = amap.count(ir_attrs::k_id) || amap.count("name");
-    const std::string raw_node_name =
-        has_explicit_name ? (amap.count(ir_attrs::k_id) ? amap.at(ir_attrs::k_id) : amap.at("name"))
-                          : std::format("n{}", n.id);
-    // If the node name was provided by a policy, escape and quote it so
-    // arbitrary strings remain valid DOT identifiers. If the renderer
-    // generated the name (n{id}), keep it unquoted to preserve the
-    // historical emission format (tests and tools often expect unquoted ids).
-    const std::string node_name =
-        has_explicit_name ? std::format("\"{}\"", render_dot_detail::escape_dot(raw_node_name))
-                          : raw_node_name;
+    std::string& node_name = node_names[i];
+    if (options.minified) {
+      node_name = compact_id(i);
+    } else if (has_explicit_name) {
+      const std::string& raw =
+          amap.count(ir_attrs::k_id) ? amap.at(ir_attrs::k_id) : amap.at("name");
+      node_name = std::format("\"{}\"", render_dot_detail::escape_dot(raw));
+    } else {
+      node_name = std::format("n{}", n.id);
+    }
     name_map[n.id] = node_name;
 
-    // Ensure label: prefer k_label, then generated id
-    std::string label =
-        amap.count(ir_attrs::k_label) ? amap.at(ir_attrs::k_label) : std::format("{}", n.id);
+    if (!options.rank_by_level) continue;
+    auto level = amap.find(ir_attrs::k_level);
+    if (level == amap.end()) continue;
+    std::vector<std::string>& rank = ranks[level->second];
+    if (auto copy = copies.find(n.id); copy != copies.end()) {
+      for (std::size_t k = 0; k < copy->second; ++k) rank.push_back(copy_name(node_name, k));
+    } else {
+      rank.push_back(node_name);
+    }
+  }
+
+  // Emit nodes
+  write_chunked(os, g.nodes.size(), options.threads, [&](std::ostream& out, std::size_t i) {
+    const ir_node& n = g.nodes[i];
+    const std::string& node_name = node_names[i];
 
-    // Work from a local mutable copy when applying defaults so we don't mutate the
-    // const attribute map stored on the node.
-    auto local = amap;
-    if (!local.count(ir_attrs::k_style)) {
-      local[ir_attrs::k_style] = "filled";
+    // Emit attributes in lexicographic order for deterministic output; the
+    // label comes first.
+    const std::string attrs = render_dot_detail::attribute_text(
+        render_dot_detail::node_attributes(n, drop_level), node_defaults, syntax);
+    auto copy = copies.find(n.id);
+    if (copy == copies.end()) {
+      out << indent << node_name << (attrs.empty() ? "" : sp) << attrs << ";" << nl;
+      return;
     }
+    // Copies share their attributes as defaults of an anonymous subgraph.
+    out << indent << "{";
+    if (!attrs.empty()) out << sp << "node" << sp << attrs << ";";
+    for (std::size_t k = 0; k < copy->second; ++k) out << sp << copy_name(node_name, k) << ";";
+    out << sp << "}" << nl;
+  });
 
-    // Emit node using the possibly-updated local map. Emit attributes in
-    // lexicographic order for deterministic output. Label is emitted first.
-    os << "  " << node_name << " [";
-    os << "label = \"" << render_dot_detail::escape_dot(label) << "\"";
-    if (!local.empty()) {
-      std::vector<std::string_view> keys;
-      keys.reserve(local.size());
-      std::transform(local.begin(), local.end(), std::back_inserter(keys),
-                     [](auto const& p) { return p.first; });
-      std::sort(keys.begin(), keys.end(),
-                [](std::string_view a, std::string_view b) { return a < b; });
-      for (const auto& k : keys) {
-        if (k == ir_attrs::k_label) continue;
-        if (k == ir_attrs::k_id) {
-          os << ", name = \"" << render_dot_detail::escape_dot(local.at(k)) << "\"";
-          continue;
-        }
-        // Avoid emitting a literal "name" attribute if we've already emitted
-        // the canonical id as `name` above. This prevents duplicate `name`
-        // attributes when both `k_id` and a historical `"name"` key exist.
-        if (k == ir_attrs::k_name) continue;
-        os << ", " << k << " = \"" << render_dot_detail::escape_dot(local.at(k)) << "\"";
-      }
+  // Copy of its target each edge leads to, numbered in edge order.
+  std::vector<std::size_t> copy_of_edge;
+  if (!copies.empty()) {
+    std::unordered_map<std::uint64_t, std::size_t> next_copy;
+    copy_of_edge.resize(g.edges.size());
+    for (std::size_t i = 0; i < g.edges.size(); ++i) {
+      if (copies.count(g.edges[i].target)) copy_of_edge[i] = next_copy[g.edges[i].target]++;
     }
-    os << "];\n";
   }
 
   // Emit edges (use previously computed name_map for identifiers)
-  for (const auto& e : g.edges) {
-    const std::string src = name_map.at(e.source);
-    const std::string dst = name_map.at(e.target);
-
-    const auto& amap = e.attributes;
-
-    os << "  " << src << " -> " << dst;
-    if (!amap.empty()) {
-      os << " [";
-      bool first = true;
-      if (amap.count(ir_attrs::k_label)) {
-        os << "label = \"" << render_dot_detail::escape_dot(amap.at(ir_attrs::k_label)) << "\"";
-        first = false;
-      }
-      std::vector<std::string_view> keys;
-      keys.reserve(amap.size());
-      std::transform(amap.begin(), amap.end(), std::back_inserter(keys),
-                     [](auto const& p) { return p.first; });
-      std::sort(keys.begin(), keys.end(),
-                [](std::string_view a, std::string_view b) { return a < b; });
-      for (const auto& k : keys) {
-        if (k == ir_attrs::k_label) continue;
-        if (!first) os << ", ";
-        first = false;
-        os << k << " = \"" << render_dot_detail::escape_dot(amap.at(k)) << "\"";
-      }
-      os << "]";
+  write_chunked(os, g.edges.size(), options.threads, [&](std::ostream& out, std::size_t i) {
+    const ir_edge& e = g.edges[i];
+    const std::string_view src = name_map.at(e.source);
+    const std::string_view dst = name_map.at(e.target);
+    const std::string attrs = render_dot_detail::attribute_text(
+        render_dot_detail::edge_attributes(e), edge_defaults, syntax);
+    out << indent << src << syntax.arrow;
+    if (copies.count(e.target)) {
+      out << copy_name(dst, copy_of_edge[i]);
+    } else {
+      out << dst;
     }
-    os << ";\n";
+    out << (attrs.empty() ? "" : sp) << attrs << ";" << nl;
+  });
+
+  // Rank constraints, one subgraph per level.
+  for (const auto& [level, names] : ranks) {
+    os << indent << "{" << sp << "rank" << syntax.equals << "same;";
+    for (const auto& name : names) os << sp << name << ";";
+    os << sp << "}" << nl;
   }
 
   os << "}\n";
 }
 
+// Writes a GraphViz DOT representation of `g` to `os`.
+// `graph_name` is used as the DOT graph identifier.
+inline void render_dot(std::ostream& os, const ir_graph& g, std::string_view graph_name = "G") {
+  render_dot(os, g, dot_options{}, graph_name);
+}
+
 }  // namespace dagir
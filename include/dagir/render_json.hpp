@@ -24,8 +24,11 @@
 #include <cerrno>
 #include <charconv>
 #include <cstdlib>
+#include <dagir/chunked_output.hpp>
 #include <dagir/ir.hpp>
 #include <dagir/ir_attrs.hpp>
+#include <dagir/ir_compact.hpp>
+#include <format>
 #include <iomanip>
 #include <map>
 #include <optional>
@@ -33,6 +36,8 @@
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace dagir {
 
@@ -114,13 +119,58 @@ inline std::optional<std::string> try_emit_primitive(const std::string& s) {
   return std::nullopt;
 }
 
-/**
- * @brief Convert an attribute vector to a map for easier lookup.
- */
-// Attributes are now stored as `ir_attr_map`; conversion helper removed.
+/// A JSON value: a primitive where `s` parses as one, otherwise a string.
+inline std::string json_value(const std::string& s) {
+  if (auto prim = try_emit_primitive(s)) return *prim;
+  return "\"" + escape_json_string(s) + "\"";
+}
+
+/// Attributes of a node or edge in lexicographic key order; `k_id` is skipped.
+inline attr_list sorted_attributes(const ir_attr_map& m) {
+  attr_list out;
+  out.reserve(m.size());
+  for (const auto& [k, v] : m) {
+    if (k != ir_attrs::k_id) out.emplace_back(k, v);
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+/// Members `"k": v, ...` of `attrs` without the entries equal to a hoisted default.
+inline std::string members(const attr_list& attrs, const attr_list& defaults,
+                           std::string_view comma, std::string_view colon) {
+  std::string out;
+  for (const auto& [k, v] : attrs) {
+    if (is_default(defaults, k, v)) continue;
+    if (!out.empty()) out += comma;
+    out += "\"" + escape_json_string(std::string(k)) + "\"";
+    out += colon;
+    out += json_value(v);
+  }
+  return out;
+}
 
 }  // namespace render_json_detail
 
+/**
+ * @brief Output compaction for `render_json`.
+ *
+ * - `hoist_defaults` writes the most common value of attributes every node
+ *   (edge) carries once, in a leading `"defaults": {"node": {...}, "edge":
+ *   {...}}` object, and omits it from the elements; readers apply the
+ *   defaults to every element. Elements left without attributes have no
+ *   `attributes` member.
+ * - `minified` drops optional whitespace and replaces node ids with
+ *   `compact_id` numbers.
+ * - `threads` formats the nodes and edges in chunks on up to that many
+ *   threads (see `write_chunked`); the output does not depend on it.
+ */
+struct json_options {
+  bool hoist_defaults = false;
+  bool minified = false;
+  unsigned threads = 1;
+};
+
 /**
  * @brief Render `ir_graph` as JSON to the provided output stream.
  *
@@ -132,102 +182,91 @@ inline std::optional<std::string> try_emit_primitive(const std::string& s) {
  *
  * @param os Stream to write JSON to.
  * @param g The intermediate representation to serialize.
+ * @param options Defaults hoisting, minification and threads.
  */
-inline void render_json(std::ostream& os, const ir_graph& g) {
-  os << "{";
+inline void render_json(std::ostream& os, const ir_graph& g, const json_options& options) {
+  using render_json_detail::escape_json_string;
+  const std::string_view comma = options.minified ? "," : ", ";
+  const std::string_view colon = options.minified ? ":" : ": ";
+  auto key = [&](std::string_view k) { return std::format("\"{}\"{}", k, colon); };
 
-  // nodes
-  os << "\"nodes\": [";
-  bool first_node = true;
-  for (const auto& n : g.nodes) {
-    if (!first_node) os << ", ";
-    first_node = false;
-    os << "{";
-    // Prefer attribute "name" as the node identifier; fall back to numeric id.
-    const auto& amap = n.attributes;
-    if (amap.count("name"))
-      os << "\"id\": \"" << render_json_detail::escape_json_string(amap.at("name")) << "\"";
-    else
-      os << "\"id\": \"" << render_json_detail::escape_json_string(std::to_string(n.id)) << "\"";
-    // Emit label from attributes if present
-    if (amap.count(ir_attrs::k_label)) {
-      os << ", \"label\": \"" << render_json_detail::escape_json_string(amap.at(ir_attrs::k_label))
-         << "\"";
-    }
-    if (!n.attributes.empty()) {
-      os << ", \"attributes\": {";
-      bool first_attr = true;
-      std::vector<std::string> keys;
-      keys.reserve(n.attributes.size());
-      std::transform(n.attributes.begin(), n.attributes.end(), std::back_inserter(keys),
-                     [](auto const& p) { return std::string(p.first); });
-      std::sort(keys.begin(), keys.end());
-      for (const auto& k : keys) {
-        if (k == ir_attrs::k_id) continue;
+  os << "{";
 
-        if (!first_attr) os << ", ";
-        first_attr = false;
-        const auto& val = n.attributes.at(k);
-        os << "\"" << render_json_detail::escape_json_string(k) << "\": ";
-        if (auto prim = render_json_detail::try_emit_primitive(val)) {
-          os << *prim;
-        } else {
-          os << "\"" << render_json_detail::escape_json_string(val) << "\"";
-        }
+  attr_list node_defaults;
+  attr_list edge_defaults;
+  if (options.hoist_defaults) {
+    node_defaults = common_attributes(g.nodes.size(), [&](std::size_t i) {
+      return render_json_detail::sorted_attributes(g.nodes[i].attributes);
+    });
+    edge_defaults = common_attributes(g.edges.size(), [&](std::size_t i) {
+      return render_json_detail::sorted_attributes(g.edges[i].attributes);
+    });
+    if (!node_defaults.empty() || !edge_defaults.empty()) {
+      os << key("defaults") << "{";
+      if (!node_defaults.empty()) {
+        os << key("node") << "{"
+           << render_json_detail::members(node_defaults, {}, comma, colon) << "}";
+      }
+      if (!edge_defaults.empty()) {
+        if (!node_defaults.empty()) os << comma;
+        os << key("edge") << "{"
+           << render_json_detail::members(edge_defaults, {}, comma, colon) << "}";
       }
-      os << "}";
+      os << "}" << comma;
     }
-    os << "}";
   }
-  os << "]";
 
-  // edges
-  os << ", \"edges\": [";
-  bool first_edge = true;
-  for (const auto& e : g.edges) {
-    if (!first_edge) os << ", ";
-    first_edge = false;
-    os << "{";
-    // For edges, attempt to use node `name` where available. Look up the
-    // nodes by id in the graph to find their names; fall back to numeric id.
-    auto find_node_name = [&](std::uint64_t nid) -> std::string {
-      auto it = std::find_if(g.nodes.begin(), g.nodes.end(),
-                             [&](const ir_node& nn) { return nn.id == nid; });
-      if (it != g.nodes.end()) {
-        const auto& aam = it->attributes;
-        if (aam.count("name")) return aam.at("name");
-        return std::to_string(it->id);
-      }
-      return std::to_string(nid);
-    };
+  // Node identifiers: prefer attribute "name"; fall back to numeric id.
+  std::unordered_map<std::uint64_t, std::string> name_map;
+  for (std::size_t i = 0; i < g.nodes.size(); ++i) {
+    const auto& amap = g.nodes[i].attributes;
+    name_map.try_emplace(g.nodes[i].id, options.minified ? compact_id(i)
+                                        : amap.count("name") ? amap.at("name")
+                                                             : std::to_string(g.nodes[i].id));
+  }
+  auto node_name = [&](std::uint64_t nid) {
+    auto it = name_map.find(nid);
+    return it != name_map.end() ? it->second : std::to_string(nid);
+  };
 
-    os << "\"source\": \"" << render_json_detail::escape_json_string(find_node_name(e.source))
-       << "\",";
-    os << " \"target\": \"" << render_json_detail::escape_json_string(find_node_name(e.target))
-       << "\"";
-    if (!e.attributes.empty()) {
-      os << ", \"attributes\": {";
-      bool first_attr = true;
-      std::vector<std::string> keys;
-      keys.reserve(e.attributes.size());
-      std::transform(e.attributes.begin(), e.attributes.end(), std::back_inserter(keys),
-                     [](auto const& p) { return std::string(p.first); });
-      std::sort(keys.begin(), keys.end());
-      for (const auto& k : keys) {
-        if (!first_attr) os << ", ";
-        first_attr = false;
-        const auto& val = e.attributes.at(k);
-        os << "\"" << render_json_detail::escape_json_string(k) << "\": ";
-        if (auto prim = render_json_detail::try_emit_primitive(val)) {
-          os << *prim;
-        } else {
-          os << "\"" << render_json_detail::escape_json_string(val) << "\"";
-        }
-      }
-      os << "}";
+  // Writes `"attributes": {...}` when the element has attributes left to write.
+  auto write_attributes = [&](std::ostream& out, const ir_attr_map& amap,
+                              const attr_list& defaults) {
+    const std::string body = render_json_detail::members(
+        render_json_detail::sorted_attributes(amap), defaults, comma, colon);
+    if (options.hoist_defaults ? !body.empty() : !amap.empty()) {
+      out << comma << key("attributes") << "{" << body << "}";
     }
-    os << "}";
-  }
+  };
+
+  // nodes
+  os << key("nodes") << "[";
+  write_chunked(os, g.nodes.size(), options.threads, [&](std::ostream& out, std::size_t i) {
+    const ir_node& n = g.nodes[i];
+    if (i > 0) out << comma;
+    const std::string id = options.minified          ? compact_id(i)
+                           : n.attributes.count("name") ? n.attributes.at("name")
+                                                        : std::to_string(n.id);
+    out << "{" << key("id") << "\"" << escape_json_string(id) << "\"";
+    if (n.attributes.count(ir_attrs::k_label)) {
+      out << comma << key("label") << "\""
+          << escape_json_string(n.attributes.at(ir_attrs::k_label)) << "\"";
+    }
+    write_attributes(out, n.attributes, node_defaults);
+    out << "}";
+  });
+  os << "]";
+
+  // edges
+  os << comma << key("edges") << "[";
+  write_chunked(os, g.edges.size(), options.threads, [&](std::ostream& out, std::size_t i) {
+    const ir_edge& e = g.edges[i];
+    if (i > 0) out << comma;
+    out << "{" << key("source") << "\"" << escape_json_string(node_name(e.source)) << "\""
+        << comma << key("target") << "\"" << escape_json_string(node_name(e.target)) << "\"";
+    write_attributes(out, e.attributes, edge_defaults);
+    out << "}";
+  });
   os << "]";
 
   // `ir_graph` does not currently contain roots; the JSON schema allows
@@ -236,28 +275,21 @@ inline void render_json(std::ostream& os, const ir_graph& g) {
 
   // optional graphAttributes - emit remaining global_attrs not handled as keys
   if (!g.global_attrs.empty()) {
-    os << ", \"graphAttributes\": {";
-    bool first_ga = true;
-    std::vector<std::string> gkeys;
-    gkeys.reserve(g.global_attrs.size());
-    std::transform(g.global_attrs.begin(), g.global_attrs.end(), std::back_inserter(gkeys),
-                   [](auto const& p) { return std::string(p.first); });
-    std::sort(gkeys.begin(), gkeys.end());
-    for (const auto& k : gkeys) {
-      if (!first_ga) os << ", ";
-      first_ga = false;
-      const auto& v = g.global_attrs.at(k);
-      os << "\"" << render_json_detail::escape_json_string(k) << "\": ";
-      if (auto prim = render_json_detail::try_emit_primitive(v)) {
-        os << *prim;
-      } else {
-        os << "\"" << render_json_detail::escape_json_string(v) << "\"";
-      }
-    }
-    os << "}";
+    attr_list globals(g.global_attrs.begin(), g.global_attrs.end());
+    std::sort(globals.begin(), globals.end());
+    os << comma << key("graphAttributes") << "{"
+       << render_json_detail::members(globals, {}, comma, colon) << "}";
   }
 
   os << "}";
 }
 
+/**
+ * @brief Render `ir_graph` as JSON to the provided output stream.
+ *
+ * @param os Stream to write JSON to.
+ * @param g The intermediate representation to serialize.
+ */
+inline void render_json(std::ostream& os, const ir_graph& g) { render_json(os, g, json_options{}); }
+
 }  // namespace dagir
@@ -15,8 +15,10 @@
 #pragma once
 
 #include <algorithm>
+#include <dagir/chunked_output.hpp>
 #include <dagir/ir.hpp>
 #include <dagir/ir_attrs.hpp>
+#include <dagir/ir_compact.hpp>
 #include <format>
 #include <iterator>
 #include <numeric>
@@ -65,23 +67,59 @@ inline std::string escape_mermaid(const std::string& s) {
   return out;
 }
 
+/// Mermaid style of a node (`fill:...,stroke:...`), empty if it has none.
+inline std::string node_style(const ir_attr_map& amap) {
+  std::vector<std::string> parts;
+  if (amap.count(ir_attrs::k_fill_color)) {
+    parts.push_back(std::format("fill:{}", amap.at(ir_attrs::k_fill_color)));
+  }
+  if (amap.count(ir_attrs::k_color)) {
+    parts.push_back(std::format("stroke:{}", amap.at(ir_attrs::k_color)));
+  }
+  if (amap.count(ir_attrs::k_pen_width)) {
+    parts.push_back(std::format("stroke-width:{}", amap.at(ir_attrs::k_pen_width)));
+  }
+  std::sort(parts.begin(), parts.end());
+  std::string out;
+  for (const auto& p : parts) {
+    if (!out.empty()) out += ",";
+    out += p;
+  }
+  return out;
+}
+
+}  // namespace render_mermaid_detail
+
 /**
- * @brief Convert IR attribute vector to a lookup map.
+ * @brief Output compaction for `render_mermaid`.
  *
- * Convenience helper to simplify attribute lookup when emitting nodes/edges.
+ * - `hoist_defaults` writes every node style shared by several nodes once,
+ *   as `classDef s<k> ...`, and assigns it with one `class a,b,... s<k>`
+ *   line instead of a `style` line per node.
+ * - `minified` drops indentation and the spaces around arrows and replaces
+ *   node ids with `compact_id` numbers.
+ * - `threads` formats the nodes and edges in chunks on up to that many
+ *   threads (see `write_chunked`); the output does not depend on it.
  */
-// Attributes are now stored as `ir_attr_map`; helper removed.
-
-}  // namespace render_mermaid_detail
+struct mermaid_options {
+  bool hoist_defaults = false;
+  bool minified = false;
+  unsigned threads = 1;
+};
 
 /**
  * @brief Render `ir_graph` as a Mermaid `graph` to `os`.
  *
  * @param os Output stream to write Mermaid syntax to.
  * @param g The intermediate representation to render.
+ * @param options Defaults hoisting, minification and threads.
  * @param graph_name Optional identifier for the graph (used in comments only).
  */
-inline void render_mermaid(std::ostream& os, const ir_graph& g, std::string_view graph_name = "G") {
+inline void render_mermaid(std::ostream& os, const ir_graph& g, const mermaid_options& options,
+                           std::string_view graph_name = "G") {
+  const std::string_view indent = options.minified ? "" : "  ";
+  const std::string_view sp = options.minified ? "" : " ";
+
   // Ensure consistent appearance on platforms (e.g. GitHub) that may
   // apply a dark theme to Mermaid renderings. Emit an init directive
   // to request the default (light) Mermaid theme so node fill/stroke
@@ -95,27 +133,50 @@ inline void render_mermaid(std::ostream& os, const ir_graph& g, std::string_view
   // Mermaid requires `graph <dir>` where <dir> is TB, LR, etc.
   os << "graph " << rankdir << "\n";
 
-  // Emit title if provided (deterministic: check sorted keys)
-  if (!g.global_attrs.empty()) {
-    std::vector<std::string> gkeys;
-    gkeys.reserve(g.global_attrs.size());
-    std::transform(g.global_attrs.begin(), g.global_attrs.end(), std::back_inserter(gkeys),
-                   [](auto const& p) { return std::string(p.first); });
-    std::sort(gkeys.begin(), gkeys.end());
-    bool found_title = false;
-    for (const auto& k : gkeys) {
-      if (k == std::string(ir_attrs::k_graph_label)) {
-        os << "  title " << render_mermaid_detail::escape_mermaid(g.global_attrs.at(k)) << "\n";
-        found_title = true;
-      }
+  // Emit title if provided
+  if (auto title = g.global_attrs.find(ir_attrs::k_graph_label); title != g.global_attrs.end()) {
+    os << indent << "title " << render_mermaid_detail::escape_mermaid(title->second) << "\n";
+    os << render_mermaid_detail::escape_mermaid(std::string(graph_name)) << "\n";
+  }
+
+  // Prefer attribute "name" for the identifier used in edges and styles.
+  auto position_name = [&](std::size_t i) {
+    const ir_node& n = g.nodes[i];
+    return options.minified           ? compact_id(i)
+           : n.attributes.count("name") ? n.attributes.at("name")
+                                        : std::format("n{}", n.id);
+  };
+  std::unordered_map<std::uint64_t, std::string> name_map;
+  for (std::size_t i = 0; i < g.nodes.size(); ++i) {
+    name_map.try_emplace(g.nodes[i].id, position_name(i));
+  }
+
+  // Styles shared by several nodes become classes, in order of first use.
+  std::vector<std::string> styles;  // by position, when hoisting
+  std::unordered_map<std::string, std::size_t> style_uses;
+  std::vector<std::pair<std::string, std::string>> classes;  // (style, members)
+  if (options.hoist_defaults) {
+    styles.reserve(g.nodes.size());
+    for (const auto& n : g.nodes) {
+      styles.push_back(render_mermaid_detail::node_style(n.attributes));
+      if (!styles.back().empty()) ++style_uses[styles.back()];
     }
-    if (found_title) {
-      os << render_mermaid_detail::escape_mermaid(std::string(graph_name)) << "\n";
+    std::erase_if(style_uses, [](const auto& u) { return u.second < 2; });
+    std::unordered_map<std::string, std::size_t> class_of;
+    for (std::size_t i = 0; i < g.nodes.size(); ++i) {
+      if (!style_uses.count(styles[i])) continue;
+      auto [it, inserted] = class_of.try_emplace(styles[i], classes.size());
+      if (inserted) {
+        classes.emplace_back(styles[i], position_name(i));
+      } else {
+        classes[it->second].second += "," + position_name(i);
+      }
     }
   }
 
   // Emit nodes. Mermaid syntax for a node with a box is: n1[Label]
-  for (const auto& n : g.nodes) {
+  write_chunked(os, g.nodes.size(), options.threads, [&](std::ostream& out, std::size_t i) {
+    const ir_node& n = g.nodes[i];
     const auto& amap = n.attributes;
 
     // Determine label: prefer k_label, then id
@@ -139,54 +200,52 @@ inline void render_mermaid(std::ostream& os, const ir_graph& g, std::string_view
       }
     }
 
-    // Prefer attribute "name" for the identifier used in edges and styles.
-    std::string node_name = amap.count("name") ? amap.at("name") : std::format("n{}", n.id);
-    os << "  " << node_name << opening << '"' << render_mermaid_detail::escape_mermaid(label) << '"'
-       << closing << "\n";
-
-    // Emit simple style directive if fill or stroke is provided
-    if (amap.count(ir_attrs::k_fill_color) || amap.count(ir_attrs::k_color) ||
-        amap.count(ir_attrs::k_pen_width)) {
-      std::vector<std::string> parts;
-      if (amap.count(ir_attrs::k_fill_color))
-        parts.push_back(std::format("fill:{}", amap.at(ir_attrs::k_fill_color)));
-      if (amap.count(ir_attrs::k_color))
-        parts.push_back(std::format("stroke:{}", amap.at(ir_attrs::k_color)));
-      if (amap.count(ir_attrs::k_pen_width))
-        parts.push_back(std::format("stroke-width:{}", amap.at(ir_attrs::k_pen_width)));
-      if (!parts.empty()) {
-        std::sort(parts.begin(), parts.end());
-        os << "  style " << node_name << " " << parts[0];
-        for (size_t i = 1; i < parts.size(); ++i) os << "," << parts[i];
-        os << "\n";
-      }
+    const std::string node_name = position_name(i);
+    out << indent << node_name << opening << '"' << render_mermaid_detail::escape_mermaid(label)
+        << '"' << closing << "\n";
+
+    // Emit simple style directive if fill or stroke is provided and not
+    // assigned through a class
+    const std::string style =
+        options.hoist_defaults ? styles[i] : render_mermaid_detail::node_style(amap);
+    if (!style.empty() && !style_uses.count(style)) {
+      out << indent << "style " << node_name << " " << style << "\n";
     }
+  });
+  for (std::size_t k = 0; k < classes.size(); ++k) {
+    os << indent << "classDef s" << k << " " << classes[k].first << "\n";
+    os << indent << "class " << classes[k].second << " s" << k << "\n";
   }
 
   // Emit edges. Mermaid edge label syntax: A -- "label" --> B
-  for (const auto& e : g.edges) {
-    auto find_node_name = [&](std::uint64_t nid) -> std::string {
-      auto it = std::find_if(g.nodes.begin(), g.nodes.end(),
-                             [&](const ir_node& nn) { return nn.id == nid; });
-      if (it != g.nodes.end()) {
-        const auto& a = it->attributes;
-        if (a.count("name")) return a.at("name");
-        return std::format("n{}", it->id);
-      }
-      return std::format("n{}", nid);
-    };
-
+  auto find_node_name = [&](std::uint64_t nid) -> std::string {
+    auto it = name_map.find(nid);
+    return it != name_map.end() ? it->second : std::format("n{}", nid);
+  };
+  write_chunked(os, g.edges.size(), options.threads, [&](std::ostream& out, std::size_t i) {
+    const ir_edge& e = g.edges[i];
     const std::string src = find_node_name(e.source);
     const std::string dst = find_node_name(e.target);
     const auto& amap = e.attributes;
     if (amap.count(ir_attrs::k_label)) {
-      os << "  " << src << " -- \""
-         << render_mermaid_detail::escape_mermaid(amap.at(ir_attrs::k_label)) << "\" --> " << dst
-         << "\n";
+      out << indent << src << sp << "--" << sp << "\""
+          << render_mermaid_detail::escape_mermaid(amap.at(ir_attrs::k_label)) << "\"" << sp
+          << "-->" << sp << dst << "\n";
     } else {
-      os << "  " << src << " --> " << dst << "\n";
+      out << indent << src << sp << "-->" << sp << dst << "\n";
     }
-  }
+  });
+}
+
+/**
+ * @brief Render `ir_graph` as a Mermaid `graph` to `os`.
+ *
+ * @param os Output stream to write Mermaid syntax to.
+ * @param g The intermediate representation to render.
+ * @param graph_name Optional identifier for the graph (used in comments only).
+ */
+inline void render_mermaid(std::ostream& os, const ir_graph& g, std::string_view graph_name = "G") {
+  render_mermaid(os, g, mermaid_options{}, graph_name);
 }
 
 }  // namespace dagir
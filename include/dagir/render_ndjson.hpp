@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @brief Header-only newline-delimited JSON (NDJSON) renderer for `dagir::ir_graph`.
+ *
+ * `render_json` writes one document that a consumer must hold and parse in
+ * full. This renderer writes one self-contained JSON object per line instead,
+ * so consumers can process a graph incrementally, `split` it across workers
+ * or feed it to log pipelines:
+ *
+ * - `{"type": "graph", "attributes": {...}}` first, if the graph has
+ *   global attributes;
+ * - `{"type": "node", "id": ..., "label": ..., "attributes": {...}}` per
+ *   node, in IR order;
+ * - `{"type": "edge", "source": ..., "target": ..., "attributes": {...}}`
+ *   per edge, after all nodes.
+ *
+ * Ids, labels and attribute values are written exactly as `render_json`
+ * writes them (numbers, booleans and `null` as JSON primitives). Lines use
+ * no optional whitespace.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/ir_attrs.hpp>
+#include <dagir/ir_compact.hpp>
+#include <dagir/render_json.hpp>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace dagir {
+
+/**
+ * @brief Render `g` as NDJSON to `os`: one graph, node or edge object per line.
+ */
+inline void render_ndjson(std::ostream& os, const ir_graph& g) {
+  using render_json_detail::escape_json_string;
+  auto attributes = [&](const ir_attr_map& amap) {
+    const std::string body = render_json_detail::members(
+        render_json_detail::sorted_attributes(amap), attr_list{}, ",", ":");
+    if (!body.empty()) os << ",\"attributes\":{" << body << "}";
+  };
+
+  if (!g.global_attrs.empty()) {
+    os << "{\"type\":\"graph\"";
+    attributes(g.global_attrs);
+    os << "}\n";
+  }
+
+  // Prefer attribute "name" as the node identifier; fall back to numeric id.
+  std::unordered_map<std::uint64_t, std::string> name_map;
+  for (const auto& n : g.nodes) {
+    const std::string id =
+        n.attributes.count("name") ? n.attributes.at("name") : std::to_string(n.id);
+    name_map.try_emplace(n.id, id);
+    os << "{\"type\":\"node\",\"id\":\"" << escape_json_string(id) << "\"";
+    if (auto label = n.attributes.find(ir_attrs::k_label); label != n.attributes.end()) {
+      os << ",\"label\":\"" << escape_json_string(label->second) << "\"";
+    }
+    attributes(n.attributes);
+    os << "}\n";
+  }
+
+  auto endpoint = [&](std::uint64_t id) {
+    auto it = name_map.find(id);
+    return escape_json_string(it != name_map.end() ? it->second : std::to_string(id));
+  };
+  for (const auto& e : g.edges) {
+    os << "{\"type\":\"edge\",\"source\":\"" << endpoint(e.source) << "\",\"target\":\""
+       << endpoint(e.target) << "\"";
+    attributes(e.attributes);
+    os << "}\n";
+  }
+}
+
+}  // namespace dagir
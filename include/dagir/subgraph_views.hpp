@@ -0,0 +1,321 @@
+/**
+ * @file subgraph_views.hpp
+ * @brief View adaptors selecting a subgraph of any `read_only_dag_view`.
+ *
+ * @details
+ * Rendering a whole 500k-node BDD is rarely useful. The adaptors below wrap a
+ * view (without copying it) and themselves model `read_only_dag_view`, so
+ * `build_ir`, the renderers and the algorithms only ever touch the selected
+ * nodes. They compose: each adaptor accepts another adaptor as its base.
+ *
+ * - `subgraph_view` keeps the nodes accepted by a predicate; edges into
+ *   rejected nodes are dropped while children are enumerated.
+ * - `depth_limited_view` keeps the nodes within `max_depth` edges of the
+ *   roots; nodes at the limit are shown without children. Minimum depths are
+ *   found by a breadth-first search that stops at the limit, so the cost is
+ *   bounded by the selected subgraph.
+ * - `cone_view` keeps the cone of influence of a set of seed nodes: either
+ *   everything below them (`fan_out`, optionally depth limited) or everything
+ *   above them (`fan_in`). The fan-in needs parent links, so it builds a
+ *   `parents_index` of the base view once.
+ *
+ * Handles and edges are those of the base view. Every adaptor converts
+ * implicitly to the innermost wrapped view (`root()`), so attribute policies
+ * written for a library view, e.g. `cudd_node_attributor`, accept adapted
+ * views unchanged. Base views must outlive the adaptors.
+ *
+ * SPDX-License-Identifier: MIT
+ * © DagIR Contributors. All rights reserved.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dagir/concepts/read_only_dag_view.hpp"
+#include "dagir/parents_index.hpp"
+
+namespace dagir {
+
+namespace subgraph_detail {
+
+/// Innermost view of a (possibly nested) adaptor.
+template <class V>
+struct root_of {
+  using type = V;
+  static const V& get(const V& v) noexcept { return v; }
+};
+
+template <class V>
+  requires requires { typename V::root_view_type; }
+struct root_of<V> {
+  using type = typename V::root_view_type;
+  static const type& get(const V& v) noexcept { return v.root(); }
+};
+
+template <class View>
+using handle_t = typename View::handle;
+
+template <class View>
+using edge_t = std::ranges::range_value_t<decltype(std::declval<const View&>().children(
+    std::declval<const handle_t<View>&>()))>;
+
+template <class H, class E>
+H target_of(const E& e) {
+  if constexpr (std::convertible_to<E, H>) {
+    return static_cast<H>(e);
+  } else {
+    return e.target();
+  }
+}
+
+/// Copy of the base view's children (needed when the base returns a temporary).
+template <class View>
+std::vector<edge_t<View>> children_of(const View& view, const handle_t<View>& h) {
+  std::vector<edge_t<View>> out;
+  for (auto const& e : view.children(h)) out.push_back(e);
+  return out;
+}
+
+/// Minimum depth below `seeds` of every node within `max_depth` edges.
+template <class View>
+std::unordered_map<std::uint64_t, std::size_t> bounded_depths(
+    const View& view, const std::vector<handle_t<View>>& seeds, std::size_t max_depth) {
+  using H = handle_t<View>;
+  std::unordered_map<std::uint64_t, std::size_t> depth;
+  std::vector<H> frontier;
+  for (const H& s : seeds) {
+    if (depth.try_emplace(s.stable_key(), 0).second) frontier.push_back(s);
+  }
+  for (std::size_t d = 0; d < max_depth && !frontier.empty(); ++d) {
+    std::vector<H> next;
+    for (const H& h : frontier) {
+      for (auto const& e : view.children(h)) {
+        const H c = target_of<H>(e);
+        if (depth.try_emplace(c.stable_key(), d + 1).second) next.push_back(c);
+      }
+    }
+    frontier = std::move(next);
+  }
+  return depth;
+}
+
+/**
+ * @brief Members and forwarding shared by all adaptors.
+ */
+template <class View>
+class adaptor_base {
+ public:
+  using handle = handle_t<View>;
+  using base_view_type = View;
+  using root_view_type = typename root_of<View>::type;
+
+  explicit adaptor_base(const View& base) noexcept : base_(&base) {}
+
+  /// Wrapped view.
+  const View& base() const noexcept { return *base_; }
+
+  /// Innermost wrapped view.
+  const root_view_type& root() const noexcept { return root_of<View>::get(*base_); }
+  operator const root_view_type&() const noexcept { return root(); }
+
+  /// Forwarded traversal guard, if the base view has one.
+  auto start_guard(const handle& h) const
+    requires requires(const View& v, const handle& hh) { v.start_guard(hh); }
+  {
+    return base_->start_guard(h);
+  }
+
+ protected:
+  const View* base_;
+};
+
+}  // namespace subgraph_detail
+
+/**
+ * @brief Subgraph of the nodes accepted by `keep(handle) -> bool`.
+ *
+ * Roots rejected by the predicate are dropped, as are edges into rejected
+ * nodes; nothing is evaluated before traversal reaches it.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ */
+template <dagir::concepts::read_only_dag_view View, class Predicate>
+class subgraph_view : public subgraph_detail::adaptor_base<View> {
+ public:
+  using typename subgraph_detail::adaptor_base<View>::handle;
+
+  subgraph_view(const View& base, Predicate keep)
+      : subgraph_detail::adaptor_base<View>(base), keep_(std::move(keep)) {}
+
+  std::vector<subgraph_detail::edge_t<View>> children(const handle& h) const {
+    std::vector<subgraph_detail::edge_t<View>> out;
+    for (auto const& e : this->base_->children(h)) {
+      if (keep_(subgraph_detail::target_of<handle>(e))) out.push_back(e);
+    }
+    return out;
+  }
+
+  std::vector<handle> roots() const {
+    std::vector<handle> out;
+    for (auto const& r : this->base_->roots()) {
+      const handle h = r;
+      if (keep_(h)) out.push_back(h);
+    }
+    return out;
+  }
+
+ private:
+  Predicate keep_;
+};
+
+/**
+ * @brief The nodes within `max_depth` edges of the roots of `base`.
+ *
+ * Depth is the length of the shortest path from any root. Nodes at depth
+ * `max_depth` are leaves of the adapted view; `is_truncated` tells whether
+ * such a node had children in the base view.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ */
+template <dagir::concepts::read_only_dag_view View>
+class depth_limited_view : public subgraph_detail::adaptor_base<View> {
+ public:
+  using typename subgraph_detail::adaptor_base<View>::handle;
+
+  depth_limited_view(const View& base, std::size_t max_depth)
+      : subgraph_detail::adaptor_base<View>(base), max_depth_(max_depth) {
+    for (auto const& r : base.roots()) roots_.push_back(r);
+    depth_ = subgraph_detail::bounded_depths(base, roots_, max_depth);
+  }
+
+  std::vector<subgraph_detail::edge_t<View>> children(const handle& h) const {
+    if (depth(h) >= max_depth_) return {};
+    return subgraph_detail::children_of(*this->base_, h);
+  }
+
+  const std::vector<handle>& roots() const noexcept { return roots_; }
+
+  /// Shortest distance from a root; `max_depth + 1` for nodes outside the view.
+  std::size_t depth(const handle& h) const {
+    auto it = depth_.find(h.stable_key());
+    return it == depth_.end() ? max_depth_ + 1 : it->second;
+  }
+
+  /// True if `h` is at the depth limit and has children in the base view.
+  bool is_truncated(const handle& h) const {
+    if (depth(h) != max_depth_) return false;
+    return !std::ranges::empty(this->base_->children(h));
+  }
+
+  /// Number of nodes in the view.
+  std::size_t size() const noexcept { return depth_.size(); }
+
+ private:
+  std::size_t max_depth_;
+  std::vector<handle> roots_;
+  std::unordered_map<std::uint64_t, std::size_t> depth_;
+};
+
+/// Direction of a cone of influence.
+enum class cone_direction : std::uint8_t {
+  fan_out,  ///< Seeds and their descendants
+  fan_in    ///< Seeds and their ancestors
+};
+
+/**
+ * @brief Cone of influence of a set of seed nodes.
+ *
+ * - `fan_out`: roots are the seeds, children are unchanged. With a depth
+ *   limit, nodes more than `max_depth` edges below every seed are cut as in
+ *   `depth_limited_view`.
+ * - `fan_in`: the seeds and every node with a path of at most `max_depth`
+ *   edges to a seed, keeping the edges between them. Roots are the selected
+ *   nodes without a selected parent.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ */
+template <dagir::concepts::read_only_dag_view View>
+class cone_view : public subgraph_detail::adaptor_base<View> {
+ public:
+  using typename subgraph_detail::adaptor_base<View>::handle;
+  static constexpr std::size_t k_unlimited = std::numeric_limits<std::size_t>::max();
+
+  cone_view(const View& base, std::vector<handle> seeds,
+            cone_direction direction = cone_direction::fan_out,
+            std::size_t max_depth = k_unlimited)
+      : subgraph_detail::adaptor_base<View>(base), direction_(direction), max_depth_(max_depth) {
+    if (direction == cone_direction::fan_out) {
+      roots_ = std::move(seeds);
+      if (max_depth != k_unlimited) {
+        depth_ = subgraph_detail::bounded_depths(base, roots_, max_depth);
+      }
+      return;
+    }
+
+    // Fan-in: breadth-first over the parents, at most `max_depth` levels.
+    const parents_index<View> index(base);
+    std::vector<handle> frontier;
+    std::vector<handle> members;
+    for (const handle& s : seeds) {
+      if (index.contains(s) && depth_.try_emplace(s.stable_key(), 0).second) {
+        frontier.push_back(s);
+        members.push_back(s);
+      }
+    }
+    for (std::size_t d = 0; d < max_depth && !frontier.empty(); ++d) {
+      std::vector<handle> next;
+      for (const handle& h : frontier) {
+        for (const auto& p : index.parents(h)) {
+          if (depth_.try_emplace(p.target().stable_key(), d + 1).second) {
+            next.push_back(p.target());
+            members.push_back(p.target());
+          }
+        }
+      }
+      frontier = std::move(next);
+    }
+    for (const handle& m : members) {
+      bool has_selected_parent = false;
+      for (const auto& p : index.parents(m)) {
+        if (depth_.contains(p.target().stable_key())) {
+          has_selected_parent = true;
+          break;
+        }
+      }
+      if (!has_selected_parent) roots_.push_back(m);
+    }
+  }
+
+  std::vector<subgraph_detail::edge_t<View>> children(const handle& h) const {
+    if (direction_ == cone_direction::fan_out) {
+      if (max_depth_ != k_unlimited) {
+        auto it = depth_.find(h.stable_key());
+        if (it == depth_.end() || it->second >= max_depth_) return {};
+      }
+      return subgraph_detail::children_of(*this->base_, h);
+    }
+    std::vector<subgraph_detail::edge_t<View>> out;
+    for (auto const& e : this->base_->children(h)) {
+      if (depth_.contains(subgraph_detail::target_of<handle>(e).stable_key())) out.push_back(e);
+    }
+    return out;
+  }
+
+  const std::vector<handle>& roots() const noexcept { return roots_; }
+
+ private:
+  cone_direction direction_;
+  std::size_t max_depth_;
+  std::vector<handle> roots_;
+  std::unordered_map<std::uint64_t, std::size_t> depth_;  // distance from the seeds
+};
+
+}  // namespace dagir
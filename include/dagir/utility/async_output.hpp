@@ -0,0 +1,537 @@
+/**
+ * @file async_output.hpp
+ * @brief Output stream that writes on a background thread.
+ *
+ * @details
+ * A renderer writing straight to a file alternates between formatting and
+ * waiting for the disk. `async_ostream` is a `std::ostream`, so it plugs into
+ * `render_dot`, `render_json`, `render_mermaid` and the other renderers
+ * unchanged, but its buffer is a ring of `async_output_options::buffers`
+ * fixed-size buffers: the renderer fills one while a dedicated writer thread
+ * drains the full ones, so formatting and I/O overlap. With the default two
+ * buffers this is plain double buffering; more buffers absorb bursty disks.
+ * The calling thread only blocks when every buffer is full.
+ *
+ * The writer thread sends the buffers through an optional gzip stage
+ * (`gzip`, available when built with `DAGIR_HAS_ZLIB` and linked against
+ * zlib) to either a target `std::ostream` or a file. Files can be opened with
+ * `O_DIRECT` (`direct_io`, Linux only) to bypass the page cache: buffers are
+ * aligned to `k_output_alignment` and, unless the stream is flushed early,
+ * every write but the last covers whole blocks. The final partial block is
+ * written after clearing `O_DIRECT`, and file systems that reject it fall
+ * back to buffered writes.
+ *
+ * Errors on the writer thread put the stream into `badbit` and are rethrown
+ * by `close()`. A target stream must not be used by anyone else until the
+ * `async_ostream` is closed.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <streambuf>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(DAGIR_HAS_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace dagir {
+namespace utility {
+
+/// Alignment and size granularity of the output buffers (the `O_DIRECT` block size).
+inline constexpr std::size_t k_output_alignment = 4096;
+
+/// Whether `async_output_options::gzip` is supported by this build.
+#if defined(DAGIR_HAS_ZLIB)
+inline constexpr bool k_async_output_gzip = true;
+#else
+inline constexpr bool k_async_output_gzip = false;
+#endif
+
+/**
+ * @brief Buffering, file and compression settings of an `async_ostream`.
+ */
+struct async_output_options {
+  /// Bytes per buffer, rounded up to a multiple of `k_output_alignment`.
+  std::size_t buffer_size = std::size_t{1} << 20;
+  /// Buffers in the ring (at least 2).
+  std::size_t buffers = 2;
+  /// Open files with `O_DIRECT` (Linux; ignored elsewhere and for streams).
+  bool direct_io = false;
+  /// Compress the output to gzip on the writer thread.
+  bool gzip = false;
+  /// zlib compression level, 0-9.
+  int gzip_level = 6;
+};
+
+namespace async_output_detail {
+
+struct aligned_delete {
+  void operator()(char* p) const noexcept {
+    ::operator delete[](p, std::align_val_t{k_output_alignment});
+  }
+};
+
+using aligned_buffer = std::unique_ptr<char[], aligned_delete>;
+
+inline aligned_buffer make_aligned_buffer(std::size_t size) {
+  return aligned_buffer(
+      static_cast<char*>(::operator new[](size, std::align_val_t{k_output_alignment})));
+}
+
+/// Destination of the writer thread; `flush` is called when the stream is synced and
+/// `finish` once after the last write.
+class sink {
+ public:
+  virtual ~sink() = default;
+  virtual void write(std::span<const char> data) = 0;
+  virtual void flush() {}
+  virtual void finish() {}
+};
+
+/// Writes to a caller-owned stream.
+class stream_sink final : public sink {
+ public:
+  explicit stream_sink(std::ostream& os) : os_(os) {}
+
+  void write(std::span<const char> data) override {
+    os_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!os_) throw std::ios_base::failure("async_ostream: write to the target stream failed");
+  }
+
+  void flush() override {
+    os_.flush();
+    if (!os_) throw std::ios_base::failure("async_ostream: flushing the target stream failed");
+  }
+
+  void finish() override { flush(); }
+
+ private:
+  std::ostream& os_;
+};
+
+/// Writes to a file through `std::ofstream`.
+class file_sink final : public sink {
+ public:
+  explicit file_sink(const std::filesystem::path& path) : path_(path) {
+    out_.rdbuf()->pubsetbuf(nullptr, 0);  // the ring buffers are large already
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+      throw std::filesystem::filesystem_error("async_ostream: cannot open output file", path,
+                                              std::make_error_code(std::errc::io_error));
+    }
+  }
+
+  void write(std::span<const char> data) override {
+    out_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out_) fail();
+  }
+
+  void flush() override {
+    out_.flush();
+    if (!out_) fail();
+  }
+
+  void finish() override {
+    out_.close();
+    if (!out_) fail();
+  }
+
+ private:
+  [[noreturn]] void fail() const {
+    throw std::filesystem::filesystem_error("async_ostream: write to output file failed", path_,
+                                            std::make_error_code(std::errc::io_error));
+  }
+
+  std::ofstream out_;
+  std::filesystem::path path_;
+};
+
+#if defined(__linux__)
+/// Writes to a file descriptor opened with `O_DIRECT` where the file system allows it.
+class direct_file_sink final : public sink {
+ public:
+  explicit direct_file_sink(const std::filesystem::path& path) : path_(path) {
+    constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+    if (fd_ < 0 && errno == EINVAL) {
+      fd_ = ::open(path.c_str(), flags, 0644);
+      direct_ = false;
+    }
+    if (fd_ < 0) fail("async_ostream: cannot open output file");
+  }
+
+  ~direct_file_sink() override {
+    if (fd_ >= 0) ::close(fd_);
+  }
+
+  direct_file_sink(const direct_file_sink&) = delete;
+  direct_file_sink& operator=(const direct_file_sink&) = delete;
+
+  void write(std::span<const char> data) override {
+    while (!data.empty()) {
+      // O_DIRECT needs aligned addresses and lengths; anything else (the tail,
+      // a buffer handed over by an early flush, a short write) switches to
+      // buffered writes for the rest of the file.
+      if (direct_ && (data.size() % k_output_alignment != 0 ||
+                      reinterpret_cast<std::uintptr_t>(data.data()) % k_output_alignment != 0)) {
+        if (::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) & ~O_DIRECT) < 0) {
+          fail("async_ostream: cannot clear O_DIRECT");
+        }
+        direct_ = false;
+      }
+      const ::ssize_t n = ::write(fd_, data.data(), data.size());
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        fail("async_ostream: write to output file failed");
+      }
+      data = data.subspan(static_cast<std::size_t>(n));
+    }
+  }
+
+  void finish() override {
+    const int fd = std::exchange(fd_, -1);
+    if (::close(fd) < 0) fail("async_ostream: closing output file failed");
+  }
+
+ private:
+  [[noreturn]] void fail(const char* what) const {
+    throw std::filesystem::filesystem_error(what, path_,
+                                            std::error_code(errno, std::generic_category()));
+  }
+
+  int fd_ = -1;
+  bool direct_ = true;
+  std::filesystem::path path_;
+};
+#endif
+
+#if defined(DAGIR_HAS_ZLIB)
+/// Compresses to gzip and passes full, aligned output buffers on to `next`.
+class gzip_sink final : public sink {
+ public:
+  gzip_sink(std::unique_ptr<sink> next, int level, std::size_t buffer_size)
+      : next_(std::move(next)), out_(make_aligned_buffer(buffer_size)), size_(buffer_size) {
+    if (deflateInit2(&zs_, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw std::invalid_argument("async_ostream: bad gzip level");
+    }
+    reset_output();
+  }
+
+  ~gzip_sink() override { deflateEnd(&zs_); }
+
+  gzip_sink(const gzip_sink&) = delete;
+  gzip_sink& operator=(const gzip_sink&) = delete;
+
+  void write(std::span<const char> data) override {
+    zs_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs_.avail_in = static_cast<uInt>(data.size());
+    while (zs_.avail_in != 0) deflate_step(Z_NO_FLUSH);
+  }
+
+  /// Ends the current deflate block so that everything written so far can be
+  /// decompressed; frequent flushes cost some compression.
+  void flush() override {
+    for (;;) {
+      if (deflate(&zs_, Z_SYNC_FLUSH) == Z_STREAM_ERROR) {
+        throw std::runtime_error("async_ostream: gzip compression failed");
+      }
+      if (zs_.avail_out != 0) break;
+      next_->write({out_.get(), size_});
+      reset_output();
+    }
+    if (zs_.avail_out != size_) {
+      next_->write({out_.get(), size_ - zs_.avail_out});
+      reset_output();
+    }
+    next_->flush();
+  }
+
+  void finish() override {
+    while (deflate_step(Z_FINISH) != Z_STREAM_END) {
+    }
+    if (zs_.avail_out != size_) next_->write({out_.get(), size_ - zs_.avail_out});
+    next_->finish();
+  }
+
+ private:
+  int deflate_step(int flush) {
+    const int rc = deflate(&zs_, flush);
+    if (rc == Z_STREAM_ERROR) throw std::runtime_error("async_ostream: gzip compression failed");
+    if (zs_.avail_out == 0) {
+      next_->write({out_.get(), size_});
+      reset_output();
+    }
+    return rc;
+  }
+
+  void reset_output() {
+    zs_.next_out = reinterpret_cast<Bytef*>(out_.get());
+    zs_.avail_out = static_cast<uInt>(size_);
+  }
+
+  std::unique_ptr<sink> next_;
+  aligned_buffer out_;
+  std::size_t size_;
+  z_stream zs_{};
+};
+#endif
+
+}  // namespace async_output_detail
+
+/**
+ * @brief Stream buffer that hands full buffers to a writer thread.
+ *
+ * `sync()` (e.g. `std::flush`) hands over the partial buffer, waits until
+ * everything written so far has reached the destination and flushes the
+ * destination; gzip output is flushed with `Z_SYNC_FLUSH`, so the data written
+ * so far decompresses even before the stream is closed.
+ */
+class async_output_buffer : public std::streambuf {
+ public:
+  /// Write to `target`, which must outlive the buffer.
+  async_output_buffer(std::ostream& target, const async_output_options& options)
+      : async_output_buffer(std::make_unique<async_output_detail::stream_sink>(target), options) {}
+
+  /// Write to a new or truncated file at `path`.
+  /// @throws std::filesystem::filesystem_error If the file cannot be opened.
+  async_output_buffer(const std::filesystem::path& path, const async_output_options& options)
+      : async_output_buffer(open_file(path, options), options) {}
+
+  ~async_output_buffer() override {
+    try {
+      close();
+    } catch (...) {  // errors are only reported by close()
+    }
+  }
+
+  async_output_buffer(const async_output_buffer&) = delete;
+  async_output_buffer& operator=(const async_output_buffer&) = delete;
+
+  /**
+   * @brief Write out everything, stop the writer thread and finish the destination.
+   *
+   * Further output fails. Idempotent.
+   *
+   * @throws The first error of the writer thread or of finishing the destination.
+   */
+  void close() {
+    if (!writer_.joinable()) return;
+    submit(false);
+    {
+      std::lock_guard lock(mutex_);
+      closing_ = true;
+    }
+    changed_.notify_all();
+    writer_.join();
+    setp(nullptr, nullptr);
+    if (!error_) {
+      try {
+        sink_->finish();
+      } catch (...) {
+        error_ = std::current_exception();
+      }
+    }
+    if (error_) std::rethrow_exception(error_);
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (!submit(true)) return traits_type::eof();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char_type* s, std::streamsize count) override {
+    std::streamsize written = 0;
+    while (written < count) {
+      if (pptr() == epptr() && !submit(true)) break;
+      const auto n = std::min<std::streamsize>(count - written, epptr() - pptr());
+      std::memcpy(pptr(), s + written, static_cast<std::size_t>(n));
+      pbump(static_cast<int>(n));
+      written += n;
+    }
+    return written;
+  }
+
+  int sync() override {
+    if (!writer_.joinable()) return 0;
+    if (!submit(true)) return -1;
+    std::unique_lock lock(mutex_);
+    changed_.wait(lock, [&] { return (queue_.empty() && !busy_) || error_; });
+    if (error_) return -1;
+    // The writer is idle and only this thread queues buffers, so the sink is ours.
+    try {
+      sink_->flush();
+    } catch (...) {
+      error_ = std::current_exception();
+      return -1;
+    }
+    return 0;
+  }
+
+ private:
+  async_output_buffer(std::unique_ptr<async_output_detail::sink> sink,
+                      const async_output_options& options)
+      : sink_(std::move(sink)),
+        size_(std::max<std::size_t>(1, (options.buffer_size + k_output_alignment - 1) /
+                                           k_output_alignment) *
+              k_output_alignment) {
+    const std::size_t count = std::max<std::size_t>(2, options.buffers);
+    if (options.gzip) {
+#if defined(DAGIR_HAS_ZLIB)
+      sink_ = std::make_unique<async_output_detail::gzip_sink>(std::move(sink_),
+                                                               options.gzip_level, size_);
+#else
+      throw std::invalid_argument("async_ostream: gzip output requires DAGIR_HAS_ZLIB");
+#endif
+    }
+    buffers_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      buffers_.push_back(async_output_detail::make_aligned_buffer(size_));
+      if (i > 0) free_.push_back(i);
+    }
+    setp(buffers_[0].get(), buffers_[0].get() + size_);
+    writer_ = std::thread([this] { write_loop(); });
+  }
+
+  static std::unique_ptr<async_output_detail::sink> open_file(
+      const std::filesystem::path& path, const async_output_options& options) {
+#if defined(__linux__)
+    if (options.direct_io) return std::make_unique<async_output_detail::direct_file_sink>(path);
+#else
+    (void)options;
+#endif
+    return std::make_unique<async_output_detail::file_sink>(path);
+  }
+
+  /// Queue the current buffer if it holds data; with `next`, start a free one.
+  bool submit(bool next) {
+    const auto used = static_cast<std::size_t>(pptr() - pbase());
+    std::unique_lock lock(mutex_);
+    if (error_ || closing_) return false;
+    if (used == 0 && next) return true;
+    if (used != 0) {
+      queue_.emplace_back(current_, used);
+      changed_.notify_all();
+    }
+    if (!next) return true;
+    changed_.wait(lock, [&] { return !free_.empty() || error_; });
+    if (error_) return false;
+    current_ = free_.back();
+    free_.pop_back();
+    setp(buffers_[current_].get(), buffers_[current_].get() + size_);
+    return true;
+  }
+
+  void write_loop() {
+    std::unique_lock lock(mutex_);
+    for (;;) {
+      changed_.wait(lock, [&] { return !queue_.empty() || closing_; });
+      if (queue_.empty()) return;
+      const auto [index, used] = queue_.front();
+      queue_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        sink_->write({buffers_[index].get(), used});
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      busy_ = false;
+      free_.push_back(index);
+      if (error) {
+        error_ = error;
+        queue_.clear();
+        changed_.notify_all();
+        return;
+      }
+      changed_.notify_all();
+    }
+  }
+
+  std::unique_ptr<async_output_detail::sink> sink_;
+  std::size_t size_;
+  std::vector<async_output_detail::aligned_buffer> buffers_;
+  std::size_t current_ = 0;                              // buffer being filled
+  std::vector<std::size_t> free_;                        // buffers ready to fill
+  std::deque<std::pair<std::size_t, std::size_t>> queue_;  // (buffer, bytes) to write
+  bool busy_ = false;                                    // writer is in `sink_->write`
+  bool closing_ = false;
+  std::exception_ptr error_;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread writer_;
+};
+
+/**
+ * @brief `std::ostream` over an `async_output_buffer`.
+ *
+ * Call `close()` to surface write errors; the destructor closes silently.
+ */
+class async_ostream : public std::ostream {
+ public:
+  /// Write to `target` on a background thread; `target` must outlive this stream.
+  explicit async_ostream(std::ostream& target, const async_output_options& options = {})
+      : std::ostream(nullptr), buf_(target, options) {
+    rdbuf(&buf_);
+  }
+
+  /// Write to a new or truncated file at `path` on a background thread.
+  /// @throws std::filesystem::filesystem_error If the file cannot be opened.
+  explicit async_ostream(const std::filesystem::path& path,
+                         const async_output_options& options = {})
+      : std::ostream(nullptr), buf_(path, options) {
+    rdbuf(&buf_);
+  }
+
+  /// Write out everything and finish the destination; sets `badbit` and rethrows on error.
+  void close() {
+    try {
+      buf_.close();
+    } catch (...) {
+      setstate(std::ios_base::badbit);
+      throw;
+    }
+  }
+
+ private:
+  async_output_buffer buf_;
+};
+
+}  // namespace utility
+}  // namespace dagir
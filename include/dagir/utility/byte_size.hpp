@@ -0,0 +1,63 @@
+/**
+ * @file byte_size.hpp
+ * @brief Parsing of byte counts given on the command line.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace dagir {
+namespace utility {
+
+/**
+ * @brief Parse a byte count with an optional K, M or G suffix (powers of 1024).
+ *
+ * @throws std::invalid_argument If `text` is not a decimal number with an optional suffix.
+ * @throws std::out_of_range If the byte count does not fit in `std::size_t`.
+ */
+inline std::size_t parse_byte_size(std::string_view text) {
+  std::size_t scale = 1;
+  if (!text.empty()) {
+    switch (text.back()) {
+      case 'K':
+      case 'k':
+        scale = std::size_t{1} << 10;
+        break;
+      case 'M':
+      case 'm':
+        scale = std::size_t{1} << 20;
+        break;
+      case 'G':
+      case 'g':
+        scale = std::size_t{1} << 30;
+        break;
+    }
+    if (scale != 1) text.remove_suffix(1);
+  }
+  // from_chars takes no sign or whitespace for unsigned types, so "-1" and " 1" fail too.
+  std::size_t value = 0;
+  const char* const end = text.data() + text.size();
+  const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+  if (ec == std::errc::result_out_of_range ||
+      (ec == std::errc{} && value > std::numeric_limits<std::size_t>::max() / scale)) {
+    throw std::out_of_range("parse_byte_size: byte count too large: " + std::string(text));
+  }
+  if (ec != std::errc{} || ptr != end) {
+    throw std::invalid_argument("parse_byte_size: not a byte count: " + std::string(text));
+  }
+  return value * scale;
+}
+
+}  // namespace utility
+}  // namespace dagir
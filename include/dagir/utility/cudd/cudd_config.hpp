@@ -0,0 +1,274 @@
+/**
+ * @file cudd_config.hpp
+ * @brief Manager tuning, dynamic reordering settings and statistics for CUDD.
+ *
+ * @details
+ * `cudd_config` gathers the CUDD knobs that matter for large expression BDDs:
+ * initial unique-table and cache sizes, a hard memory limit, the automatic
+ * (autodyn) reordering method and its thresholds. `make_cudd_manager` creates
+ * a manager with these settings, `apply_cudd_config` applies the run-time
+ * settings to an existing manager, and `read_cudd_stats` collects peak node
+ * counts, memory and reordering time once a build has finished.
+ * `cudd_concurrent_managers` keeps CUDD's process-wide out-of-memory handler
+ * consistent while several managers run on different threads.
+ *
+ * Every numeric field uses 0 to mean "keep CUDD's default".
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cudd/cudd.h>
+
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/// CUDD's process-wide allocation failure handler (defined in util/safe_mem.c).
+extern "C" void (*MMoutOfMemory)(size_t);
+
+namespace dagir {
+namespace utility {
+
+/**
+ * @brief Construction and run-time settings for a CUDD manager.
+ */
+struct cudd_config {
+  /// Initial number of slots per unique subtable (`Cudd_Init` `numSlots`).
+  /// 0 = `CUDD_UNIQUE_SLOTS`.
+  unsigned int unique_slots = CUDD_UNIQUE_SLOTS;
+
+  /// Initial number of computed-table slots (`Cudd_Init` `cacheSize`). 0 = `CUDD_CACHE_SLOTS`.
+  unsigned int cache_slots = CUDD_CACHE_SLOTS;
+
+  /// Hard memory limit in bytes; operations fail once it is exceeded. 0 = unlimited.
+  std::size_t max_memory = 0;
+
+  /// Autodyn reordering method; `CUDD_REORDER_NONE` disables dynamic reordering.
+  Cudd_ReorderingType reorder_method = CUDD_REORDER_NONE;
+
+  /// Live node count that triggers the first automatic reordering. 0 = default.
+  unsigned int first_reorder_threshold = 0;
+
+  /// Maximum growth allowed while sifting a variable (e.g. 1.2). 0 = default.
+  double max_growth = 0.0;
+
+  /// Maximum number of automatic reorderings. 0 = unlimited.
+  unsigned int max_reorderings = 0;
+
+  /// Run one final reordering with `reorder_method` after the BDD is built.
+  bool reorder_after_build = false;
+};
+
+/**
+ * @brief Statistics read back from a CUDD manager after a build.
+ */
+struct cudd_stats {
+  long live_nodes = 0;            ///< Nodes currently in the unique table
+  long peak_nodes = 0;            ///< Peak number of nodes in the unique table
+  long peak_live_nodes = 0;       ///< Peak number of live (referenced) nodes
+  std::size_t memory_in_use = 0;  ///< Bytes currently allocated by the manager
+  unsigned int reorderings = 0;   ///< Number of reorderings performed
+  long reorder_time_ms = 0;       ///< Total time spent reordering
+};
+
+namespace cudd_config_detail {
+
+inline constexpr std::pair<std::string_view, Cudd_ReorderingType> k_reorder_methods[] = {
+    {"none", CUDD_REORDER_NONE},
+    {"random", CUDD_REORDER_RANDOM},
+    {"random_pivot", CUDD_REORDER_RANDOM_PIVOT},
+    {"sift", CUDD_REORDER_SIFT},
+    {"sift_converge", CUDD_REORDER_SIFT_CONVERGE},
+    {"symm_sift", CUDD_REORDER_SYMM_SIFT},
+    {"symm_sift_conv", CUDD_REORDER_SYMM_SIFT_CONV},
+    {"window2", CUDD_REORDER_WINDOW2},
+    {"window3", CUDD_REORDER_WINDOW3},
+    {"window4", CUDD_REORDER_WINDOW4},
+    {"window2_conv", CUDD_REORDER_WINDOW2_CONV},
+    {"window3_conv", CUDD_REORDER_WINDOW3_CONV},
+    {"window4_conv", CUDD_REORDER_WINDOW4_CONV},
+    {"group_sift", CUDD_REORDER_GROUP_SIFT},
+    {"group_sift_conv", CUDD_REORDER_GROUP_SIFT_CONV},
+    {"annealing", CUDD_REORDER_ANNEALING},
+    {"genetic", CUDD_REORDER_GENETIC},
+    {"linear", CUDD_REORDER_LINEAR},
+    {"linear_converge", CUDD_REORDER_LINEAR_CONVERGE},
+    {"lazy_sift", CUDD_REORDER_LAZY_SIFT},
+    {"exact", CUDD_REORDER_EXACT},
+};
+
+}  // namespace cudd_config_detail
+
+/**
+ * @brief Parse a reordering method name such as `sift`, `symm_sift` or `group_sift`.
+ *
+ * Names are the `CUDD_REORDER_*` suffixes in lower case.
+ * @throws std::invalid_argument If the name is unknown.
+ */
+inline Cudd_ReorderingType parse_cudd_reorder_method(std::string_view name) {
+  for (const auto& [method_name, method] : cudd_config_detail::k_reorder_methods) {
+    if (name == method_name) return method;
+  }
+  throw std::invalid_argument("unknown CUDD reordering method: " + std::string(name));
+}
+
+/**
+ * @brief Name of a reordering method as accepted by `parse_cudd_reorder_method`.
+ */
+inline std::string_view to_string(Cudd_ReorderingType method) noexcept {
+  for (const auto& [method_name, m] : cudd_config_detail::k_reorder_methods) {
+    if (m == method) return method_name;
+  }
+  return "same";
+}
+
+/**
+ * @brief Human-readable description of a CUDD error code.
+ */
+inline std::string_view cudd_error_string(Cudd_ErrorType code) noexcept {
+  switch (code) {
+    case CUDD_NO_ERROR:
+      return "no error";
+    case CUDD_MEMORY_OUT:
+      return "out of memory";
+    case CUDD_TOO_MANY_NODES:
+      return "too many nodes";
+    case CUDD_MAX_MEM_EXCEEDED:
+      return "maximum memory exceeded";
+    case CUDD_TIMEOUT_EXPIRED:
+      return "timeout expired";
+    case CUDD_TERMINATION:
+      return "terminated";
+    case CUDD_INVALID_ARG:
+      return "invalid argument";
+    case CUDD_INTERNAL_ERROR:
+      return "internal error";
+  }
+  return "unknown error";
+}
+
+/**
+ * @brief Apply the run-time settings of `config` to an existing manager.
+ *
+ * Sets the memory limit and the reordering method and thresholds. Table
+ * sizes only take effect through `make_cudd_manager`.
+ */
+inline void apply_cudd_config(DdManager& mgr, const cudd_config& config) {
+  if (config.max_memory != 0) Cudd_SetMaxMemory(&mgr, config.max_memory);
+
+  if (config.reorder_method == CUDD_REORDER_NONE) {
+    Cudd_AutodynDisable(&mgr);
+    return;
+  }
+  Cudd_AutodynEnable(&mgr, config.reorder_method);
+  if (config.first_reorder_threshold != 0) {
+    Cudd_SetNextReordering(&mgr, config.first_reorder_threshold);
+  }
+  if (config.max_growth > 0.0) Cudd_SetMaxGrowth(&mgr, config.max_growth);
+  if (config.max_reorderings != 0) Cudd_SetMaxReorderings(&mgr, config.max_reorderings);
+}
+
+/**
+ * @brief Create a CUDD manager configured by `config`.
+ *
+ * @param num_vars Number of BDD variables to create up front.
+ * @param config Manager settings.
+ * @return Manager owned by the caller; release it with `Cudd_Quit`.
+ * @throws std::runtime_error If CUDD cannot allocate the manager.
+ */
+inline DdManager* make_cudd_manager(unsigned int num_vars, const cudd_config& config) {
+  const unsigned int unique_slots =
+      config.unique_slots != 0 ? config.unique_slots : CUDD_UNIQUE_SLOTS;
+  const unsigned int cache_slots =
+      config.cache_slots != 0 ? config.cache_slots : CUDD_CACHE_SLOTS;
+  DdManager* mgr = Cudd_Init(num_vars, 0, unique_slots, cache_slots, config.max_memory);
+  if (!mgr) throw std::runtime_error("make_cudd_manager: Cudd_Init failed");
+  apply_cudd_config(*mgr, config);
+  return mgr;
+}
+
+/**
+ * @brief Scope in which CUDD managers may run on several threads at once.
+ *
+ * CUDD grows its computed table and unique subtables by saving the global
+ * `MMoutOfMemory` handler, installing the manager's out-of-memory callback
+ * for the allocation and restoring the saved handler. Two managers resizing
+ * at once can restore each other's value, leaving the wrong handler behind.
+ * While at least one scope is alive the global handler is set to
+ * `Cudd_OutOfMemSilent`, the callback every manager uses by default, so each
+ * save and restore sees the same value. The handler is switched under a
+ * mutex and restored when the last scope ends.
+ *
+ * Create the scope on the coordinating thread before starting the workers
+ * and keep it until they are joined. Managers must keep the default
+ * out-of-memory callback.
+ */
+class cudd_concurrent_managers {
+ public:
+  cudd_concurrent_managers() {
+    std::lock_guard lock(mutex());
+    if (active()++ == 0) {
+      saved() = MMoutOfMemory;
+      MMoutOfMemory = Cudd_OutOfMemSilent;
+    }
+  }
+
+  ~cudd_concurrent_managers() {
+    std::lock_guard lock(mutex());
+    if (--active() == 0) MMoutOfMemory = saved();
+  }
+
+  cudd_concurrent_managers(const cudd_concurrent_managers&) = delete;
+  cudd_concurrent_managers& operator=(const cudd_concurrent_managers&) = delete;
+
+ private:
+  static std::mutex& mutex() {
+    static std::mutex m;
+    return m;
+  }
+  static std::size_t& active() {
+    static std::size_t n = 0;
+    return n;
+  }
+  static void (*&saved())(size_t) {
+    static void (*handler)(size_t) = nullptr;
+    return handler;
+  }
+};
+
+/**
+ * @brief Read node, memory and reordering statistics from a manager.
+ */
+inline cudd_stats read_cudd_stats(DdManager& mgr) {
+  cudd_stats stats;
+  stats.live_nodes = Cudd_ReadNodeCount(&mgr);
+  stats.peak_nodes = Cudd_ReadPeakNodeCount(&mgr);
+  stats.peak_live_nodes = Cudd_ReadPeakLiveNodeCount(&mgr);
+  stats.memory_in_use = Cudd_ReadMemoryInUse(&mgr);
+  stats.reorderings = Cudd_ReadReorderings(&mgr);
+  stats.reorder_time_ms = Cudd_ReadReorderingTime(&mgr);
+  return stats;
+}
+
+/**
+ * @brief Write `stats` as `key: value` lines.
+ */
+inline void write_cudd_stats(std::ostream& os, const cudd_stats& stats) {
+  os << "live_nodes: " << stats.live_nodes << "\n"
+     << "peak_nodes: " << stats.peak_nodes << "\n"
+     << "peak_live_nodes: " << stats.peak_live_nodes << "\n"
+     << "memory_in_use: " << stats.memory_in_use << "\n"
+     << "reorderings: " << stats.reorderings << "\n"
+     << "reorder_time_ms: " << stats.reorder_time_ms << "\n";
+}
+
+}  // namespace utility
+}  // namespace dagir
@@ -5,7 +5,11 @@
  * @details
  * This file provides functions to convert expression ASTs defined in
  * `expression_read_only_dag_view.hpp` into CUDD BDD diagrams using a
- * `DdManager`.
+ * `DdManager`. The AST is first lowered to an `expression_program`, which is
+ * then evaluated iteratively: every distinct subexpression is built exactly
+ * once and its intermediate BDD is released as soon as its last user has run.
+ * Associative AND/OR/XOR chains are flattened and their operands combined
+ * according to an `expression_schedule` (smallest first by default).
  *
  * @copyright
  * © DagIR Contributors. All rights reserved.
@@ -16,78 +20,206 @@
 
 #include <cudd/cudd.h>
 
-#include <algorithm>
-#include <cctype>
-#include <dagir/algorithms.hpp>
+#include <cstdint>
+#include <dagir/utility/cudd/cudd_config.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
 #include <dagir/utility/expressions/expression_read_only_dag_view.hpp>
-#include <functional>
+#include <dagir/utility/expressions/expression_schedule.hpp>
+#include <stdexcept>
+#include <stop_token>
 #include <string>
 #include <unordered_map>
-#include <variant>
+#include <vector>
 
 namespace dagir {
 namespace utility {
 
-inline DdNode* convert_expression_to_cudd(DdManager& mgr, const dagir::utility::my_expression& expr,
-                                          std::unordered_map<std::string, int>& var_map) {
-  auto resolve_var = [&](const std::string& name) -> int {
-    auto it = var_map.find(name);
-    if (it != var_map.end()) return it->second;
-    int idx = static_cast<int>(var_map.size());
-    var_map.emplace(name, idx);
-    return idx;
-  };
+namespace cudd_convert_detail {
+
+[[noreturn]] inline void throw_cudd_failure(DdManager& mgr, const std::stop_token& stop) {
+  const Cudd_ErrorType code = Cudd_ReadErrorCode(&mgr);
+  if (code == CUDD_TERMINATION || stop.stop_requested()) throw expression_conversion_cancelled();
+  throw std::runtime_error("convert_expression_to_cudd: CUDD operation failed (" +
+                           std::string(cudd_error_string(code)) + ")");
+}
+
+inline int stop_requested(const void* token) {
+  return static_cast<const std::stop_token*>(token)->stop_requested() ? 1 : 0;
+}
+
+/**
+ * @brief Registers `stop` as the manager's termination callback for its lifetime.
+ */
+class termination_guard {
+ public:
+  termination_guard(DdManager& mgr, const std::stop_token& stop) : mgr_(mgr) {
+    active_ = stop.stop_possible();
+    if (active_) {
+      Cudd_RegisterTerminationCallback(&mgr_, stop_requested,
+                                       const_cast<void*>(static_cast<const void*>(&stop)));
+    }
+  }
+  ~termination_guard() {
+    if (active_) Cudd_UnregisterTerminationCallback(&mgr_);
+  }
+  termination_guard(const termination_guard&) = delete;
+  termination_guard& operator=(const termination_guard&) = delete;
+
+ private:
+  DdManager& mgr_;
+  bool active_ = false;
+};
 
-  struct visitor {
-    DdManager& mgr;
-    std::function<int(const std::string&)> resolve_var;
+}  // namespace cudd_convert_detail
 
-    DdNode* operator()(const my_variable& v) {
-      int idx = resolve_var(v.variable_name);
-      DdNode* var = Cudd_bddIthVar(&mgr, idx);
-      Cudd_Ref(var);
-      return var;
+/**
+ * @brief Evaluate a compiled expression program into a CUDD BDD.
+ *
+ * @param mgr CUDD manager used to create diagrams.
+ * @param program Program produced by `compile_expression`.
+ * @param schedule Combination order for the operands of associative chains.
+ *        `smallest_first` uses `Cudd_DagSize` of the intermediate results.
+ * @param stop Cancellation token. While the conversion runs it is installed as
+ *        the manager's termination callback, so a stop request also aborts a
+ *        long-running CUDD operation.
+ * @return Referenced root node; the caller owns the reference and must
+ *         release it with `Cudd_RecursiveDeref`.
+ * @throws expression_conversion_cancelled If `stop` is triggered.
+ * @throws std::runtime_error If a CUDD operation fails (for example when a
+ *         memory limit is hit). In both cases all intermediate references are
+ *         released.
+ *
+ * Negation uses CUDD's complement edges (`Cudd_Not`) and costs O(1).
+ */
+inline DdNode* convert_expression_to_cudd(
+    DdManager& mgr, const expression_program& program,
+    expression_schedule schedule = expression_schedule::smallest_first,
+    std::stop_token stop = {}) {
+  Cudd_ClearErrorCode(&mgr);
+  const cudd_convert_detail::termination_guard guard(mgr, stop);
+  const expression_chains chains = flatten_chains(program);
+  std::vector<DdNode*> values(program.instructions.size(), nullptr);
+  std::vector<std::uint32_t> remaining = program.use_counts;
+
+  auto release_all = [&]() {
+    for (DdNode*& v : values) {
+      if (v) Cudd_RecursiveDeref(&mgr, v);
+      v = nullptr;
     }
-    DdNode* operator()(const my_and& a) {
-      DdNode* L = std::visit(*this, *a.left);
-      DdNode* R = std::visit(*this, *a.right);
-      DdNode* out = Cudd_bddAnd(&mgr, L, R);
-      Cudd_Ref(out);
-      Cudd_RecursiveDeref(&mgr, L);
-      Cudd_RecursiveDeref(&mgr, R);
-      return out;
+  };
+  auto release = [&](std::uint32_t slot) {
+    if (--remaining[slot] == 0) {
+      Cudd_RecursiveDeref(&mgr, values[slot]);
+      values[slot] = nullptr;
     }
-    DdNode* operator()(const my_or& o) {
-      DdNode* L = std::visit(*this, *o.left);
-      DdNode* R = std::visit(*this, *o.right);
-      DdNode* out = Cudd_bddOr(&mgr, L, R);
-      Cudd_Ref(out);
-      Cudd_RecursiveDeref(&mgr, L);
-      Cudd_RecursiveDeref(&mgr, R);
-      return out;
+  };
+  auto fail = [&]() {
+    release_all();
+    cudd_convert_detail::throw_cudd_failure(mgr, stop);
+  };
+
+  // Combines a flattened chain; every operand carries its own reference.
+  auto reduce = [&](const std::vector<std::uint32_t>& leaves,
+                    DdNode* (*op)(DdManager*, DdNode*, DdNode*)) -> DdNode* {
+    std::vector<DdNode*> operands;
+    operands.reserve(leaves.size());
+    for (std::uint32_t leaf : leaves) {
+      Cudd_Ref(values[leaf]);
+      operands.push_back(values[leaf]);
+      release(leaf);
     }
-    DdNode* operator()(const my_xor& x) {
-      DdNode* L = std::visit(*this, *x.left);
-      DdNode* R = std::visit(*this, *x.right);
-      DdNode* out = Cudd_bddXor(&mgr, L, R);
-      Cudd_Ref(out);
-      Cudd_RecursiveDeref(&mgr, L);
-      Cudd_RecursiveDeref(&mgr, R);
-      return out;
+    auto combine = [&](DdNode* a, DdNode* b) {
+      DdNode* r = stop.stop_requested() ? nullptr : op(&mgr, a, b);
+      if (r) Cudd_Ref(r);
+      Cudd_RecursiveDeref(&mgr, a);
+      Cudd_RecursiveDeref(&mgr, b);
+      if (!r) cudd_convert_detail::throw_cudd_failure(mgr, stop);
+      return r;
+    };
+    auto size = [](DdNode* f) { return static_cast<std::size_t>(Cudd_DagSize(f)); };
+    auto drop = [&](DdNode*& f) { Cudd_RecursiveDeref(&mgr, f); };
+    try {
+      return reduce_chain(std::move(operands), schedule, combine, size, drop);
+    } catch (const std::runtime_error&) {
+      release_all();
+      throw;
     }
-    DdNode* operator()(const my_not& n) {
-      DdNode* D = std::visit(*this, *n.expr);
-      DdNode* out = Cudd_Not(D);
-      // Cudd_Not does not require ref/ deref when applied to referenced nodes,
-      // ensure the returned node is referenced by the caller instead.
-      Cudd_Ref(out);
-      Cudd_RecursiveDeref(&mgr, D);
-      return out;
+  };
+
+  for (std::size_t i = 0; i < program.instructions.size(); ++i) {
+    if (chains.absorbed[i]) continue;
+    const expression_instruction& ins = program.instructions[i];
+    DdNode* out = nullptr;
+    switch (ins.opcode) {
+      case expression_opcode::variable:
+        out = Cudd_bddIthVar(&mgr, static_cast<int>(ins.lhs));
+        break;
+      case expression_opcode::op_not:
+        out = Cudd_Not(values[ins.lhs]);
+        break;
+      case expression_opcode::op_and:
+        values[i] = reduce(chains.operands[i], Cudd_bddAnd);
+        continue;
+      case expression_opcode::op_or:
+        values[i] = reduce(chains.operands[i], Cudd_bddOr);
+        continue;
+      case expression_opcode::op_xor:
+        values[i] = reduce(chains.operands[i], Cudd_bddXor);
+        continue;
     }
-  } vis{mgr, resolve_var};
+    if (!out) fail();
+    Cudd_Ref(out);
+    values[i] = out;
+    if (ins.opcode == expression_opcode::op_not) release(ins.lhs);
+  }
+
+  // The root's use count includes the caller, so its reference survives the loop.
+  return values[program.root];
+}
+
+/**
+ * @brief Evaluate a compiled expression program with a tuned manager.
+ *
+ * Applies the run-time settings of `config` (memory limit, dynamic
+ * reordering) to `mgr`, builds the BDD and, when `config.reorder_after_build`
+ * is set, runs one final reordering with `config.reorder_method`.
+ *
+ * @param mgr CUDD manager, typically created with `make_cudd_manager(config)`.
+ * @param program Program produced by `compile_expression`.
+ * @param config Manager settings to honour.
+ * @param schedule Combination order for the operands of associative chains.
+ * @param stop Cancellation token, see the overload without `config`.
+ * @return Referenced root node owned by the caller.
+ * @throws expression_conversion_cancelled If `stop` is triggered.
+ * @throws std::runtime_error If a CUDD operation or the final reordering fails.
+ */
+inline DdNode* convert_expression_to_cudd(
+    DdManager& mgr, const expression_program& program, const cudd_config& config,
+    expression_schedule schedule = expression_schedule::smallest_first,
+    std::stop_token stop = {}) {
+  apply_cudd_config(mgr, config);
+  DdNode* out = convert_expression_to_cudd(mgr, program, schedule, stop);
+  const cudd_convert_detail::termination_guard guard(mgr, stop);
+  if (config.reorder_after_build && config.reorder_method != CUDD_REORDER_NONE &&
+      !Cudd_ReduceHeap(&mgr, config.reorder_method, 1)) {
+    Cudd_RecursiveDeref(&mgr, out);
+    cudd_convert_detail::throw_cudd_failure(mgr, stop);
+  }
+  return out;
+}
 
-  DdNode* res = std::visit(vis, expr);
-  return res;
+/**
+ * @brief Convert an expression AST into a CUDD BDD.
+ *
+ * @param mgr CUDD manager used to create diagrams.
+ * @param expr Expression AST to convert.
+ * @param var_map Mapping from variable names to CUDD variable indices. Names
+ *        not yet present are assigned sequential indices and added to the map.
+ * @return Referenced root node owned by the caller.
+ */
+inline DdNode* convert_expression_to_cudd(DdManager& mgr, const dagir::utility::my_expression& expr,
+                                          std::unordered_map<std::string, int>& var_map) {
+  return convert_expression_to_cudd(mgr, compile_expression(expr, var_map));
 }
 
 inline DdNode* convert_expression_to_cudd(DdManager& mgr,
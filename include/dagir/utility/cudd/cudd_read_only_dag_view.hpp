@@ -15,6 +15,7 @@
 #include <cudd/cudd.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <dagir/concepts/read_only_dag_view.hpp>
 #include <string>
@@ -91,6 +92,22 @@ class cudd_read_only_dag_view {
 
   static auto start_guard(const handle&) { return dagir::noop_guard{}; }
 
+  // BDD node queries (dagir::concepts::bdd_view). Constants are the one node,
+  // so a complemented constant is false.
+  static bool is_terminal(const handle& h) noexcept { return Cudd_IsConstant(h.ptr); }
+  static bool terminal_value(const handle& h) noexcept { return !Cudd_IsComplement(h.ptr); }
+  static std::size_t variable_index(const handle& h) noexcept {
+    return Cudd_NodeReadIndex(Cudd_Regular(h.ptr));
+  }
+
+  // Variable order (dagir::concepts::ordered_bdd_view).
+  std::size_t variable_count() const noexcept {
+    return mgr_ ? static_cast<std::size_t>(Cudd_ReadSize(mgr_)) : 0;
+  }
+  std::size_t variable_level(std::size_t index) const noexcept {
+    return static_cast<std::size_t>(Cudd_ReadPerm(mgr_, static_cast<int>(index)));
+  }
+
  private:
   DdManager* mgr_ = nullptr;
   const std::vector<std::string>* var_names_ = nullptr;
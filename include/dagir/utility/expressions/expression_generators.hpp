@@ -0,0 +1,93 @@
+/**
+ * @file expression_generators.hpp
+ * @brief Generators for parametric benchmark expressions.
+ *
+ * @details
+ * Produces expression text in the syntax accepted by `parse_expression` for
+ * workloads that are too large to keep as regression files, such as the
+ * N-Queens constraint for boards larger than the ones under
+ * `tests/regression_tests/expressions`.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dagir {
+namespace utility {
+
+/**
+ * @brief Build the N-Queens constraint for an `n` x `n` board.
+ *
+ * Variables are named `q_<row>_<col>` (1-indexed) like the N-Queens
+ * regression expressions. The constraint requires at least one queen per row
+ * and at most one queen per row, column, diagonal and anti-diagonal, so its
+ * models are exactly the N-Queens solutions (92 for `n == 8`, 724 for
+ * `n == 10`).
+ *
+ * @param n Board size; must be at least 1.
+ * @return Expression text suitable for `parse_expression`.
+ * @throws std::invalid_argument If `n` is less than 1.
+ */
+inline std::string make_n_queens_expression(int n) {
+  if (n < 1) throw std::invalid_argument("make_n_queens_expression: n must be at least 1");
+
+  auto q = [](int r, int c) { return std::format("q_{}_{}", r, c); };
+  std::vector<std::string> clauses;
+
+  auto at_most_one = [&](const std::vector<std::string>& cells) {
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+      for (std::size_t j = i + 1; j < cells.size(); ++j) {
+        clauses.push_back(std::format("NOT ({} AND {})", cells[i], cells[j]));
+      }
+    }
+  };
+
+  for (int r = 1; r <= n; ++r) {
+    std::string row = "(" + q(r, 1);
+    for (int c = 2; c <= n; ++c) row += " OR " + q(r, c);
+    clauses.push_back(row + ")");
+  }
+
+  for (int r = 1; r <= n; ++r) {
+    std::vector<std::string> cells;
+    for (int c = 1; c <= n; ++c) cells.push_back(q(r, c));
+    at_most_one(cells);
+  }
+  for (int c = 1; c <= n; ++c) {
+    std::vector<std::string> cells;
+    for (int r = 1; r <= n; ++r) cells.push_back(q(r, c));
+    at_most_one(cells);
+  }
+  // Diagonals are identified by r - c (main) and r + c (anti).
+  for (int d = -(n - 1); d <= n - 1; ++d) {
+    std::vector<std::string> cells;
+    for (int r = 1; r <= n; ++r) {
+      const int c = r - d;
+      if (c >= 1 && c <= n) cells.push_back(q(r, c));
+    }
+    at_most_one(cells);
+  }
+  for (int s = 2; s <= 2 * n; ++s) {
+    std::vector<std::string> cells;
+    for (int r = 1; r <= n; ++r) {
+      const int c = s - r;
+      if (c >= 1 && c <= n) cells.push_back(q(r, c));
+    }
+    at_most_one(cells);
+  }
+
+  std::string out = clauses.front();
+  for (std::size_t i = 1; i < clauses.size(); ++i) out += " AND " + clauses[i];
+  return out;
+}
+
+}  // namespace utility
+}  // namespace dagir
@@ -0,0 +1,223 @@
+/**
+ * @file expression_program.hpp
+ * @brief Flat, hash-consed instruction form of expression ASTs.
+ *
+ * @details
+ * `compile_expression` lowers a `my_expression` tree into an
+ * `expression_program`: a vector of instructions in topological order
+ * (operands always precede their users). The lowering walks the AST with an
+ * explicit stack, so arbitrarily deep left-leaning chains produced by the
+ * parser cannot overflow the call stack, and structurally identical subtrees
+ * are interned to a single instruction. Consumers such as the BDD converters
+ * evaluate the program front to back and use `use_counts` to release
+ * intermediate results as soon as their last user has run.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <dagir/utility/expressions/expression_ast.hpp>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace dagir {
+namespace utility {
+
+/**
+ * @brief Operation performed by an `expression_instruction`.
+ */
+enum class expression_opcode : std::uint8_t {
+  variable,  ///< Load variable `lhs`
+  op_not,    ///< Negate slot `lhs`
+  op_and,    ///< Conjunction of slots `lhs` and `rhs`
+  op_or,     ///< Disjunction of slots `lhs` and `rhs`
+  op_xor     ///< Exclusive or of slots `lhs` and `rhs`
+};
+
+/**
+ * @brief Single instruction of an `expression_program`.
+ *
+ * For `expression_opcode::variable` the `lhs` field holds the variable index;
+ * for every other opcode `lhs` and `rhs` refer to earlier instruction slots.
+ */
+struct expression_instruction {
+  expression_opcode opcode = expression_opcode::variable;
+  std::uint32_t lhs = 0;  ///< Variable index or first operand slot
+  std::uint32_t rhs = 0;  ///< Second operand slot (binary opcodes only)
+
+  auto operator<=>(const expression_instruction& other) const = default;
+};
+
+/**
+ * @brief Topologically ordered, duplicate-free lowering of an expression.
+ */
+struct expression_program {
+  /// Instructions; operands always precede the instructions that use them.
+  std::vector<expression_instruction> instructions;
+
+  /// Number of consumers of each slot. The root slot counts the caller as a consumer.
+  std::vector<std::uint32_t> use_counts;
+
+  /// Slot holding the value of the whole expression.
+  std::uint32_t root = 0;
+
+  /// One past the largest variable index referenced by the program.
+  std::size_t variable_count = 0;
+};
+
+/**
+ * @brief Thrown by the BDD converters when a conversion is cancelled through
+ *        its `std::stop_token`.
+ */
+class expression_conversion_cancelled : public std::runtime_error {
+ public:
+  expression_conversion_cancelled() : std::runtime_error("expression conversion cancelled") {}
+};
+
+namespace expression_program_detail {
+
+/**
+ * @brief Hash for instructions used while interning identical subtrees.
+ */
+struct instruction_hash {
+  std::size_t operator()(const expression_instruction& ins) const noexcept {
+    std::uint64_t h = static_cast<std::uint64_t>(ins.opcode);
+    h = h * 0x9E3779B97F4A7C15ull ^ ins.lhs;
+    h = h * 0x9E3779B97F4A7C15ull ^ ins.rhs;
+    return static_cast<std::size_t>(h ^ (h >> 29));
+  }
+};
+
+/**
+ * @brief Return the operand pointers of an AST node (null when absent).
+ */
+inline std::pair<const my_expression*, const my_expression*> operands_of(
+    const my_expression& node) {
+  if (auto p_and = std::get_if<my_and>(&node)) return {p_and->left.get(), p_and->right.get()};
+  if (auto p_or = std::get_if<my_or>(&node)) return {p_or->left.get(), p_or->right.get()};
+  if (auto p_xor = std::get_if<my_xor>(&node)) return {p_xor->left.get(), p_xor->right.get()};
+  if (auto p_not = std::get_if<my_not>(&node)) return {p_not->expr.get(), nullptr};
+  return {nullptr, nullptr};
+}
+
+}  // namespace expression_program_detail
+
+/**
+ * @brief Lower an expression AST into an `expression_program`.
+ *
+ * @param expr Root of the expression AST.
+ * @param var_map Mapping from variable names to indices. Names not yet
+ *        present are assigned the next free index in first-seen
+ *        (left-to-right) order and added to the map.
+ * @return The compiled program.
+ * @throws std::runtime_error If the AST contains a node with a missing operand.
+ *
+ * The AST is walked with an explicit stack. Commutative operands are
+ * normalized and identical subtrees share one slot.
+ */
+inline expression_program compile_expression(const my_expression& expr,
+                                             std::unordered_map<std::string, int>& var_map) {
+  using expression_program_detail::operands_of;
+
+  expression_program program;
+  std::unordered_map<expression_instruction, std::uint32_t,
+                     expression_program_detail::instruction_hash>
+      interned;
+  std::unordered_map<const my_expression*, std::uint32_t> slot_of;
+
+  auto emit = [&](expression_instruction ins) -> std::uint32_t {
+    if (ins.opcode == expression_opcode::op_and || ins.opcode == expression_opcode::op_or ||
+        ins.opcode == expression_opcode::op_xor) {
+      if (ins.rhs < ins.lhs) std::swap(ins.lhs, ins.rhs);
+    }
+    auto [it, inserted] =
+        interned.try_emplace(ins, static_cast<std::uint32_t>(program.instructions.size()));
+    if (inserted) {
+      program.instructions.push_back(ins);
+      program.use_counts.push_back(0);
+      if (ins.opcode != expression_opcode::variable) {
+        ++program.use_counts[ins.lhs];
+        if (ins.opcode != expression_opcode::op_not) ++program.use_counts[ins.rhs];
+      }
+    }
+    return it->second;
+  };
+
+  // Each frame is visited twice: once to schedule its operands, once to emit it.
+  struct frame {
+    const my_expression* node;
+    bool expanded;
+  };
+  std::vector<frame> stack{{&expr, false}};
+
+  while (!stack.empty()) {
+    frame& top = stack.back();
+    const my_expression* node = top.node;
+    if (slot_of.count(node)) {
+      stack.pop_back();
+      continue;
+    }
+
+    auto [lhs, rhs] = operands_of(*node);
+    if (!top.expanded) {
+      top.expanded = true;
+      // Push right first so the left operand is lowered (and its variables
+      // numbered) first.
+      if (rhs) stack.push_back({rhs, false});
+      if (lhs) stack.push_back({lhs, false});
+      continue;
+    }
+    stack.pop_back();
+
+    expression_instruction ins;
+    if (auto p_var = std::get_if<my_variable>(node)) {
+      auto [it, inserted] =
+          var_map.try_emplace(p_var->variable_name, static_cast<int>(var_map.size()));
+      (void)inserted;
+      ins.opcode = expression_opcode::variable;
+      ins.lhs = static_cast<std::uint32_t>(it->second);
+      program.variable_count = std::max(program.variable_count, std::size_t{ins.lhs} + 1);
+    } else {
+      const bool is_not = std::holds_alternative<my_not>(*node);
+      if (!lhs || (!is_not && !rhs)) {
+        throw std::runtime_error("compile_expression: operator node is missing an operand");
+      }
+      ins.lhs = slot_of.at(lhs);
+      if (is_not) {
+        ins.opcode = expression_opcode::op_not;
+      } else {
+        ins.rhs = slot_of.at(rhs);
+        ins.opcode = std::holds_alternative<my_and>(*node)  ? expression_opcode::op_and
+                     : std::holds_alternative<my_or>(*node) ? expression_opcode::op_or
+                                                            : expression_opcode::op_xor;
+      }
+    }
+    slot_of.emplace(node, emit(ins));
+  }
+
+  program.root = slot_of.at(&expr);
+  ++program.use_counts[program.root];
+  return program;
+}
+
+/**
+ * @brief Convenience overload that assigns variable indices in first-seen order.
+ */
+inline expression_program compile_expression(const my_expression& expr) {
+  std::unordered_map<std::string, int> var_map;
+  return compile_expression(expr, var_map);
+}
+
+}  // namespace utility
+}  // namespace dagir
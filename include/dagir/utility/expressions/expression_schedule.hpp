@@ -0,0 +1,208 @@
+/**
+ * @file expression_schedule.hpp
+ * @brief Flattening and scheduling of associative chains in expression programs.
+ *
+ * @details
+ * The expression parser produces left-deep binary chains for repeated
+ * `AND`/`OR`/`XOR`, so evaluating an `expression_program` front to back
+ * combines the operands of such a chain strictly left to right. For BDDs this
+ * is frequently the worst order: the running conjunction of the N-Queens row
+ * and column constraints grows far larger than the final result.
+ *
+ * `flatten_chains` identifies maximal single-use chains of one associative
+ * opcode and collects their leaf operands, and `reduce_chain` combines a list
+ * of operands according to an `expression_schedule`. Because AND, OR and XOR
+ * are associative and commutative, every schedule yields the same function;
+ * only the sizes of the intermediate results differ.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <dagir/utility/expressions/expression_program.hpp>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dagir {
+namespace utility {
+
+/**
+ * @brief Order in which the operands of a flattened chain are combined.
+ */
+enum class expression_schedule : std::uint8_t {
+  in_order,       ///< Left fold in source order (the parser's left-deep chain)
+  balanced,       ///< Pairwise rounds, giving a balanced binary tree
+  smallest_first  ///< Repeatedly combine the two currently smallest operands
+};
+
+/**
+ * @brief Associative chains of an `expression_program`.
+ *
+ * A slot is *absorbed* when it is a binary AND/OR/XOR instruction used exactly
+ * once, by an instruction with the same opcode; its value is never needed on
+ * its own. Every other AND/OR/XOR slot is a chain root and lists the leaf
+ * operand slots of its chain in source order. Leaves may repeat when the same
+ * subexpression occurs several times in the chain.
+ */
+struct expression_chains {
+  /// `absorbed[i]` is true when slot `i` is folded into the chain of a later slot.
+  std::vector<bool> absorbed;
+
+  /// Leaf operand slots for chain roots; empty for every other slot.
+  std::vector<std::vector<std::uint32_t>> operands;
+};
+
+namespace expression_program_detail {
+
+inline bool is_associative(expression_opcode op) noexcept {
+  return op == expression_opcode::op_and || op == expression_opcode::op_or ||
+         op == expression_opcode::op_xor;
+}
+
+}  // namespace expression_program_detail
+
+/**
+ * @brief Find the maximal associative chains of a program.
+ *
+ * @param program Program produced by `compile_expression`.
+ * @return Absorbed flags and leaf operands for every chain root.
+ *
+ * Runs in time linear in the program size; operand collection uses an
+ * explicit stack, so arbitrarily long chains are handled.
+ */
+inline expression_chains flatten_chains(const expression_program& program) {
+  using expression_program_detail::is_associative;
+  const auto& instructions = program.instructions;
+
+  expression_chains out;
+  out.absorbed.assign(instructions.size(), false);
+  out.operands.resize(instructions.size());
+
+  for (const expression_instruction& ins : instructions) {
+    if (!is_associative(ins.opcode)) continue;
+    for (std::uint32_t operand : {ins.lhs, ins.rhs}) {
+      if (instructions[operand].opcode == ins.opcode && program.use_counts[operand] == 1) {
+        out.absorbed[operand] = true;
+      }
+    }
+  }
+
+  std::vector<std::uint32_t> stack;
+  for (std::size_t i = 0; i < instructions.size(); ++i) {
+    if (!is_associative(instructions[i].opcode) || out.absorbed[i]) continue;
+
+    // Depth-first, left operand first, so leaves come out in source order.
+    auto& leaves = out.operands[i];
+    stack.assign({instructions[i].rhs, instructions[i].lhs});
+    while (!stack.empty()) {
+      const std::uint32_t slot = stack.back();
+      stack.pop_back();
+      if (out.absorbed[slot]) {
+        stack.push_back(instructions[slot].rhs);
+        stack.push_back(instructions[slot].lhs);
+      } else {
+        leaves.push_back(slot);
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Combine a list of operands according to a schedule.
+ *
+ * @tparam T Operand type (for example a referenced BDD node or diagram).
+ * @param operands Operands to combine; must not be empty.
+ * @param schedule Combination order.
+ * @param combine Callable `T(T, T)` producing the combination of two operands.
+ *        It takes ownership of both inputs and must release them even when it
+ *        throws.
+ * @param size Callable `std::size_t(const T&)` used as the priority for
+ *        `expression_schedule::smallest_first` (for example the node count).
+ * @param drop Callable `void(T&)` releasing an operand that will not be
+ *        combined because an earlier `combine` threw.
+ * @return The combination of all operands.
+ *
+ * Ties in `smallest_first` are broken by insertion order, so the result of a
+ * given input is deterministic.
+ */
+template <class T, class Combine, class Size, class Drop>
+T reduce_chain(std::vector<T> operands, expression_schedule schedule, Combine&& combine,
+               Size&& size, Drop&& drop) {
+  if (operands.empty()) throw std::invalid_argument("reduce_chain: no operands");
+
+  switch (schedule) {
+    case expression_schedule::in_order: {
+      std::size_t next = 1;
+      try {
+        for (; next < operands.size(); ++next) {
+          operands[0] = combine(std::move(operands[0]), std::move(operands[next]));
+        }
+      } catch (...) {
+        for (++next; next < operands.size(); ++next) drop(operands[next]);
+        throw;
+      }
+      return std::move(operands[0]);
+    }
+
+    case expression_schedule::balanced: {
+      // Each round combines neighbours (0,1), (2,3), ... and keeps an odd tail.
+      std::size_t count = operands.size();
+      while (count > 1) {
+        std::size_t i = 0;
+        try {
+          for (; i + 1 < count; i += 2) {
+            operands[i / 2] = combine(std::move(operands[i]), std::move(operands[i + 1]));
+          }
+        } catch (...) {
+          for (std::size_t k = 0; k < i / 2; ++k) drop(operands[k]);
+          for (std::size_t k = i + 2; k < count; ++k) drop(operands[k]);
+          throw;
+        }
+        if (count % 2 != 0) operands[count / 2] = std::move(operands[count - 1]);
+        count = (count + 1) / 2;
+      }
+      return std::move(operands[0]);
+    }
+
+    case expression_schedule::smallest_first:
+      break;
+  }
+
+  // (size, sequence, index into operands); the sequence number breaks ties.
+  using entry = std::pair<std::pair<std::size_t, std::size_t>, std::size_t>;
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+  std::size_t sequence = 0;
+  for (std::size_t i = 0; i < operands.size(); ++i) {
+    queue.push({{size(operands[i]), sequence++}, i});
+  }
+
+  while (queue.size() > 1) {
+    const std::size_t a = queue.top().second;
+    queue.pop();
+    const std::size_t b = queue.top().second;
+    queue.pop();
+    try {
+      operands[a] = combine(std::move(operands[a]), std::move(operands[b]));
+    } catch (...) {
+      while (!queue.empty()) {
+        drop(operands[queue.top().second]);
+        queue.pop();
+      }
+      throw;
+    }
+    queue.push({{size(operands[a]), sequence++}, a});
+  }
+  return std::move(operands[queue.top().second]);
+}
+
+}  // namespace utility
+}  // namespace dagir
@@ -0,0 +1,188 @@
+/**
+ * @file portfolio.hpp
+ * @brief Race several independent builds on separate threads and keep the best.
+ *
+ * @details
+ * BDD size can change by orders of magnitude with the variable order, and
+ * which order wins is hard to predict. Since every TeDDy `bdd_manager` and
+ * every CUDD `DdManager` is independent, a portfolio runs the same conversion
+ * on N threads, each with its own manager and settings, and keeps one result:
+ *
+ * - `portfolio_policy::first_finished`: the first candidate to finish wins and
+ *   the others are cancelled at once.
+ * - `portfolio_policy::smallest_within_budget`: candidates run until all have
+ *   finished or the time budget expires; the smallest finished result wins.
+ *   If nothing has finished when the budget expires, the first candidate to
+ *   finish afterwards wins.
+ *
+ * Cancellation is cooperative through `std::stop_token`; the BDD converters
+ * accept the token directly. Losing results are destroyed on the calling
+ * thread after all workers have been joined.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dagir {
+namespace utility {
+
+/**
+ * @brief How the winner of a portfolio is chosen.
+ */
+enum class portfolio_policy : std::uint8_t {
+  first_finished,         ///< First successful candidate wins
+  smallest_within_budget  ///< Smallest result finished within the budget wins
+};
+
+/**
+ * @brief Portfolio settings.
+ */
+struct portfolio_options {
+  portfolio_policy policy = portfolio_policy::first_finished;
+
+  /// Time budget; zero means unlimited. With `first_finished` it is a hard
+  /// limit after which every candidate is cancelled.
+  std::chrono::milliseconds budget{0};
+};
+
+/**
+ * @brief Final state of one candidate.
+ */
+enum class portfolio_status : std::uint8_t {
+  finished,   ///< Produced a result
+  cancelled,  ///< Stopped because another candidate won or the budget expired
+  failed      ///< Threw an exception without being asked to stop
+};
+
+/**
+ * @brief Per-candidate report.
+ */
+struct portfolio_report {
+  portfolio_status status = portfolio_status::cancelled;
+  std::size_t size = 0;                                 ///< Result size when finished
+  std::chrono::duration<double, std::milli> elapsed{};  ///< Wall time of the build
+  std::string error;                                    ///< Exception message, if any
+};
+
+/**
+ * @brief Result of `run_portfolio`.
+ */
+template <class Result>
+struct portfolio_outcome {
+  std::optional<Result> winner;           ///< Empty when no candidate qualified
+  std::size_t winner_index = 0;           ///< Candidate index of `winner`
+  std::vector<portfolio_report> reports;  ///< One entry per candidate
+};
+
+/**
+ * @brief Run `candidates` builds concurrently and select a winner.
+ *
+ * @tparam Result Move-constructible result type; it should own everything the result
+ *         needs (for example the manager together with the root diagram).
+ * @param candidates Number of candidates (one thread each).
+ * @param build Callable `Result(std::size_t index, std::stop_token stop)`.
+ *        It should return promptly (typically by throwing) once `stop` is
+ *        requested. Called concurrently from different threads.
+ * @param size Callable `std::size_t(const Result&)` ranking finished results;
+ *        evaluated on the worker thread right after its build.
+ * @param options Selection policy and time budget.
+ * @return The winner (if any) and a report for every candidate.
+ */
+template <class Result, class Build, class Size>
+portfolio_outcome<Result> run_portfolio(std::size_t candidates, Build&& build, Size&& size,
+                                        const portfolio_options& options = {}) {
+  using clock = std::chrono::steady_clock;
+
+  portfolio_outcome<Result> outcome;
+  outcome.reports.resize(candidates);
+  std::vector<std::optional<Result>> results(candidates);
+  std::vector<std::size_t> finish_order;
+  std::size_t done = 0;
+  std::mutex mutex;
+  std::condition_variable cv;
+  const auto start = clock::now();
+
+  std::size_t eligible = 0;  // finished candidates considered for the win
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(candidates);
+    for (std::size_t i = 0; i < candidates; ++i) {
+      workers.emplace_back([&, i](std::stop_token stop) {
+        const auto t0 = clock::now();
+        portfolio_report report;
+        std::optional<Result> result;
+        try {
+          result.emplace(build(i, stop));
+          report.size = size(*result);
+          report.status = portfolio_status::finished;
+        } catch (const std::exception& e) {
+          report.status = stop.stop_requested() ? portfolio_status::cancelled
+                                                : portfolio_status::failed;
+          report.error = e.what();
+        } catch (...) {
+          report.status = stop.stop_requested() ? portfolio_status::cancelled
+                                                : portfolio_status::failed;
+          report.error = "unknown exception";
+        }
+        report.elapsed = clock::now() - t0;
+
+        {
+          std::lock_guard lock(mutex);
+          if (result) results[i].emplace(std::move(*result));
+          outcome.reports[i] = std::move(report);
+          if (outcome.reports[i].status == portfolio_status::finished) finish_order.push_back(i);
+          ++done;
+        }
+        cv.notify_all();
+      });
+    }
+
+    std::unique_lock lock(mutex);
+    const bool first = options.policy == portfolio_policy::first_finished;
+    auto decided = [&]() { return done == candidates || (first && !finish_order.empty()); };
+    if (options.budget.count() > 0) {
+      if (!cv.wait_until(lock, start + options.budget, decided) && !first) {
+        // Budget expired without a finished candidate: take the next one to finish.
+        cv.wait(lock, [&]() { return done == candidates || !finish_order.empty(); });
+      }
+    } else {
+      cv.wait(lock, decided);
+    }
+    eligible = finish_order.size();
+    lock.unlock();
+
+    for (auto& worker : workers) worker.request_stop();
+  }  // joins all workers
+
+  if (eligible == 0) return outcome;
+
+  std::size_t best = finish_order.front();
+  if (options.policy == portfolio_policy::smallest_within_budget) {
+    for (std::size_t k = 1; k < eligible; ++k) {
+      const std::size_t i = finish_order[k];
+      if (outcome.reports[i].size < outcome.reports[best].size) best = i;
+    }
+  }
+  outcome.winner.emplace(std::move(*results[best]));
+  outcome.winner_index = best;
+  return outcome;
+}
+
+}  // namespace utility
+}  // namespace dagir
@@ -0,0 +1,247 @@
+/**
+ * @file render_cache.hpp
+ * @brief Content-addressed on-disk cache of rendered output.
+ *
+ * @details
+ * Rendering the same input again (parse, convert, `build_ir`, render) is pure
+ * waste when nothing changed. `render_cache` stores rendered DOT/JSON/Mermaid
+ * text in a local directory under a 128-bit key:
+ *
+ * - `render_cache_key(parts)` fingerprints arbitrary byte strings, e.g. the
+ *   contents of an expression file plus the tool, backend and options that
+ *   affect the output. A hit skips all work, including parsing.
+ * - `render_cache_view_key(view, label_hash, identity, backend)` fingerprints
+ *   the structure of a view through `merkle_graph_hash` plus a string naming
+ *   the attributor policies. The label hash must cover everything the
+ *   policies render for a node.
+ *
+ * Each entry is one file named after the key. Writes go to a unique
+ * temporary file that is renamed into place, so concurrent readers never see
+ * partial entries and concurrent writers of the same key simply race to an
+ * identical result. Hits refresh the file time, and after every store the
+ * least recently used entries are removed until the directory is within
+ * `max_bytes`. Eviction scans the directory, which is fine for the few
+ * thousand entries a render cache holds. I/O errors during lookup count as a
+ * miss; errors during a store are reported through the return value so a
+ * read-only or full disk never breaks rendering.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "dagir/merkle_hash.hpp"
+
+namespace dagir {
+namespace utility {
+
+/// Bump when the renderers change output for unchanged input.
+inline constexpr std::string_view k_render_cache_format = "dagir-render-cache-1";
+
+/**
+ * @brief Key for output derived from the given byte strings (order matters).
+ */
+inline hash128 render_cache_key(std::initializer_list<std::string_view> parts) {
+  hash128_builder h;
+  h.add(hash_bytes(k_render_cache_format));
+  for (std::string_view part : parts) h.add(hash_bytes(part));
+  return h.finish(parts.size());
+}
+
+/**
+ * @brief Key for the rendering of `view` by the policies named `identity`.
+ *
+ * @tparam View A type modeling ::dagir::concepts::read_only_dag_view
+ * @param label_hash Label-hash policy for `merkle_hashes`
+ * @param identity Names the attributor policies and any rendering options
+ * @param backend Output format, e.g. "dot"
+ */
+template <dagir::concepts::read_only_dag_view View, class LabelHash>
+hash128 render_cache_view_key(const View& view, LabelHash label_hash, std::string_view identity,
+                              std::string_view backend) {
+  const hash128 structure = merkle_graph_hash(view, std::move(label_hash));
+  const std::string structure_hex = to_string(structure);
+  return render_cache_key({structure_hex, identity, backend});
+}
+
+/**
+ * @brief Counters of one `render_cache` instance.
+ */
+struct render_cache_stats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t stores = 0;
+  std::uint64_t evictions = 0;
+};
+
+/**
+ * @brief Render cache rooted at one directory.
+ */
+class render_cache {
+ public:
+  /// Extension of entry files.
+  static constexpr std::string_view k_extension = ".render";
+
+  /**
+   * @param directory Cache directory; created if missing.
+   * @param max_bytes Size limit for all entries together.
+   * @throws std::filesystem::filesystem_error If the directory cannot be created.
+   */
+  explicit render_cache(std::filesystem::path directory,
+                        std::uint64_t max_bytes = std::uint64_t{256} << 20)
+      : directory_(std::move(directory)), max_bytes_(max_bytes) {
+    std::filesystem::create_directories(directory_);
+  }
+
+  /// File holding the entry for `key`.
+  std::filesystem::path path_for(const hash128& key) const {
+    return directory_ / (to_string(key) + std::string(k_extension));
+  }
+
+  /**
+   * @brief Cached output for `key`, refreshing its LRU time on a hit.
+   */
+  std::optional<std::string> lookup(const hash128& key) {
+    const std::filesystem::path path = path_for(key);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      ++stats_.misses;
+      return std::nullopt;
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+      ++stats_.misses;
+      return std::nullopt;
+    }
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    ++stats_.hits;
+    return content;
+  }
+
+  /**
+   * @brief Atomically store `content` under `key`, then evict down to the limit.
+   * @return false if the entry could not be written.
+   */
+  bool store(const hash128& key, std::string_view content) {
+    const std::filesystem::path path = path_for(key);
+    std::filesystem::path tmp = path;
+    tmp += ".tmp-" + unique_suffix();
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out.write(content.data(), static_cast<std::streamsize>(content.size()));
+      out.flush();
+      if (!out) {
+        std::error_code ec;
+        std::filesystem::remove(tmp, ec);
+        return false;
+      }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+      std::filesystem::remove(tmp, ec);
+      return false;
+    }
+    ++stats_.stores;
+    evict(path);
+    return true;
+  }
+
+  /// Total size of all entries, in bytes.
+  std::uint64_t size_bytes() const {
+    std::uint64_t total = 0;
+    for (const entry& e : entries()) total += e.size;
+    return total;
+  }
+
+  const render_cache_stats& stats() const noexcept { return stats_; }
+  const std::filesystem::path& directory() const noexcept { return directory_; }
+
+ private:
+  struct entry {
+    std::filesystem::path path;
+    std::filesystem::file_time_type time;
+    std::uint64_t size;
+  };
+
+  std::vector<entry> entries() const {
+    std::vector<entry> out;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end;
+         it.increment(ec)) {
+      if (it->path().extension() != k_extension) continue;
+      std::error_code e1, e2;
+      const auto size = it->file_size(e1);
+      const auto time = it->last_write_time(e2);
+      if (!e1 && !e2) out.push_back({it->path(), time, size});
+    }
+    return out;
+  }
+
+  /// Remove least recently used entries (never `keep`) until within the limit.
+  void evict(const std::filesystem::path& keep) {
+    std::vector<entry> all = entries();
+    std::uint64_t total = 0;
+    for (const entry& e : all) total += e.size;
+    if (total <= max_bytes_) return;
+    std::sort(all.begin(), all.end(),
+              [](const entry& a, const entry& b) { return a.time < b.time; });
+    for (const entry& e : all) {
+      if (total <= max_bytes_) break;
+      if (e.path == keep) continue;
+      std::error_code ec;
+      if (std::filesystem::remove(e.path, ec)) {
+        total -= e.size;
+        ++stats_.evictions;
+      }
+    }
+  }
+
+  static std::string unique_suffix() {
+    static std::atomic<std::uint64_t> counter{0};
+    static const std::uint64_t process_salt = [] {
+      std::random_device rd;
+      return (std::uint64_t{rd()} << 32) ^ rd();
+    }();
+    return to_string(hash_integer(counter.fetch_add(1), process_salt)).substr(0, 16);
+  }
+
+  std::filesystem::path directory_;
+  std::uint64_t max_bytes_;
+  render_cache_stats stats_;
+};
+
+/**
+ * @brief Write the counters of `cache` and its current size as `key: value` lines.
+ */
+inline void write_render_cache_stats(std::ostream& os, const render_cache& cache) {
+  const render_cache_stats& stats = cache.stats();
+  os << "cache_hits: " << stats.hits << "\n"
+     << "cache_misses: " << stats.misses << "\n"
+     << "cache_stores: " << stats.stores << "\n"
+     << "cache_evictions: " << stats.evictions << "\n"
+     << "cache_bytes: " << cache.size_bytes() << "\n";
+}
+
+}  // namespace utility
+}  // namespace dagir
@@ -5,7 +5,12 @@
  * @details
  * This file provides functions to convert expression ASTs defined in
  * `expression_read_only_dag_view.hpp` into TeDDy BDD diagrams using a
- * `teddy::bdd_manager`.
+ * `teddy::bdd_manager`. The AST is first lowered to an `expression_program`,
+ * which is then evaluated iteratively: every distinct subexpression is built
+ * exactly once and its intermediate diagram is dropped as soon as its last
+ * user has run. Associative AND/OR/XOR chains are flattened and their
+ * operands combined according to an `expression_schedule` (smallest first by
+ * default).
  *
  * @copyright
  * © DagIR Contributors. All rights reserved.
@@ -14,80 +19,111 @@
 
 #pragma once
 
-#include <algorithm>
-#include <cctype>
-#include <dagir/algorithms.hpp>
+#include <cstdint>
+#include <dagir/utility/expressions/expression_program.hpp>
 #include <dagir/utility/expressions/expression_read_only_dag_view.hpp>
-#include <functional>
+#include <dagir/utility/expressions/expression_schedule.hpp>
 #include <libteddy/core.hpp>
+#include <optional>
+#include <stop_token>
 #include <string>
 #include <unordered_map>
-#include <variant>
+#include <utility>
+#include <vector>
 
 namespace dagir {
 namespace utility {
 
 /**
- * @brief Convert an expression AST into a TeDDy BDD diagram.
+ * @brief Evaluate a compiled expression program into a TeDDy BDD diagram.
  *
- * @param mgr Teddy BDD manager used to create diagrams.
- * @param expr Expression AST to convert.
- * @param var_map Mapping from variable names to Teddy variable indices.
+ * @param mgr Teddy BDD manager used to create diagrams. It must have been
+ *        created with at least `program.variable_count` variables.
+ * @param program Program produced by `compile_expression`.
+ * @param schedule Combination order for the operands of associative chains.
+ *        `smallest_first` uses the node count of the intermediate diagrams.
+ * @param stop Cancellation token, checked before every diagram operation.
+ *        TeDDy operations cannot be interrupted, so cancellation takes effect
+ *        once the running `apply` or `negate` returns.
  * @return A `teddy::bdd_manager::diagram_t` representing the expression.
+ * @throws expression_conversion_cancelled If `stop` is triggered.
  *
- * The resolver treats names like `xN` as index `N`; otherwise names are
- * assigned sequential indices and stored in `var_map`.
+ * Negation uses the manager's native `negate` instead of `NAND(x, x)`.
  */
 inline teddy::bdd_manager::diagram_t convert_expression_to_teddy(
-    teddy::bdd_manager& mgr, const dagir::utility::my_expression& expr,
-    std::unordered_map<std::string, int>& var_map) {
+    teddy::bdd_manager& mgr, const expression_program& program,
+    expression_schedule schedule = expression_schedule::smallest_first,
+    std::stop_token stop = {}) {
   using diagram_t = teddy::bdd_manager::diagram_t;
 
-  /**
-   * @brief Resolve a variable name to a Teddy variable index.
-   */
-  auto resolve_var = [&](const std::string& name) -> int {
-    auto it = var_map.find(name);
-    if (it != var_map.end()) return it->second;
-    int idx = static_cast<int>(var_map.size());
-    var_map.emplace(name, idx);
-    return idx;
-  };
+  const expression_chains chains = flatten_chains(program);
+  std::vector<std::optional<diagram_t>> values(program.instructions.size());
+  std::vector<std::uint32_t> remaining = program.use_counts;
 
-  /**
-   * @brief Visitor used with `std::visit` to convert variant nodes.
-   */
-  struct visitor {
-    teddy::bdd_manager& mgr;
-    std::function<int(const std::string&)> resolve_var;
+  auto release = [&](std::uint32_t slot) {
+    if (--remaining[slot] == 0) values[slot].reset();
+  };
+  auto check_stop = [&]() {
+    if (stop.stop_requested()) throw expression_conversion_cancelled();
+  };
 
-    /** Convert variable node to a Teddy variable diagram. */
-    diagram_t operator()(const my_variable& v) {
-      int idx = resolve_var(v.variable_name);
-      return mgr.variable(idx);
-    }
-    diagram_t operator()(const my_and& a) {
-      auto L = std::visit(*this, *a.left);
-      auto R = std::visit(*this, *a.right);
-      return mgr.apply<teddy::ops::AND>(L, R);
-    }
-    diagram_t operator()(const my_or& o) {
-      auto L = std::visit(*this, *o.left);
-      auto R = std::visit(*this, *o.right);
-      return mgr.apply<teddy::ops::OR>(L, R);
+  auto reduce = [&]<class Op>(const std::vector<std::uint32_t>& leaves, Op) {
+    std::vector<diagram_t> operands;
+    operands.reserve(leaves.size());
+    for (std::uint32_t leaf : leaves) {
+      operands.push_back(*values[leaf]);
+      release(leaf);
     }
-    diagram_t operator()(const my_xor& x) {
-      auto L = std::visit(*this, *x.left);
-      auto R = std::visit(*this, *x.right);
-      return mgr.apply<teddy::ops::XOR>(L, R);
-    }
-    diagram_t operator()(const my_not& n) {
-      auto D = std::visit(*this, *n.expr);
-      return mgr.apply<teddy::ops::NAND>(D, D);
+    return reduce_chain(
+        std::move(operands), schedule,
+        [&](diagram_t a, diagram_t b) {
+          check_stop();
+          return mgr.apply<Op>(a, b);
+        },
+        [&](const diagram_t& d) { return static_cast<std::size_t>(mgr.get_node_count(d)); },
+        [](diagram_t&) {});
+  };
+
+  for (std::size_t i = 0; i < program.instructions.size(); ++i) {
+    if (chains.absorbed[i]) continue;
+    const expression_instruction& ins = program.instructions[i];
+    switch (ins.opcode) {
+      case expression_opcode::variable:
+        values[i].emplace(mgr.variable(static_cast<teddy::int32>(ins.lhs)));
+        break;
+      case expression_opcode::op_not:
+        check_stop();
+        values[i].emplace(mgr.negate(*values[ins.lhs]));
+        release(ins.lhs);
+        break;
+      case expression_opcode::op_and:
+        values[i].emplace(reduce(chains.operands[i], teddy::ops::AND{}));
+        break;
+      case expression_opcode::op_or:
+        values[i].emplace(reduce(chains.operands[i], teddy::ops::OR{}));
+        break;
+      case expression_opcode::op_xor:
+        values[i].emplace(reduce(chains.operands[i], teddy::ops::XOR{}));
+        break;
     }
-  } vis{mgr, resolve_var};
+  }
 
-  return std::visit(vis, expr);
+  return std::move(*values[program.root]);
+}
+
+/**
+ * @brief Convert an expression AST into a TeDDy BDD diagram.
+ *
+ * @param mgr Teddy BDD manager used to create diagrams.
+ * @param expr Expression AST to convert.
+ * @param var_map Mapping from variable names to Teddy variable indices. Names
+ *        not yet present are assigned sequential indices and added to the map.
+ * @return A `teddy::bdd_manager::diagram_t` representing the expression.
+ */
+inline teddy::bdd_manager::diagram_t convert_expression_to_teddy(
+    teddy::bdd_manager& mgr, const dagir::utility::my_expression& expr,
+    std::unordered_map<std::string, int>& var_map) {
+  return convert_expression_to_teddy(mgr, compile_expression(expr, var_map));
 }
 
 inline teddy::bdd_manager::diagram_t convert_expression_to_teddy(
@@ -97,4 +133,4 @@ inline teddy::bdd_manager::diagram_t convert_expression_to_teddy(
 }
 
 }  // namespace utility
-}  // namespace dagir
\ No newline at end of file
+}  // namespace dagir
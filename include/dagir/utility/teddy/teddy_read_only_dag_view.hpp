@@ -14,6 +14,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <dagir/concepts/read_only_dag_view.hpp>
 #include <libteddy/core.hpp>
@@ -133,6 +134,37 @@ class teddy_read_only_dag_view {
    */
   static auto start_guard(const handle&) { return dagir::noop_guard{}; }
 
+  /**
+   * @brief True if `h` is a terminal node (`dagir::concepts::bdd_view`).
+   */
+  static bool is_terminal(const handle& h) noexcept { return h.ptr->is_terminal(); }
+
+  /**
+   * @brief Boolean value of a terminal node.
+   */
+  static bool terminal_value(const handle& h) noexcept { return h.ptr->get_value() != 0; }
+
+  /**
+   * @brief Variable index tested by a decision node.
+   */
+  static std::size_t variable_index(const handle& h) noexcept {
+    return static_cast<std::size_t>(h.ptr->get_index());
+  }
+
+  /**
+   * @brief Number of variables of the manager (`dagir::concepts::ordered_bdd_view`).
+   */
+  std::size_t variable_count() const noexcept {
+    return mgr_ ? static_cast<std::size_t>(mgr_->get_var_count()) : 0;
+  }
+
+  /**
+   * @brief Level of variable `index` in the manager's current order.
+   */
+  std::size_t variable_level(std::size_t index) const noexcept {
+    return static_cast<std::size_t>(mgr_->get_level(static_cast<teddy::int32>(index)));
+  }
+
  private:
   teddy::bdd_manager* mgr_ = nullptr;
   const std::vector<std::string>* var_names_ = nullptr;
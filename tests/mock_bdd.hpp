@@ -0,0 +1,146 @@
+/**
+ * @file mock_bdd.hpp
+ * @brief Mock BDD views for unit tests.
+ *
+ * @details
+ * This file defines `MockBddView`, a small reduced ordered BDD built from
+ * truth tables that models `dagir::concepts::bdd_view`, and
+ * `MockOrderedBddView`, which also reports a variable order and models
+ * `dagir::concepts::ordered_bdd_view`.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <dagir/concepts/bdd_view.hpp>
+#include <map>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * @class MockBddHandle
+ * @brief Handle naming a node of a mock BDD by index (0 = false, 1 = true).
+ */
+struct MockBddHandle {
+  std::uint32_t id{};
+  constexpr std::uint64_t stable_key() const noexcept { return id; }
+  constexpr const void* debug_address() const noexcept { return nullptr; }
+  friend constexpr bool operator==(MockBddHandle a, MockBddHandle b) noexcept {
+    return a.id == b.id;
+  }
+  friend constexpr bool operator!=(MockBddHandle a, MockBddHandle b) noexcept {
+    return !(a == b);
+  }
+};
+
+/**
+ * @class MockBddView
+ * @brief Reduced ordered BDD over truth tables of up to 6 variables.
+ *
+ * @details
+ * Variable `v` is bit `v` of a truth-table index. Decision nodes are built by
+ * Shannon expansion in the order given to `build` and shared through a
+ * unique table.
+ */
+class MockBddView {
+ public:
+  using handle = MockBddHandle;
+
+  struct edge {
+    handle to;
+    constexpr handle target() const noexcept { return to; }
+  };
+
+  MockBddView() : nodes_{{0, 0, 0}, {0, 1, 1}} {}
+
+  /// Build `truth` testing variables in `order` (top first); returns the node id.
+  std::uint32_t build(std::uint64_t truth, const std::vector<std::uint32_t>& order) {
+    return build(truth, order, 0, 0);
+  }
+
+  /// Build `truth` over variables 0..vars-1 in index order.
+  std::uint32_t build(std::uint64_t truth, std::uint32_t vars) {
+    std::vector<std::uint32_t> order(vars);
+    std::iota(order.begin(), order.end(), 0u);
+    return build(truth, order);
+  }
+
+  /// Decision node testing `var` with the given children (no reduction).
+  std::uint32_t make_node(std::uint32_t var, std::uint32_t lo, std::uint32_t hi) {
+    nodes_.push_back({var, lo, hi});
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+  }
+
+  void add_root(std::uint32_t r) { roots_.push_back(handle{r}); }
+
+  std::vector<edge> children(handle h) const {
+    if (h.id < 2) return {};
+    return {edge{handle{nodes_[h.id].lo}}, edge{handle{nodes_[h.id].hi}}};
+  }
+  std::vector<handle> roots() const { return roots_; }
+  bool is_terminal(handle h) const { return h.id < 2; }
+  bool terminal_value(handle h) const { return h.id == 1; }
+  std::size_t variable_index(handle h) const { return nodes_[h.id].var; }
+
+  /// Number of nodes including both terminals.
+  std::size_t size() const { return nodes_.size(); }
+
+ private:
+  struct node {
+    std::uint32_t var, lo, hi;
+  };
+
+  std::uint32_t build(std::uint64_t truth, const std::vector<std::uint32_t>& order,
+                      std::size_t depth, std::uint32_t fixed) {
+    if (depth == order.size()) return static_cast<std::uint32_t>((truth >> fixed) & 1u);
+    const std::uint32_t var = order[depth];
+    const std::uint32_t l = build(truth, order, depth + 1, fixed);
+    const std::uint32_t h = build(truth, order, depth + 1, fixed | (1u << var));
+    if (l == h) return l;
+    auto [it, inserted] =
+        unique_.try_emplace(std::tuple{var, l, h}, static_cast<std::uint32_t>(nodes_.size()));
+    if (inserted) nodes_.push_back({var, l, h});
+    return it->second;
+  }
+
+  std::vector<node> nodes_;
+  std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> unique_;
+  std::vector<handle> roots_;
+};
+
+/**
+ * @class MockOrderedBddView
+ * @brief `MockBddView` with a manager variable count and variable order.
+ */
+class MockOrderedBddView : public MockBddView {
+ public:
+  /// `order[level]` is the variable index at `level`; its size is the variable count.
+  explicit MockOrderedBddView(std::vector<std::uint32_t> order)
+      : order_(std::move(order)), levels_(order_.size()) {
+    for (std::size_t level = 0; level < order_.size(); ++level) {
+      levels_[order_[level]] = level;
+    }
+  }
+
+  /// Build `truth` over the first `vars` variables, respecting the view's order.
+  std::uint32_t build_ordered(std::uint64_t truth, std::uint32_t vars) {
+    std::vector<std::uint32_t> order;
+    for (std::uint32_t v : order_) {
+      if (v < vars) order.push_back(v);
+    }
+    return build(truth, order);
+  }
+
+  std::size_t variable_count() const { return order_.size(); }
+  std::size_t variable_level(std::size_t index) const { return levels_[index]; }
+
+ private:
+  std::vector<std::uint32_t> order_;
+  std::vector<std::size_t> levels_;
+};
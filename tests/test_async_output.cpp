@@ -0,0 +1,207 @@
+/**
+ * @file test_async_output.cpp
+ * @brief Unit tests for the background output writer.
+ *
+ * @details
+ * This test suite validates:
+ * - Output reaches the target stream in order for any buffer size and count.
+ * - Flushing waits until the written text has reached the target.
+ * - Files are written with and without `O_DIRECT`.
+ * - Renderers produce the same text through an `async_ostream`.
+ * - Writer errors are reported by `close()`.
+ * - gzip output decompresses to the original text when zlib is available, also
+ *   after a flush before the stream is closed.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/render_json.hpp>
+#include <dagir/utility/async_output.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(DAGIR_HAS_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+using dagir::utility::async_ostream;
+using dagir::utility::async_output_options;
+
+namespace {
+
+/// Output file path removed at scope exit.
+struct temp_file {
+  fs::path path;
+  explicit temp_file(const std::string& name)
+      : path(fs::temp_directory_path() / ("dagir_" + name + "_" +
+                                          std::to_string(std::chrono::steady_clock::now()
+                                                             .time_since_epoch()
+                                                             .count()))) {}
+  ~temp_file() {
+    std::error_code ec;
+    fs::remove(path, ec);
+  }
+};
+
+std::string read_file(const fs::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+/// Mixed single characters, short strings and writes larger than a buffer.
+std::string write_sample(std::ostream& os) {
+  std::string expected;
+  for (int i = 0; i < 20000; ++i) {
+    os << i << ' ';
+    expected += std::to_string(i) + ' ';
+    if (i % 997 == 0) {
+      const std::string block(3 * dagir::utility::k_output_alignment + i % 13, 'a' + i % 26);
+      os << block;
+      expected += block;
+    }
+  }
+  return expected;
+}
+
+}  // namespace
+
+TEST_CASE("async_ostream writes to the target in order", "[async_output]") {
+  for (std::size_t buffers : {2, 3, 8}) {
+    for (std::size_t buffer_size : {std::size_t{1}, std::size_t{1} << 16}) {
+      std::ostringstream target;
+      async_ostream os(target, async_output_options{buffer_size, buffers});
+      const std::string expected = write_sample(os);
+      os.close();
+      REQUIRE(os.good());
+      REQUIRE(target.str() == expected);
+    }
+  }
+}
+
+TEST_CASE("async_ostream flush reaches the target", "[async_output]") {
+  std::ostringstream target;
+  async_ostream os(target);
+  os << "digraph G {" << std::flush;
+  REQUIRE(target.str() == "digraph G {");
+  os << "}\n";
+  os.close();
+  REQUIRE(target.str() == "digraph G {}\n");
+  os << "late";
+  REQUIRE(os.bad());
+}
+
+TEST_CASE("async_ostream writes files with and without O_DIRECT", "[async_output]") {
+  for (bool direct_io : {false, true}) {
+    temp_file file("async_output");
+    async_output_options options;
+    options.buffer_size = 2 * dagir::utility::k_output_alignment;
+    options.direct_io = direct_io;
+    std::string expected;
+    {
+      async_ostream os(file.path, options);
+      expected = write_sample(os);
+      os.close();
+    }
+    REQUIRE(read_file(file.path) == expected);
+  }
+  REQUIRE_THROWS_AS(async_ostream(fs::path("/nonexistent_dagir_dir/out.txt")),
+                    fs::filesystem_error);
+}
+
+TEST_CASE("renderers write the same text through async_ostream", "[async_output]") {
+  dagir::ir_graph g;
+  for (std::uint64_t i = 0; i < 5000; ++i) {
+    g.nodes.push_back({i, {{dagir::ir_attrs::k_label, "x" + std::to_string(i)}}});
+    if (i > 0) g.edges.push_back({i - 1, i, {{dagir::ir_attrs::k_style, "dashed"}}});
+  }
+  std::ostringstream direct;
+  dagir::render_json(direct, g);
+
+  std::ostringstream target;
+  async_ostream os(target, async_output_options{dagir::utility::k_output_alignment});
+  dagir::render_json(os, g);
+  os.close();
+  REQUIRE(target.str() == direct.str());
+}
+
+TEST_CASE("async_ostream close reports writer errors", "[async_output]") {
+  std::ostringstream target;
+  target.setstate(std::ios_base::badbit);
+  async_ostream os(target, async_output_options{1});
+  for (int i = 0; i < 10000 && os; ++i) os << "line " << i << "\n";
+  REQUIRE_THROWS_AS(os.close(), std::ios_base::failure);
+  REQUIRE(os.bad());
+  REQUIRE_NOTHROW(os.close());
+}
+
+#if defined(DAGIR_HAS_ZLIB)
+TEST_CASE("async_ostream gzip output decompresses to the input", "[async_output]") {
+  std::ostringstream target;
+  async_output_options options;
+  options.buffer_size = dagir::utility::k_output_alignment;
+  options.gzip = true;
+  async_ostream os(target, options);
+  const std::string expected = write_sample(os);
+  os.close();
+
+  const std::string compressed = target.str();
+  REQUIRE(compressed.size() < expected.size());
+  REQUIRE(static_cast<unsigned char>(compressed[0]) == 0x1f);
+  REQUIRE(static_cast<unsigned char>(compressed[1]) == 0x8b);
+
+  z_stream zs{};
+  REQUIRE(inflateInit2(&zs, 15 + 16) == Z_OK);
+  std::string inflated(expected.size() + 1, '\0');
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  zs.avail_in = static_cast<uInt>(compressed.size());
+  zs.next_out = reinterpret_cast<Bytef*>(inflated.data());
+  zs.avail_out = static_cast<uInt>(inflated.size());
+  REQUIRE(inflate(&zs, Z_FINISH) == Z_STREAM_END);
+  inflated.resize(zs.total_out);
+  inflateEnd(&zs);
+  REQUIRE(inflated == expected);
+}
+
+TEST_CASE("async_ostream gzip flush makes the output decompressible", "[async_output]") {
+  std::ostringstream target;
+  async_output_options options;
+  options.gzip = true;
+  async_ostream os(target, options);
+  os << "digraph G {" << std::flush;
+
+  const std::string compressed = target.str();
+  z_stream zs{};
+  REQUIRE(inflateInit2(&zs, 15 + 16) == Z_OK);
+  std::string inflated(64, '\0');
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+  zs.avail_in = static_cast<uInt>(compressed.size());
+  zs.next_out = reinterpret_cast<Bytef*>(inflated.data());
+  zs.avail_out = static_cast<uInt>(inflated.size());
+  REQUIRE(inflate(&zs, Z_SYNC_FLUSH) == Z_OK);
+  inflated.resize(zs.total_out);
+  inflateEnd(&zs);
+  REQUIRE(inflated == "digraph G {");
+
+  os << "}\n";
+  os.close();
+  REQUIRE(target.str().size() > compressed.size());
+}
+#else
+TEST_CASE("async_ostream rejects gzip without zlib", "[async_output]") {
+  std::ostringstream target;
+  async_output_options options;
+  options.gzip = true;
+  REQUIRE_THROWS_AS(async_ostream(target, options), std::invalid_argument);
+}
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file test_bdd_cubes.cpp
+ * @brief Unit tests for lazy cube enumeration and uniform model sampling.
+ *
+ * @details
+ * This test suite validates:
+ * - The cubes of random truth tables are disjoint and cover exactly the
+ *   models, with skipped levels reported as don't-cares.
+ * - Enumeration can stop early (`first_cubes`) and the iterator interface
+ *   yields the same cubes as `next()`.
+ * - `bdd_sampler` only draws models, and draws them uniformly.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/bdd_cubes.hpp>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "mock_bdd.hpp"
+
+using dagir::bdd_cube;
+using dagir::cube_literal;
+
+namespace {
+
+/// Truth-table bits (over the cube's variables) covered by `cube`.
+std::uint64_t cube_minterms(const bdd_cube& cube) {
+  std::uint64_t covered = 0;
+  for (std::uint32_t a = 0; a < (1u << cube.size()); ++a) {
+    bool in = true;
+    for (std::size_t v = 0; v < cube.size(); ++v) {
+      const bool bit = (a >> v) & 1u;
+      if ((cube[v] == cube_literal::zero && bit) || (cube[v] == cube_literal::one && !bit)) {
+        in = false;
+      }
+    }
+    if (in) covered |= std::uint64_t{1} << a;
+  }
+  return covered;
+}
+
+}  // namespace
+
+TEST_CASE("bdd_cube_enumerator - cubes partition the models", "[bdd_cubes]") {
+  std::mt19937_64 rng(5);
+  for (int trial = 0; trial < 30; ++trial) {
+    const std::uint64_t truth = rng() & rng();
+    MockBddView view;
+    view.add_root(view.build(truth, 6));
+    const auto table = dagir::flatten_bdd(view);
+    REQUIRE(table.variable_count <= 6);
+
+    std::uint64_t covered = 0;
+    dagir::bdd_cube_enumerator cubes(table);
+    while (cubes.next()) {
+      const std::uint64_t m = cube_minterms(cubes.cube());
+      REQUIRE((covered & m) == 0);
+      covered |= m;
+    }
+    REQUIRE_FALSE(cubes.next());
+    const std::uint64_t mask = table.variable_count == 6
+                                   ? ~std::uint64_t{0}
+                                   : (std::uint64_t{1} << (1u << table.variable_count)) - 1;
+    REQUIRE(covered == (truth & mask));
+  }
+}
+
+TEST_CASE("bdd_cube_enumerator - don't-cares, early stop and iteration", "[bdd_cubes]") {
+  MockBddView view;
+  // (x1 AND x4) OR (NOT x1 AND x3) over six variables.
+  const std::uint32_t x4 = view.make_node(4, 0, 1);
+  const std::uint32_t x3 = view.make_node(3, 0, 1);
+  view.add_root(view.make_node(1, x3, x4));
+  view.add_root(0);
+  view.add_root(view.make_node(5, 0, 1));  // fixes variable_count at 6
+  const auto table = dagir::flatten_bdd(view);
+
+  const auto all = dagir::first_cubes(table, 100);
+  REQUIRE(all.size() == 2);
+  const auto X = cube_literal::dont_care;
+  REQUIRE(all[0] == bdd_cube{X, cube_literal::zero, X, cube_literal::one, X, X});
+  REQUIRE(all[1] == bdd_cube{X, cube_literal::one, X, X, cube_literal::one, X});
+
+  REQUIRE(dagir::first_cubes(table, 1).size() == 1);
+  REQUIRE(dagir::first_cubes(table, 0).empty());
+  REQUIRE(dagir::first_cubes(table, 5, 1).empty());
+  REQUIRE_THROWS_AS(dagir::bdd_cube_enumerator(table, 3), std::invalid_argument);
+
+  dagir::bdd_cube_enumerator cubes(table);
+  std::vector<bdd_cube> iterated;
+  for (const bdd_cube& c : cubes) iterated.push_back(c);
+  REQUIRE(iterated == all);
+}
+
+TEST_CASE("bdd_sampler - draws models uniformly", "[bdd_cubes]") {
+  MockBddView view;
+  // Six models of very different path weight over five variables.
+  const std::uint64_t truth = (1ull << 0) | (1ull << 7) | (1ull << 12) | (1ull << 13) |
+                              (1ull << 29) | (1ull << 31);
+  view.add_root(view.build(truth, 5));
+  view.add_root(0);
+  const auto table = dagir::flatten_bdd(view);
+
+  dagir::bdd_sampler sampler(table);
+  REQUIRE(sampler.satisfiable());
+  std::mt19937_64 rng(3);
+  std::map<std::uint64_t, int> hits;
+  const int samples = 60000;
+  for (int i = 0; i < samples; ++i) {
+    const auto row = sampler.sample(rng);
+    REQUIRE(row.size() == 1);
+    REQUIRE(dagir::evaluate_bdd(table, table.roots[0], row.data()));
+    ++hits[row[0] & 31u];
+  }
+  REQUIRE(hits.size() == static_cast<std::size_t>(std::popcount(truth)));
+  for (const auto& [model, n] : hits) {
+    REQUIRE(n > samples / 6 - 600);
+    REQUIRE(n < samples / 6 + 600);
+  }
+
+  dagir::bdd_sampler empty(table, 1);
+  REQUIRE_FALSE(empty.satisfiable());
+  REQUIRE_THROWS_AS(empty.sample(rng), std::logic_error);
+  REQUIRE_THROWS_AS(dagir::bdd_sampler(table, 2), std::invalid_argument);
+}
+
+TEST_CASE("bdd_sampler - free variables above and between levels", "[bdd_cubes]") {
+  MockBddView view;
+  // x2 over 70 variables: every other variable is free.
+  view.add_root(view.make_node(2, 0, 1));
+  view.add_root(view.make_node(69, 0, 1));
+  const auto table = dagir::flatten_bdd(view);
+  REQUIRE(table.words_per_assignment() == 2);
+
+  dagir::bdd_sampler sampler(table);
+  std::mt19937_64 rng(9);
+  int x0 = 0, x65 = 0;
+  for (int i = 0; i < 4000; ++i) {
+    const auto row = sampler.sample(rng);
+    REQUIRE(((row[0] >> 2) & 1u) == 1u);
+    x0 += static_cast<int>(row[0] & 1u);
+    x65 += static_cast<int>((row[1] >> 1) & 1u);
+  }
+  REQUIRE(x0 > 1700);
+  REQUIRE(x0 < 2300);
+  REQUIRE(x65 > 1700);
+  REQUIRE(x65 < 2300);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file test_bdd_sat_count.cpp
+ * @brief Unit tests for BDD model counting and the wide counting integers.
+ *
+ * @details
+ * This test suite validates:
+ * - `sat_count` matches the popcount of random truth tables for every count
+ *   type, with index order and with an explicit variable order.
+ * - Variables skipped between levels, above the root and outside the
+ *   diagram's support are counted as free.
+ * - `uint128` detects overflow and `big_uint` formats large powers of two.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/bdd_sat_count.hpp>
+#include <dagir/big_uint.hpp>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mock_bdd.hpp"
+
+using dagir::big_uint;
+using dagir::uint128;
+
+TEST_CASE("uint128 and big_uint - arithmetic and formatting", "[bdd_sat_count]") {
+  REQUIRE(to_string(uint128{1} << 64) == "18446744073709551616");
+  REQUIRE(to_string((uint128{1} << 100) + uint128{5}) == "1267650600228229401496703205381");
+  REQUIRE(to_string(uint128{~0ull, ~0ull}) == "340282366920938463463374607431768211455");
+  REQUIRE_THROWS_AS(uint128{1} << 128, std::overflow_error);
+  REQUIRE_THROWS_AS((uint128{~0ull, ~0ull} + uint128{1}), std::overflow_error);
+  REQUIRE((uint128{1} << 70) > (uint128{1} << 69));
+
+  REQUIRE(to_string(big_uint{}) == "0");
+  REQUIRE(to_string(big_uint{1} << 200) ==
+          "1606938044258990275541962092341162602522202993782792835301376");
+  REQUIRE(to_string((big_uint{1} << 64) + big_uint{~0ull}) == "36893488147419103231");
+  REQUIRE(to_string(big_uint{1000000000ull}) == "1000000000");
+}
+
+TEST_CASE("sat_count - matches truth-table popcount", "[bdd_sat_count]") {
+  std::mt19937_64 rng(11);
+  for (int trial = 0; trial < 20; ++trial) {
+    const std::uint64_t truth = rng();
+    const auto expected = static_cast<std::uint64_t>(std::popcount(truth));
+
+    MockBddView plain;
+    plain.add_root(plain.build(truth, 6));
+    const auto table = dagir::flatten_bdd(plain);
+    REQUIRE(dagir::sat_count<std::uint64_t>(table) == expected);
+    REQUIRE(dagir::sat_count<double>(table) == static_cast<double>(expected));
+    REQUIRE(dagir::sat_count<uint128>(table) == uint128{expected});
+    REQUIRE(dagir::sat_count(plain) == big_uint{expected});
+
+    // Random variable order plus two variables outside the support.
+    std::vector<std::uint32_t> order{0, 1, 2, 3, 4, 5, 6, 7};
+    std::shuffle(order.begin(), order.end(), rng);
+    MockOrderedBddView ordered(order);
+    ordered.add_root(ordered.build_ordered(truth, 6));
+    REQUIRE(dagir::sat_count<std::uint64_t>(ordered) == expected * 4);
+  }
+}
+
+TEST_CASE("sat_count - skipped levels and constant roots", "[bdd_sat_count]") {
+  MockBddView view;
+  // x1 AND x4 over six variables: x0, x2, x3 and x5 are free.
+  const std::uint32_t x4 = view.make_node(4, 0, 1);
+  view.add_root(view.make_node(1, 0, x4));
+  view.add_root(0);
+  view.add_root(1);
+  view.add_root(view.make_node(5, 0, 1));  // fixes variable_count at 6
+
+  const auto table = dagir::flatten_bdd(view);
+  REQUIRE(table.variable_count == 6);
+  REQUIRE(dagir::sat_count<std::uint64_t>(table, 0) == 16);
+  REQUIRE(dagir::sat_count<std::uint64_t>(table, 1) == 0);
+  REQUIRE(dagir::sat_count<std::uint64_t>(table, 2) == 64);
+  REQUIRE(dagir::sat_count<std::uint64_t>(table, 3) == 32);
+  REQUIRE_THROWS_AS(dagir::sat_count<std::uint64_t>(table, 4), std::invalid_argument);
+
+  const auto counts = dagir::bdd_node_counts<std::uint64_t>(table);
+  REQUIRE(counts[dagir::bdd_table::k_false] == 0);
+  REQUIRE(counts[dagir::bdd_table::k_true] == 1);
+  REQUIRE(counts[table.roots[0]] == 8);  // levels 1..5 with x1 = x4 = 1
+}
+
+TEST_CASE("sat_count - wide results", "[bdd_sat_count]") {
+  std::vector<std::uint32_t> order(130);
+  std::iota(order.begin(), order.end(), 0u);
+  MockOrderedBddView view(order);
+  view.add_root(view.build(0b10, 1));  // x0 over 130 variables: 2^129 models
+
+  REQUIRE_THROWS_AS(dagir::sat_count<std::uint64_t>(view), std::overflow_error);
+  REQUIRE_THROWS_AS(dagir::sat_count<uint128>(view), std::overflow_error);
+  REQUIRE(to_string(dagir::sat_count(view)) == "680564733841876926926749214863536422912");
+
+  const auto table = dagir::flatten_bdd(view);
+  REQUIRE(table.levels.size() == 130);
+}
+
+TEST_CASE("bdd_node_counts - rejects children above their parent", "[bdd_sat_count]") {
+  MockBddView view;
+  const std::uint32_t x0 = view.make_node(0, 0, 1);
+  view.add_root(view.make_node(1, x0, 1));
+  REQUIRE_THROWS_AS(dagir::sat_count<std::uint64_t>(view), std::invalid_argument);
+}
@@ -18,7 +18,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <dagir/algorithms.hpp>
 #include <dagir/build_ir.hpp>
+#include <dagir/render_dot.hpp>
 #include <format>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "mock_dag.hpp"
 
@@ -94,3 +98,114 @@ TEST_CASE("build_ir - custom node attributor and edge attributes", "[build_ir]")
   REQUIRE(found01);
   REQUIRE(found02);
 }
+
+namespace {
+
+// Complete binary tree: node i -> {2i + 1, 2i + 2} for `count` nodes.
+MockDagView binary_tree(std::size_t count) {
+  std::vector<std::vector<MockHandle>> adj(count);
+  for (std::size_t i = 0; 2 * i + 2 < count; ++i) {
+    adj[i] = {MockHandle{2 * i + 1}, MockHandle{2 * i + 2}};
+  }
+  return MockDagView({MockHandle{0}}, std::move(adj));
+}
+
+// Counts `children()` calls to check that the budget bounds the traversal.
+struct counting_view {
+  using handle = MockHandle;
+  const MockDagView* base;
+  std::size_t* calls;
+  auto children(handle h) const {
+    ++*calls;
+    return base->children(h);
+  }
+  auto roots() const { return base->roots(); }
+};
+
+std::vector<const dagir::ir_node*> summaries(const dagir::ir_graph& ir) {
+  std::vector<const dagir::ir_node*> out;
+  for (const auto& n : ir.nodes) {
+    if (n.attributes.contains(dagir::ir_attrs::k_summary)) out.push_back(&n);
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST_CASE("build_ir - node budget replaces the rest by summaries", "[build_ir]") {
+  const MockDagView g = binary_tree(7);
+  dagir::build_ir_options options;
+  options.max_nodes = 3;
+  const auto ir = dagir::build_ir(g, options);
+
+  REQUIRE(ir.nodes.size() == 5);
+  REQUIRE(ir.edges.size() == 4);
+  const auto s = summaries(ir);
+  REQUIRE(s.size() == 2);
+  for (const auto* n : s) {
+    REQUIRE(n->id > 6);
+    REQUIRE(n->attributes.at(dagir::ir_attrs::k_summary) == "exact");
+    REQUIRE(n->attributes.at(dagir::ir_attrs::k_hidden_nodes) == "2");
+    REQUIRE(n->attributes.at(dagir::ir_attrs::k_hidden_depth) == "1");
+  }
+  REQUIRE(s[0]->attributes.at(dagir::ir_attrs::k_name) == "summary000");
+  REQUIRE(s[0]->attributes.at(dagir::ir_attrs::k_label) == "2 hidden, depth 1");
+}
+
+TEST_CASE("build_ir - depth limit keeps edges between admitted nodes", "[build_ir]") {
+  // 0 -> {1, 2}; 1 -> 2; 2 -> 3; 3 -> 4
+  const MockDagView g({MockHandle{0}}, {{MockHandle{1}, MockHandle{2}},
+                                        {MockHandle{2}},
+                                        {MockHandle{3}},
+                                        {MockHandle{4}},
+                                        {}});
+  dagir::build_ir_options options;
+  options.max_depth = 1;
+  const auto ir = dagir::build_ir(g, options);
+
+  REQUIRE(ir.nodes.size() == 4);
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> edges;
+  for (const auto& e : ir.edges) edges.emplace_back(e.source, e.target);
+  const auto s = summaries(ir);
+  REQUIRE(s.size() == 1);
+  // 1 -> 2 stays although 1 is at the limit; 3 and 4 hide below 2.
+  REQUIRE(edges == std::vector<std::pair<std::uint64_t, std::uint64_t>>{
+                       {0, 1}, {0, 2}, {1, 2}, {2, s[0]->id}});
+  REQUIRE(s[0]->attributes.at(dagir::ir_attrs::k_hidden_nodes) == "2");
+  REQUIRE(s[0]->attributes.at(dagir::ir_attrs::k_hidden_depth) == "2");
+}
+
+TEST_CASE("build_ir - budget bounds the traversal of a large view", "[build_ir]") {
+  const MockDagView g = binary_tree(100000);
+  std::size_t calls = 0;
+  const counting_view view{&g, &calls};
+  dagir::build_ir_options options;
+  options.max_nodes = 10;
+  options.summary_probe = 20;
+  const auto ir = dagir::build_ir(view, options);
+
+  REQUIRE(calls <= 2 * options.max_nodes + options.summary_probe);
+  const auto s = summaries(ir);
+  REQUIRE(s.size() == 6);
+  REQUIRE(s[0]->attributes.at(dagir::ir_attrs::k_summary) == "partial");
+  REQUIRE(s.back()->attributes.at(dagir::ir_attrs::k_label).ends_with("+"));
+}
+
+TEST_CASE("build_ir - budget edge cases", "[build_ir]") {
+  const MockDagView g = binary_tree(7);
+
+  // Without limits the output is identical to the unbudgeted overload.
+  std::ostringstream plain, budgeted;
+  dagir::render_dot(plain, dagir::build_ir(g));
+  dagir::render_dot(budgeted, dagir::build_ir(g, dagir::build_ir_options{}));
+  REQUIRE(plain.str() == budgeted.str());
+
+  // A zero budget leaves one summary for the roots.
+  dagir::build_ir_options none;
+  none.max_nodes = 0;
+  const auto ir = dagir::build_ir(g, none);
+  REQUIRE(ir.nodes.size() == 1);
+  REQUIRE(ir.edges.empty());
+  REQUIRE(ir.nodes[0].attributes.at(dagir::ir_attrs::k_hidden_nodes) == "7");
+  REQUIRE(ir.nodes[0].attributes.at(dagir::ir_attrs::k_hidden_depth) == "3");
+}
@@ -0,0 +1,44 @@
+/**
+ * @file test_byte_size.cpp
+ * @brief Unit tests for command-line byte counts.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <dagir/utility/byte_size.hpp>
+#include <limits>
+#include <stdexcept>
+
+using dagir::utility::parse_byte_size;
+
+TEST_CASE("parse_byte_size - plain counts and binary suffixes", "[byte_size]") {
+  REQUIRE(parse_byte_size("0") == 0);
+  REQUIRE(parse_byte_size("4096") == 4096);
+  REQUIRE(parse_byte_size("3K") == 3 * 1024);
+  REQUIRE(parse_byte_size("3k") == 3 * 1024);
+  REQUIRE(parse_byte_size("256M") == std::size_t{256} << 20);
+  REQUIRE(parse_byte_size("2G") == std::size_t{2} << 30);
+}
+
+TEST_CASE("parse_byte_size - rejects non-numbers", "[byte_size]") {
+  REQUIRE_THROWS_AS(parse_byte_size(""), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("M"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("lots"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("1.5G"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("-1"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("+1"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size(" 1"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("12abc"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse_byte_size("4KB"), std::invalid_argument);
+}
+
+TEST_CASE("parse_byte_size - rejects counts that overflow", "[byte_size]") {
+  REQUIRE(parse_byte_size("18446744073709551615") == std::numeric_limits<std::size_t>::max());
+  REQUIRE_THROWS_AS(parse_byte_size("18446744073709551616"), std::out_of_range);
+  REQUIRE_THROWS_AS(parse_byte_size("20000000000G"), std::out_of_range);
+  REQUIRE_THROWS_AS(parse_byte_size("17179869184G"), std::out_of_range);
+  REQUIRE(parse_byte_size("17179869183G") == std::size_t{17179869183} << 30);
+}
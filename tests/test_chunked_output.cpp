@@ -0,0 +1,118 @@
+/**
+ * @file tests/test_chunked_output.cpp
+ * @brief Unit tests for parallel chunked rendering
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/chunked_output.hpp>
+#include <dagir/ir.hpp>
+#include <dagir/render_dot.hpp>
+#include <dagir/render_json.hpp>
+#include <dagir/render_mermaid.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+/// Several chunks of nodes and edges with names, levels, styles and a shared sink.
+dagir::ir_graph large_graph() {
+  constexpr std::uint64_t n = 5 * dagir::k_render_chunk + 123;
+  dagir::ir_graph g;
+  g.global_attrs.emplace(dagir::ir_attrs::k_graph_label, "large");
+  for (std::uint64_t i = 0; i < n; ++i) {
+    dagir::ir_node node;
+    node.id = 3 * i;
+    node.attributes.emplace(dagir::ir_attrs::k_label, "v \"" + std::to_string(i % 97) + "\"");
+    node.attributes.emplace(dagir::ir_attrs::k_level, std::to_string(i / 1000));
+    node.attributes.emplace(dagir::ir_attrs::k_shape, i % 5 ? "circle" : "box");
+    if (i % 7 == 0) node.attributes.emplace(dagir::ir_attrs::k_fill_color, "lightgray");
+    if (i % 3 == 0) node.attributes.emplace("name", "node_" + std::to_string(i));
+    g.nodes.push_back(node);
+  }
+  for (std::uint64_t i = 0; i + 1 < n; ++i) {
+    g.edges.push_back({3 * i, 3 * (i + 1), {{dagir::ir_attrs::k_style, "solid"}}});
+    g.edges.push_back({3 * i, 3 * (n - 1), {{dagir::ir_attrs::k_style, "dashed"}}});
+  }
+  g.edges.back().attributes.emplace(dagir::ir_attrs::k_label, "last");
+  return g;
+}
+
+template <class Render>
+std::string rendered(Render&& render) {
+  std::ostringstream oss;
+  render(oss);
+  return oss.str();
+}
+
+}  // namespace
+
+TEST_CASE("write_chunked keeps element order for every thread count", "[chunked_output]") {
+  for (std::size_t count : {std::size_t{0}, std::size_t{1}, dagir::k_render_chunk + 1,
+                            37 * dagir::k_render_chunk + 5}) {
+    std::string expected;
+    for (std::size_t i = 0; i < count; ++i) expected += std::to_string(i) + ",";
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+      const std::string out = rendered([&](std::ostream& os) {
+        dagir::write_chunked(os, count, threads,
+                             [](std::ostream& o, std::size_t i) { o << i << ","; });
+      });
+      REQUIRE(out == expected);
+    }
+  }
+}
+
+TEST_CASE("write_chunked rethrows errors of the workers", "[chunked_output]") {
+  std::ostringstream oss;
+  REQUIRE_THROWS_AS(dagir::write_chunked(oss, 3 * dagir::k_render_chunk, 4,
+                                         [](std::ostream& o, std::size_t i) {
+                                           if (i == 2 * dagir::k_render_chunk + 1) {
+                                             throw std::out_of_range("element");
+                                           }
+                                           o << i;
+                                         }),
+                    std::out_of_range);
+}
+
+TEST_CASE("parallel renderers are byte-identical to serial output", "[chunked_output]") {
+  const dagir::ir_graph g = large_graph();
+
+  for (dagir::dot_options options : {dagir::dot_options{}, dagir::dot_options::fast()}) {
+    for (bool minified : {false, true}) {
+      options.minified = minified;
+      options.threads = 1;
+      const std::string serial =
+          rendered([&](std::ostream& os) { dagir::render_dot(os, g, options); });
+      options.threads = 4;
+      REQUIRE(rendered([&](std::ostream& os) { dagir::render_dot(os, g, options); }) == serial);
+    }
+  }
+
+  for (dagir::json_options options : {dagir::json_options{}, dagir::json_options{true, true}}) {
+    const std::string serial =
+        rendered([&](std::ostream& os) { dagir::render_json(os, g, options); });
+    options.threads = 3;
+    REQUIRE(rendered([&](std::ostream& os) { dagir::render_json(os, g, options); }) == serial);
+  }
+
+  for (dagir::mermaid_options options :
+       {dagir::mermaid_options{}, dagir::mermaid_options{true, true}}) {
+    const std::string serial =
+        rendered([&](std::ostream& os) { dagir::render_mermaid(os, g, options); });
+    options.threads = 8;
+    REQUIRE(rendered([&](std::ostream& os) { dagir::render_mermaid(os, g, options); }) == serial);
+  }
+}
+
+TEST_CASE("parallel render_dot reports dangling endpoints", "[chunked_output]") {
+  dagir::ir_graph g = large_graph();
+  g.edges.push_back({1, 0, {}});
+  dagir::dot_options options;
+  options.threads = 4;
+  std::ostringstream oss;
+  REQUIRE_THROWS_AS(dagir::render_dot(oss, g, options), std::out_of_range);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file test_expression_program.cpp
+ * @brief Unit tests for expression lowering (`compile_expression`) and generators.
+ *
+ * @details
+ * This test suite validates:
+ * - Instructions are emitted in topological order with correct use counts.
+ * - Structurally identical (including commuted) subtrees are interned.
+ * - Variables are numbered in first-seen order and pre-seeded maps are honoured.
+ * - Deep left-leaning chains are lowered without recursion.
+ * - The N-Queens generator produces the expected number of models.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/utility/expressions/expression_generators.hpp>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+#include <string>
+#include <vector>
+
+using dagir::utility::compile_expression;
+using dagir::utility::expression_opcode;
+using dagir::utility::expression_program;
+
+namespace {
+
+// Reference interpreter: bit `i` of `assignment` is the value of variable `i`.
+bool evaluate(const expression_program& program, std::uint64_t assignment) {
+  std::vector<bool> values(program.instructions.size());
+  for (std::size_t i = 0; i < program.instructions.size(); ++i) {
+    const auto& ins = program.instructions[i];
+    switch (ins.opcode) {
+      case expression_opcode::variable:
+        values[i] = (assignment >> ins.lhs) & 1u;
+        break;
+      case expression_opcode::op_not:
+        values[i] = !values[ins.lhs];
+        break;
+      case expression_opcode::op_and:
+        values[i] = values[ins.lhs] && values[ins.rhs];
+        break;
+      case expression_opcode::op_or:
+        values[i] = values[ins.lhs] || values[ins.rhs];
+        break;
+      case expression_opcode::op_xor:
+        values[i] = values[ins.lhs] != values[ins.rhs];
+        break;
+    }
+  }
+  return values[program.root];
+}
+
+}  // namespace
+
+TEST_CASE("compile_expression - operands precede users", "[expression_program]") {
+  auto expr = dagir::utility::parse_expression("NOT (a AND b) XOR c");
+  auto program = compile_expression(*expr);
+
+  REQUIRE(program.instructions.size() == 6);
+  REQUIRE(program.variable_count == 3);
+  for (std::size_t i = 0; i < program.instructions.size(); ++i) {
+    const auto& ins = program.instructions[i];
+    if (ins.opcode == expression_opcode::variable) continue;
+    REQUIRE(ins.lhs < i);
+    if (ins.opcode != expression_opcode::op_not) REQUIRE(ins.rhs < i);
+  }
+  REQUIRE(program.instructions[program.root].opcode == expression_opcode::op_xor);
+  REQUIRE(program.use_counts[program.root] == 1);
+}
+
+TEST_CASE("compile_expression - identical subtrees share a slot", "[expression_program]") {
+  auto expr = dagir::utility::parse_expression("(a AND b) OR (b AND a)");
+  auto program = compile_expression(*expr);
+
+  // a, b, (a AND b), OR
+  REQUIRE(program.instructions.size() == 4);
+  const auto& root = program.instructions[program.root];
+  REQUIRE(root.opcode == expression_opcode::op_or);
+  REQUIRE(root.lhs == root.rhs);
+  REQUIRE(program.use_counts[root.lhs] == 2);
+
+  // Each truth assignment still evaluates like the source expression.
+  for (std::uint64_t m = 0; m < 4; ++m) REQUIRE(evaluate(program, m) == (m == 3));
+}
+
+TEST_CASE("compile_expression - variables numbered in first-seen order", "[expression_program]") {
+  auto expr = dagir::utility::parse_expression("c OR a AND b OR c");
+  std::unordered_map<std::string, int> var_map;
+  compile_expression(*expr, var_map);
+  REQUIRE(var_map.size() == 3);
+  REQUIRE(var_map.at("c") == 0);
+  REQUIRE(var_map.at("a") == 1);
+  REQUIRE(var_map.at("b") == 2);
+
+  // Pre-seeded indices are kept.
+  std::unordered_map<std::string, int> seeded{{"b", 0}, {"a", 1}, {"c", 2}};
+  auto program = compile_expression(*expr, seeded);
+  REQUIRE(seeded.size() == 3);
+  REQUIRE(seeded.at("b") == 0);
+  REQUIRE(program.variable_count == 3);
+}
+
+TEST_CASE("compile_expression - deep left-leaning chain", "[expression_program]") {
+  constexpr int k_terms = 20000;
+  std::string text = "v0";
+  for (int i = 1; i < k_terms; ++i) text += " AND v" + std::to_string(i % 64);
+  auto expr = dagir::utility::parse_expression(text);
+
+  auto program = compile_expression(*expr);
+  REQUIRE(program.variable_count == 64);
+  // 64 variables plus one AND per term after the first.
+  REQUIRE(program.instructions.size() == 64 + (k_terms - 1));
+  REQUIRE(evaluate(program, ~std::uint64_t{0}));
+  REQUIRE_FALSE(evaluate(program, ~std::uint64_t{0} ^ (std::uint64_t{1} << 17)));
+}
+
+TEST_CASE("make_n_queens_expression - 4x4 board has two solutions", "[expression_program]") {
+  auto expr = dagir::utility::parse_expression(dagir::utility::make_n_queens_expression(4));
+  auto program = compile_expression(*expr);
+  REQUIRE(program.variable_count == 16);
+
+  int solutions = 0;
+  for (std::uint64_t m = 0; m < (std::uint64_t{1} << 16); ++m) {
+    if (evaluate(program, m)) ++solutions;
+  }
+  REQUIRE(solutions == 2);
+
+  REQUIRE(dagir::utility::make_n_queens_expression(1) == "(q_1_1)");
+  REQUIRE_THROWS_AS(dagir::utility::make_n_queens_expression(0), std::invalid_argument);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_expression_schedule.cpp
+ * @brief Unit tests for associative chain flattening and scheduling.
+ *
+ * @details
+ * This test suite validates:
+ * - `flatten_chains` absorbs single-use links of a same-opcode chain and
+ *   collects the leaves in source order.
+ * - Shared subexpressions and mixed opcodes terminate a chain.
+ * - `reduce_chain` combines all operands under every schedule, in the order
+ *   each schedule promises.
+ * - Operands that were not combined are dropped when `combine` throws.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/utility/expressions/expression_parser.hpp>
+#include <dagir/utility/expressions/expression_program.hpp>
+#include <dagir/utility/expressions/expression_schedule.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using dagir::utility::compile_expression;
+using dagir::utility::expression_opcode;
+using dagir::utility::expression_schedule;
+using dagir::utility::flatten_chains;
+using dagir::utility::reduce_chain;
+
+namespace {
+
+// Combines strings into a parenthesized trace so the schedule is observable.
+std::string reduce_trace(std::vector<std::string> operands, expression_schedule schedule) {
+  return reduce_chain(
+      std::move(operands), schedule,
+      [](std::string a, std::string b) { return "(" + a + b + ")"; },
+      [](const std::string& s) { return s.size(); }, [](std::string&) {});
+}
+
+}  // namespace
+
+TEST_CASE("flatten_chains - left-deep chain becomes one n-ary node", "[expression_schedule]") {
+  auto program = compile_expression(*dagir::utility::parse_expression("a AND b AND c AND d"));
+  auto chains = flatten_chains(program);
+
+  const auto& root = program.instructions[program.root];
+  REQUIRE(root.opcode == expression_opcode::op_and);
+  REQUIRE_FALSE(chains.absorbed[program.root]);
+
+  std::size_t absorbed = 0;
+  for (bool a : chains.absorbed) absorbed += a ? 1 : 0;
+  REQUIRE(absorbed == 2);
+
+  const auto& leaves = chains.operands[program.root];
+  REQUIRE(leaves.size() == 4);
+  for (std::size_t i = 0; i < leaves.size(); ++i) {
+    REQUIRE(program.instructions[leaves[i]].opcode == expression_opcode::variable);
+    REQUIRE(program.instructions[leaves[i]].lhs == i);
+  }
+}
+
+TEST_CASE("flatten_chains - shared links and mixed opcodes stop a chain",
+          "[expression_schedule]") {
+  // (a AND b) is used twice, so it stays a separate chain root.
+  auto program =
+      compile_expression(*dagir::utility::parse_expression("(a AND b) AND c AND (a AND b OR d)"));
+  auto chains = flatten_chains(program);
+
+  const auto& leaves = chains.operands[program.root];
+  REQUIRE(leaves.size() == 3);
+  REQUIRE(program.instructions[leaves[0]].opcode == expression_opcode::op_and);
+  REQUIRE(program.instructions[leaves[1]].opcode == expression_opcode::variable);
+  REQUIRE(program.instructions[leaves[2]].opcode == expression_opcode::op_or);
+  REQUIRE_FALSE(chains.absorbed[leaves[0]]);
+  REQUIRE(chains.operands[leaves[0]].size() == 2);
+}
+
+TEST_CASE("flatten_chains - very long chain", "[expression_schedule]") {
+  constexpr int k_terms = 20000;
+  std::string text = "v0";
+  for (int i = 1; i < k_terms; ++i) text += " OR v" + std::to_string(i % 64);
+  auto program = compile_expression(*dagir::utility::parse_expression(text));
+  auto chains = flatten_chains(program);
+  REQUIRE(chains.operands[program.root].size() == k_terms);
+}
+
+TEST_CASE("reduce_chain - schedules combine every operand", "[expression_schedule]") {
+  const std::vector<std::string> ops{"a", "b", "c", "d", "e"};
+  REQUIRE(reduce_trace(ops, expression_schedule::in_order) == "((((ab)c)d)e)");
+  REQUIRE(reduce_trace(ops, expression_schedule::balanced) == "(((ab)(cd))e)");
+  // Smallest two first, ties broken by insertion order.
+  REQUIRE(reduce_trace(ops, expression_schedule::smallest_first) == "((cd)(e(ab)))");
+  REQUIRE(reduce_trace({"x"}, expression_schedule::balanced) == "x");
+  REQUIRE_THROWS_AS(reduce_trace({}, expression_schedule::in_order), std::invalid_argument);
+}
+
+TEST_CASE("reduce_chain - remaining operands are dropped on failure", "[expression_schedule]") {
+  for (auto schedule : {expression_schedule::in_order, expression_schedule::balanced,
+                        expression_schedule::smallest_first}) {
+    int live = 6;
+    int combines = 0;
+    auto combine = [&](int a, int b) {
+      live -= 2;  // inputs are always consumed
+      if (++combines == 3) throw std::runtime_error("out of memory");
+      ++live;
+      return a + b;
+    };
+    auto drop = [&](int&) { --live; };
+    REQUIRE_THROWS_AS(reduce_chain(std::vector<int>{1, 2, 3, 4, 5, 6}, schedule, combine,
+                                   [](int v) { return static_cast<std::size_t>(v); }, drop),
+                      std::runtime_error);
+    REQUIRE(live == 0);
+  }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file test_ir_compact.cpp
+ * @brief Unit tests for the output compaction helpers (`dagir/ir_compact.hpp`).
+ *
+ * @details
+ * This test suite validates:
+ * - Hoisting of the most common value of keys carried by every element.
+ * - Keys missing from an element and values that never repeat are not hoisted.
+ * - Short ids are unique and valid DOT identifiers.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <dagir/ir_compact.hpp>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("common_attributes - most common values of shared keys", "[ir_compact]") {
+  // 1000 elements; `shape` is mostly "box", `label` never repeats, `color`
+  // is missing on element 0, `fill` is "c0" on a third and cycles otherwise.
+  const std::size_t n = 1000;
+  auto list_of = [](std::size_t i) {
+    dagir::attr_list l;
+    l.emplace_back("label", std::to_string(i));
+    l.emplace_back("shape", i % 10 == 0 ? "circle" : "box");
+    l.emplace_back("fill", "c" + std::to_string(i % 3 == 0 ? 0 : i % 20));
+    if (i > 0) l.emplace_back("color", "red");
+    return l;
+  };
+  const dagir::attr_list defaults = dagir::common_attributes(n, list_of);
+  REQUIRE(defaults == dagir::attr_list{{"fill", "c0"}, {"shape", "box"}});
+  REQUIRE(dagir::is_default(defaults, "shape", "box"));
+  REQUIRE_FALSE(dagir::is_default(defaults, "shape", "circle"));
+  REQUIRE_FALSE(dagir::is_default(defaults, "color", "red"));
+
+  REQUIRE(dagir::common_attributes(0, list_of).empty());
+  REQUIRE(dagir::common_attributes(1, list_of).empty());
+}
+
+TEST_CASE("compact_id - short unique identifiers", "[ir_compact]") {
+  REQUIRE(dagir::compact_id(0) == "_0");
+  REQUIRE(dagir::compact_id(61) == "_Z");
+  REQUIRE(dagir::compact_id(62) == "_10");
+  std::unordered_set<std::string> seen;
+  for (std::size_t i = 0; i < 100000; ++i) {
+    const std::string id = dagir::compact_id(i);
+    REQUIRE(id.size() <= 4);
+    REQUIRE(seen.insert(id).second);
+  }
+}
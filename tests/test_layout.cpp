@@ -0,0 +1,188 @@
+/**
+ * @file test_layout.cpp
+ * @brief Unit tests for the layered layout and the SVG renderer.
+ *
+ * @details
+ * This test suite validates:
+ * - Longest-path layering, `level` hints and compaction of empty layers.
+ * - Barycentric crossing reduction and crossing counts.
+ * - Thread-count independence of parallel sweeps and random restarts.
+ * - Non-overlapping coordinates on a larger random DAG.
+ * - SVG output structure, styles and escaping.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/build_ir.hpp>
+#include <dagir/layout.hpp>
+#include <dagir/render_svg.hpp>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mock_bdd.hpp"
+
+namespace {
+
+dagir::ir_graph make_graph(std::size_t n,
+                           const std::vector<std::pair<std::uint64_t, std::uint64_t>>& edges) {
+  dagir::ir_graph g;
+  for (std::uint64_t i = 0; i < n; ++i) {
+    g.nodes.push_back({i, {{dagir::ir_attrs::k_label, std::to_string(i)}}});
+  }
+  for (const auto& [s, t] : edges) g.edges.push_back({s, t, {}});
+  return g;
+}
+
+std::size_t count_of(const std::string& haystack, const std::string& needle) {
+  std::size_t count = 0;
+  for (auto pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_CASE("layered_layout - longest-path layers and level hints", "[layout]") {
+  // 0 -> 1 -> 2 and 0 -> 2: node 2 sits below 1.
+  const auto g = make_graph(3, {{0, 1}, {1, 2}, {0, 2}});
+  const auto l = dagir::layered_layout(g);
+  REQUIRE(l.layer == std::vector<std::size_t>{0, 1, 2});
+  REQUIRE(l.layers.size() == 3);
+  REQUIRE(l.y[0] < l.y[1]);
+  REQUIRE(l.y[1] < l.y[2]);
+
+  // Level hints are honoured and unused levels are compacted away.
+  auto hinted = make_graph(3, {{0, 1}, {0, 2}});
+  hinted.nodes[2].attributes[dagir::ir_attrs::k_level] = "7";
+  const auto h = dagir::layered_layout(hinted);
+  REQUIRE(h.layer == std::vector<std::size_t>{0, 1, 2});
+
+  // A hint above a parent is raised below it.
+  hinted.nodes[1].attributes[dagir::ir_attrs::k_level] = "0";
+  REQUIRE(dagir::layered_layout(hinted).layer[1] == 1);
+
+  REQUIRE_THROWS_AS(dagir::layered_layout(make_graph(2, {{0, 1}, {1, 0}})), std::runtime_error);
+}
+
+TEST_CASE("layered_layout - crossing reduction", "[layout]") {
+  // 1 -> 4 crosses 2 -> 3 in the initial (discovery) order of layer {3, 4}.
+  const auto g = make_graph(5, {{0, 1}, {0, 2}, {1, 4}, {2, 3}, {2, 4}});
+  dagir::layout_options none;
+  none.sweeps = 0;
+  REQUIRE(dagir::layered_layout(g, none).crossings == 1);
+  const auto l = dagir::layered_layout(g);
+  REQUIRE(l.crossings == 0);
+  REQUIRE((l.x[1] < l.x[2]) == (l.x[4] < l.x[3]));
+}
+
+TEST_CASE("layered_layout - random DAG stays non-overlapping", "[layout]") {
+  std::mt19937_64 rng(7);
+  const std::size_t n = 2000;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> edges;
+  for (std::uint64_t v = 1; v < n; ++v) {
+    for (int k = 0; k < 2; ++k) edges.emplace_back(rng() % v, v);
+  }
+  const auto g = make_graph(n, edges);
+  dagir::layout_options none;
+  none.sweeps = 0;
+  const auto initial = dagir::layered_layout(g, none);
+  const auto l = dagir::layered_layout(g);
+  REQUIRE(l.crossings < initial.crossings);
+
+  const dagir::layout_options defaults;
+  for (const auto& layer : l.layers) {
+    for (std::size_t i = 0; i + 1 < layer.size(); ++i) {
+      const std::size_t a = layer[i];
+      const std::size_t b = layer[i + 1];
+      REQUIRE(l.x[b] - l.x[a] >= (l.width[a] + l.width[b]) / 2.0 + defaults.node_spacing - 1e-6);
+    }
+  }
+  for (std::size_t v = 0; v < n; ++v) {
+    REQUIRE(l.x[v] - l.width[v] / 2.0 >= defaults.margin - 1e-6);
+    REQUIRE(l.x[v] + l.width[v] / 2.0 <= l.canvas_width - defaults.margin + 1e-6);
+    REQUIRE(l.y[v] + l.height[v] / 2.0 <= l.canvas_height + 1e-6);
+  }
+}
+
+TEST_CASE("layered_layout - parallel sweeps and restarts", "[layout]") {
+  // Wide layers, so that layers are split among workers.
+  std::mt19937_64 rng(11);
+  const std::size_t width = 9000;
+  const std::size_t depth = 4;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> edges;
+  for (std::uint64_t r = 1; r < depth; ++r) {
+    for (std::uint64_t i = 0; i < width; ++i) {
+      for (int k = 0; k < 2; ++k) {
+        edges.emplace_back((r - 1) * width + rng() % width, r * width + i);
+      }
+    }
+  }
+  const auto g = make_graph(width * depth, edges);
+
+  dagir::layout_options options;
+  options.sweeps = 4;
+  const auto serial = dagir::layered_layout(g, options);
+  options.threads = 4;
+  const auto parallel = dagir::layered_layout(g, options);
+  REQUIRE(parallel.layers == serial.layers);
+  REQUIRE(parallel.crossings == serial.crossings);
+  REQUIRE(parallel.x == serial.x);
+
+  options.restarts = 3;
+  const auto restarted = dagir::layered_layout(g, options);
+  REQUIRE(restarted.crossings <= serial.crossings);
+  options.threads = 1;
+  const auto restarted_serial = dagir::layered_layout(g, options);
+  REQUIRE(restarted_serial.layers == restarted.layers);
+  REQUIRE(restarted_serial.crossings == restarted.crossings);
+}
+
+TEST_CASE("bdd_level_attributor - layers follow the variable order", "[layout]") {
+  // x0 & x2 over variables {0, 1, 2}: x1 is skipped.
+  MockOrderedBddView view({0, 1, 2});
+  view.add_root(view.build_ordered((1u << 5) | (1u << 7), 3));
+  auto no_attrs = [](const auto&, const auto&) { return dagir::ir_attr_map{}; };
+  const auto ir = dagir::build_ir(view, dagir::bdd_level_attributor{no_attrs},
+                                  [](auto&&...) { return dagir::ir_attr_map{}; });
+  std::vector<std::string> levels;
+  for (const auto& n : ir.nodes) levels.push_back(n.attributes.at(dagir::ir_attrs::k_level));
+  std::sort(levels.begin(), levels.end());
+  REQUIRE(levels == std::vector<std::string>{"0", "2", "3", "3"});
+  REQUIRE(dagir::layered_layout(ir).layers.size() == 3);
+}
+
+TEST_CASE("render_svg - structure, styles and escaping", "[layout]") {
+  auto g = make_graph(3, {{0, 1}, {0, 2}});
+  g.nodes[0].attributes[dagir::ir_attrs::k_label] = "a<b & \"c\"";
+  g.nodes[1].attributes[dagir::ir_attrs::k_shape] = "box";
+  g.nodes[2].attributes[dagir::ir_attrs::k_shape] = "circle";
+  g.edges[1].attributes[dagir::ir_attrs::k_style] = "dashed";
+  g.global_attrs[dagir::ir_attrs::k_graph_label] = "title";
+
+  std::ostringstream os;
+  dagir::render_svg(os, g);
+  const std::string svg = os.str();
+  REQUIRE(svg.starts_with("<svg xmlns=\"http://www.w3.org/2000/svg\""));
+  REQUIRE(svg.ends_with("</svg>\n"));
+  REQUIRE(count_of(svg, "<line ") == 2);
+  REQUIRE(count_of(svg, "stroke-dasharray") == 1);
+  REQUIRE(count_of(svg, "<rect ") == 1);
+  REQUIRE(count_of(svg, "<circle ") == 1);
+  REQUIRE(count_of(svg, "<ellipse ") == 1);
+  REQUIRE(svg.find("a&lt;b &amp; &quot;c&quot;") != std::string::npos);
+  REQUIRE(svg.find(">title</text>") != std::string::npos);
+
+  std::ostringstream empty;
+  dagir::render_svg(empty, dagir::ir_graph{});
+  REQUIRE(count_of(empty.str(), "<g>") == 0);
+}
@@ -0,0 +1,161 @@
+/**
+ * @file tests/test_load_dot.cpp
+ * @brief Unit tests for the DOT loader
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/load_dot.hpp>
+#include <dagir/render_dot.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifndef DAGIR_REGRESSION_DIR
+#define DAGIR_REGRESSION_DIR "tests/regression_tests"
+#endif
+
+namespace {
+
+std::string to_dot(const dagir::ir_graph& g, const dagir::dot_options& options = {},
+                   std::string_view name = "G") {
+  std::ostringstream oss;
+  dagir::render_dot(oss, g, options, name);
+  return oss.str();
+}
+
+/// Two levels over a shared sink; ids equal positions so generated names survive.
+dagir::ir_graph sample_graph() {
+  dagir::ir_graph g;
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    dagir::ir_node n;
+    n.id = i;
+    n.attributes.emplace(dagir::ir_attrs::k_label, i == 3 ? "1" : "x" + std::to_string(i));
+    n.attributes.emplace(dagir::ir_attrs::k_shape, i == 3 ? "box" : "circle");
+    n.attributes.emplace(dagir::ir_attrs::k_level, std::to_string(i == 0 ? 0 : 1));
+    if (i == 1) n.attributes.emplace(dagir::ir_attrs::k_id, "named \"one\"");
+    g.nodes.push_back(n);
+  }
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    g.edges.push_back({i, 3, {{dagir::ir_attrs::k_style, "dashed"}}});
+  }
+  g.edges.push_back({0, 1, {{dagir::ir_attrs::k_style, "solid"}}});
+  g.edges.push_back({0, 2, {{dagir::ir_attrs::k_style, "dashed"}}});
+  return g;
+}
+
+}  // namespace
+
+TEST_CASE("load_dot round-trips the regression DOT files", "[load_dot]") {
+  std::size_t files = 0;
+  for (const char* dir : {"expression_bdd_dot", "expression_tree_dot"}) {
+    for (const auto& entry :
+         std::filesystem::directory_iterator(std::filesystem::path(DAGIR_REGRESSION_DIR) / dir)) {
+      if (entry.path().extension() != ".dot") continue;
+      std::ifstream in(entry.path(), std::ios::binary);
+      const std::string text((std::istreambuf_iterator<char>(in)),
+                             std::istreambuf_iterator<char>());
+      // "digraph <name> {"
+      const std::size_t space = text.find(' ');
+      const std::string name = text.substr(space + 1, text.find(' ', space + 1) - space - 1);
+      INFO(entry.path().string());
+      REQUIRE(to_dot(dagir::load_dot(text).graph, {}, name) == text);
+      ++files;
+    }
+  }
+  REQUIRE(files > 0);
+}
+
+TEST_CASE("load_dot reads hoisted and minified output as the plain graph", "[load_dot]") {
+  const dagir::ir_graph g = sample_graph();
+  const std::string plain = to_dot(g);
+
+  dagir::dot_options hoisted;
+  hoisted.hoist_defaults = true;
+  REQUIRE(to_dot(dagir::load_dot(to_dot(g, hoisted)).graph) == plain);
+
+  dagir::dot_options minified = hoisted;
+  minified.minified = true;
+  REQUIRE(to_dot(dagir::load_dot(to_dot(g, minified)).graph) == plain);
+}
+
+TEST_CASE("load_dot maps rank subgraphs, sink copies and layout hints", "[load_dot]") {
+  const dagir::ir_graph g = sample_graph();
+  const dagir::ir_document doc = dagir::load_dot(to_dot(g, dagir::dot_options::fast()));
+
+  // The sink with three parents is written (and loaded) once per edge.
+  REQUIRE(doc.graph.nodes.size() == 6);
+  REQUIRE(doc.graph.edges.size() == 5);
+  for (std::size_t i = 3; i < 6; ++i) {
+    REQUIRE(doc.graph.nodes[i].attributes.at(dagir::ir_attrs::k_label) == "1");
+    REQUIRE(doc.graph.nodes[i].attributes.at(dagir::ir_attrs::k_name) ==
+            "n3_" + std::to_string(i - 3));
+  }
+  REQUIRE(doc.graph.nodes[0].attributes.at(dagir::ir_attrs::k_level) == "0");
+  REQUIRE(doc.graph.nodes[1].attributes.at(dagir::ir_attrs::k_level) == "1");
+  REQUIRE(doc.graph.nodes[2].attributes.at(dagir::ir_attrs::k_level) == "1");
+  REQUIRE(doc.graph.nodes[1].attributes.at(dagir::ir_attrs::k_id) == "named \"one\"");
+  REQUIRE(doc.graph.nodes[1].attributes.count(dagir::ir_attrs::k_name) == 0);
+  REQUIRE(doc.graph.global_attrs.at("splines") == "line");
+  REQUIRE(doc.graph.global_attrs.count(dagir::ir_attrs::k_rankdir) == 0);
+}
+
+TEST_CASE("load_dot reads hand-written DOT", "[load_dot]") {
+  const dagir::ir_document doc = dagir::load_dot(R"(# preprocessor line
+    /* block
+       comment */
+    strict DiGraph "my graph" {
+      graph [label = "multi" + "part", rankdir = LR]
+      node [shape=box]  // default for what follows
+      a -> b -> "c\x41" [color=red, weight=2.5]
+      b [label="left\ljustified\"\
+continued"];
+      subgraph cluster { node [shape=circle]; d; }
+      e
+    })");
+  REQUIRE(doc.graph.nodes.size() == 5);
+  REQUIRE(doc.graph.nodes[0].attributes.at(dagir::ir_attrs::k_name) == "a");
+  REQUIRE(doc.graph.nodes[0].attributes.at(dagir::ir_attrs::k_shape) == "box");
+  REQUIRE(doc.graph.nodes[1].attributes.at(dagir::ir_attrs::k_label) ==
+          "left\\ljustified\"continued");
+  REQUIRE(doc.graph.nodes[2].attributes.at(dagir::ir_attrs::k_name) == "cA");
+  REQUIRE(doc.graph.nodes[3].attributes.at(dagir::ir_attrs::k_shape) == "circle");
+  REQUIRE(doc.graph.nodes[4].attributes.at(dagir::ir_attrs::k_shape) == "box");
+  REQUIRE(doc.graph.edges.size() == 2);
+  REQUIRE(doc.graph.edges[1].source == 1);
+  REQUIRE(doc.graph.edges[1].target == 2);
+  REQUIRE(doc.graph.edges[1].attributes.at("color") == "red");
+  REQUIRE(doc.graph.edges[1].attributes.at("weight") == "2.5");
+  REQUIRE(doc.graph.global_attrs.at(dagir::ir_attrs::k_graph_label) == "multipart");
+  REQUIRE(doc.graph.global_attrs.at(dagir::ir_attrs::k_rankdir) == "LR");
+}
+
+TEST_CASE("load_dot rejects input outside the subset", "[load_dot]") {
+  const std::string dot = to_dot(sample_graph());
+  REQUIRE_THROWS_AS(dagir::load_dot(dot.substr(0, dot.size() - 2)), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot(dot + "}"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("graph { a -- b }"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph { a -- b }"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph { a [label = <<b>x</b>>] }"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph { a:p -> b }"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph { a -> {b c} }"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph { a [label = \"open] }"), std::runtime_error);
+}
+
+TEST_CASE("load_dot bounds subgraph nesting", "[load_dot]") {
+  const std::size_t limit = dagir::load_dot_detail::k_max_nesting;
+  const std::string ok = "digraph G {" + std::string(limit, '{') + "a" +
+                         std::string(limit, '}') + "}";
+  REQUIRE(dagir::load_dot(ok).graph.nodes.size() == 1);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph G {" + std::string(limit + 1, '{') + "a" +
+                                    std::string(limit + 1, '}') + "}"),
+                    std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_dot("digraph G {" + std::string(200000, '{')),
+                    std::runtime_error);
+}
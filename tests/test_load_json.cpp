@@ -0,0 +1,123 @@
+/**
+ * @file tests/test_load_json.cpp
+ * @brief Unit tests for the JSON loader
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/load_json.hpp>
+#include <dagir/render_cbor.hpp>
+#include <dagir/render_json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::string to_json(const dagir::ir_graph& g, const dagir::json_options& options = {}) {
+  std::ostringstream oss;
+  dagir::render_json(oss, g, options);
+  return oss.str();
+}
+
+/// Named nodes (so ids survive renumbering) with shared and odd attribute values.
+dagir::ir_graph sample_graph() {
+  dagir::ir_graph g;
+  g.global_attrs.emplace(dagir::ir_attrs::k_graph_label, "sample \"graph\"");
+  for (std::uint64_t i = 0; i < 6; ++i) {
+    dagir::ir_node n;
+    n.id = 10 * i;
+    n.attributes.emplace(dagir::ir_attrs::k_name, "node_" + std::to_string(i));
+    n.attributes.emplace(dagir::ir_attrs::k_label, "x\\" + std::to_string(i) + "\n\t\x01");
+    n.attributes.emplace(dagir::ir_attrs::k_shape, i == 5 ? "box" : "circle");
+    n.attributes.emplace("weight", i % 2 ? "-2.5" : "42");
+    g.nodes.push_back(n);
+  }
+  for (std::uint64_t i = 0; i + 1 < 6; ++i) {
+    dagir::ir_edge e;
+    e.source = 10 * i;
+    e.target = 10 * (i + 1);
+    e.attributes.emplace(dagir::ir_attrs::k_style, i == 2 ? "solid" : "dashed");
+    e.attributes.emplace("flag", i == 0 ? "null" : "true");
+    g.edges.push_back(e);
+  }
+  return g;
+}
+
+}  // namespace
+
+TEST_CASE("load_json reads render_json output back", "[load_json]") {
+  const dagir::ir_graph g = sample_graph();
+  const std::string json = to_json(g);
+  const dagir::ir_document doc = dagir::load_json(json);
+
+  REQUIRE(to_json(doc.graph) == json);
+  REQUIRE(doc.graph.nodes.size() == 6);
+  REQUIRE(doc.graph.nodes[3].id == 3);
+  REQUIRE(doc.graph.nodes[3].attributes.at(dagir::ir_attrs::k_label) == "x\\3\n\t\x01");
+  REQUIRE(doc.graph.nodes[3].attributes.at("weight") == "-2.5");
+  REQUIRE(doc.graph.edges[0].attributes.at("flag") == "null");
+  REQUIRE(doc.graph.edges[4].source == 4);
+  REQUIRE(doc.graph.edges[4].target == 5);
+  REQUIRE(doc.graph.global_attrs.at(dagir::ir_attrs::k_graph_label) == "sample \"graph\"");
+
+  // Same graph as the CBOR decoder builds.
+  std::ostringstream cbor;
+  dagir::render_cbor(cbor, g);
+  REQUIRE(to_json(dagir::decode_cbor(cbor.str()).graph) == json);
+}
+
+TEST_CASE("load_json applies hoisted defaults of minified output", "[load_json]") {
+  const dagir::ir_graph g = sample_graph();
+  const std::string compact = to_json(g, dagir::json_options{true, true});
+  REQUIRE(compact.find("\"defaults\"") != std::string::npos);
+
+  const dagir::ir_document doc = dagir::load_json(compact);
+  REQUIRE(to_json(doc.graph) == to_json(g));
+}
+
+TEST_CASE("load_json keeps exact labels, escapes and dangling endpoints", "[load_json]") {
+  const dagir::ir_document doc = dagir::load_json(R"({
+    "roots": ["a"],
+    "nodes": [
+      {"id": "a", "label": "007", "attributes": {"label": 7, "name": "a"}},
+      {"id": "b\u00e9", "label": "\ud83d\ude00"}
+    ],
+    "edges": [
+      {"source": "a", "target": "bé"},
+      {"target": "a", "source": "zz", "attributes": {"w": 1e3}},
+      {"source": "zz", "target": "yy"}
+    ]
+  })");
+  REQUIRE(doc.graph.nodes[0].attributes.at(dagir::ir_attrs::k_label) == "007");
+  REQUIRE(doc.graph.nodes[1].attributes.at(dagir::ir_attrs::k_label) == "\xf0\x9f\x98\x80");
+  REQUIRE(doc.graph.edges[0].target == 1);
+  REQUIRE(doc.graph.edges[1].source == 2);
+  REQUIRE(doc.graph.edges[1].attributes.at("w") == "1e3");
+  REQUIRE(doc.graph.edges[2].source == 2);
+  REQUIRE(doc.graph.edges[2].target == 3);
+}
+
+TEST_CASE("find_quote_or_escape agrees with a byte-wise scan", "[load_json]") {
+  for (std::size_t n = 0; n < 80; ++n) {
+    for (std::size_t at = 0; at <= n; ++at) {
+      std::string s(n, 'a');
+      if (at < n) s[at] = at % 2 ? '"' : '\\';
+      REQUIRE(dagir::load_json_detail::find_quote_or_escape(s.data(), s.size()) == at);
+    }
+  }
+}
+
+TEST_CASE("load_json rejects malformed input", "[load_json]") {
+  const std::string json = to_json(sample_graph());
+  REQUIRE_THROWS_AS(dagir::load_json(json.substr(0, json.size() - 1)), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_json(json + "}"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_json(R"({"nodes": [{"id": "a", "attributes": {"k": [1]}}]})"),
+                    std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_json(R"({"edges": [{"source": "a"}]})"), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::load_json(R"({"nodes": [{"id": "a\q"}]})"), std::runtime_error);
+}
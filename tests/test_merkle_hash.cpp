@@ -0,0 +1,126 @@
+/**
+ * @file test_merkle_hash.cpp
+ * @brief Unit tests for structural (Merkle) hashing of DAG views.
+ *
+ * @details
+ * This test suite validates:
+ * - Identical labelled subgraphs hash equally regardless of node identity.
+ * - Labels, child order and child count all change the hash.
+ * - Parallel hashing matches the serial result on a wide DAG.
+ * - BDDs built separately but representing the same function compare equal.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/merkle_hash.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mock_bdd.hpp"
+#include "mock_dag.hpp"
+
+using dagir::hash128;
+
+namespace {
+
+/// Label policy reading a per-node label from a table indexed by id.
+struct table_label {
+  const std::vector<std::string>* labels;
+  hash128 operator()(const MockDagView&, const MockHandle& h) const {
+    return dagir::hash_bytes((*labels)[h.id]);
+  }
+};
+
+}  // namespace
+
+TEST_CASE("hash_bytes - lengths and formatting", "[merkle_hash]") {
+  REQUIRE(dagir::hash_bytes("") != dagir::hash_bytes(std::string(1, '\0')));
+  REQUIRE(dagir::hash_bytes("abc") == dagir::hash_bytes("abc"));
+  REQUIRE(dagir::hash_bytes("abc") != dagir::hash_bytes("abd"));
+  REQUIRE(dagir::hash_bytes("abc", 1) != dagir::hash_bytes("abc", 2));
+  REQUIRE(dagir::hash_bytes(std::string(16, 'x')) != dagir::hash_bytes(std::string(17, 'x')));
+  REQUIRE(to_string(hash128{0xabc, 0x1}) == "00000000000000010000000000000abc");
+}
+
+TEST_CASE("merkle_hashes - identical subgraphs hash equally", "[merkle_hash]") {
+  // 0 -> {1, 2}; 1 -> 3; 2 -> 4; nodes 3 and 4 are both leaves labelled "leaf".
+  const std::vector<std::string> labels{"root", "mid", "mid", "leaf", "leaf"};
+  MockDagView g({MockHandle{0}}, {{MockHandle{1}, MockHandle{2}}, {MockHandle{3}}, {MockHandle{4}},
+                                  {}, {}});
+  const auto h = dagir::merkle_hashes(g, table_label{&labels});
+  REQUIRE(h.size() == 5);
+  REQUIRE(h.at(3) == h.at(4));
+  REQUIRE(h.at(1) == h.at(2));
+  REQUIRE(h.at(0) != h.at(1));
+
+  // The same graph with different node ids has the same graph hash.
+  const std::vector<std::string> relabelled{"leaf", "leaf", "mid", "mid", "root"};
+  MockDagView g2({MockHandle{4}}, {{}, {}, {MockHandle{1}}, {MockHandle{0}},
+                                   {MockHandle{3}, MockHandle{2}}});
+  REQUIRE(dagir::merkle_graph_hash(g2, table_label{&relabelled}) ==
+          dagir::merkle_graph_hash(g, table_label{&labels}));
+}
+
+TEST_CASE("merkle_hashes - labels, child order and arity matter", "[merkle_hash]") {
+  const std::vector<std::string> labels{"p", "a", "b"};
+  MockDagView ab({MockHandle{0}}, {{MockHandle{1}, MockHandle{2}}, {}, {}});
+  MockDagView ba({MockHandle{0}}, {{MockHandle{2}, MockHandle{1}}, {}, {}});
+  MockDagView aa({MockHandle{0}}, {{MockHandle{1}, MockHandle{1}}, {}, {}});
+  MockDagView a({MockHandle{0}}, {{MockHandle{1}}, {}, {}});
+  const hash128 h_ab = dagir::merkle_graph_hash(ab, table_label{&labels});
+  REQUIRE(h_ab != dagir::merkle_graph_hash(ba, table_label{&labels}));
+  REQUIRE(h_ab != dagir::merkle_graph_hash(aa, table_label{&labels}));
+  REQUIRE(dagir::merkle_graph_hash(aa, table_label{&labels}) !=
+          dagir::merkle_graph_hash(a, table_label{&labels}));
+
+  const std::vector<std::string> other{"p", "a", "c"};
+  REQUIRE(h_ab != dagir::merkle_graph_hash(ab, table_label{&other}));
+
+  MockDagView cycle({MockHandle{0}}, {{MockHandle{1}}, {MockHandle{0}}, {}});
+  REQUIRE_THROWS_AS(dagir::merkle_hashes(cycle, table_label{&labels}), std::runtime_error);
+}
+
+TEST_CASE("merkle_hashes - parallel matches serial", "[merkle_hash]") {
+  // Layered random DAG, 8 layers of 3000 nodes, few distinct labels.
+  constexpr std::size_t layers = 8, width = 3000;
+  std::mt19937_64 rng(17);
+  std::vector<std::vector<MockHandle>> adj(layers * width);
+  std::vector<std::string> labels(layers * width);
+  for (std::size_t i = 0; i < adj.size(); ++i) {
+    labels[i] = std::to_string(rng() % 4);
+    if (i / width + 1 < layers) {
+      const std::size_t next = (i / width + 1) * width;
+      for (int k = 0; k < 2; ++k) adj[i].push_back(MockHandle{next + rng() % width});
+    }
+  }
+  std::vector<MockHandle> roots;
+  for (std::size_t i = 0; i < width; ++i) roots.push_back(MockHandle{i});
+  MockDagView g(roots, adj);
+
+  const auto serial = dagir::merkle_hashes(g, table_label{&labels});
+  const auto parallel = dagir::merkle_hashes(g, table_label{&labels}, 4);
+  REQUIRE(serial.size() > 6 * width);  // a few nodes are never picked as children
+  REQUIRE(serial == parallel);
+}
+
+TEST_CASE("merkle_hashes - equal BDDs from separate builds", "[merkle_hash]") {
+  std::mt19937_64 rng(23);
+  const std::uint64_t truth = rng();
+  MockBddView first;
+  first.add_root(first.build(truth, 6));
+  MockBddView second;
+  second.build(rng(), 6);  // unrelated nodes shift the ids of the next build
+  second.add_root(second.build(truth, 6));
+  MockBddView different;
+  different.add_root(different.build(truth ^ 1u, 6));
+
+  const hash128 h = dagir::merkle_graph_hash(first, dagir::bdd_label_hash{});
+  REQUIRE(h == dagir::merkle_graph_hash(second, dagir::bdd_label_hash{}));
+  REQUIRE(h != dagir::merkle_graph_hash(different, dagir::bdd_label_hash{}));
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_portfolio.cpp
+ * @brief Unit tests for `run_portfolio`.
+ *
+ * @details
+ * This test suite validates:
+ * - With `first_finished` the fastest candidate wins and the rest are cancelled.
+ * - With `smallest_within_budget` the smallest finished result wins and slow
+ *   candidates are cancelled when the budget expires.
+ * - Failures are reported and do not prevent another candidate from winning.
+ * - No winner is reported when every candidate fails.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <dagir/utility/portfolio.hpp>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+
+using dagir::utility::portfolio_options;
+using dagir::utility::portfolio_policy;
+using dagir::utility::portfolio_status;
+using dagir::utility::run_portfolio;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Sleeps for `delay` in small steps, throwing once a stop is requested.
+void cancellable_sleep(std::chrono::milliseconds delay, const std::stop_token& stop) {
+  const auto until = std::chrono::steady_clock::now() + delay;
+  while (std::chrono::steady_clock::now() < until) {
+    if (stop.stop_requested()) throw std::runtime_error("cancelled");
+    std::this_thread::sleep_for(1ms);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("run_portfolio - first finished wins", "[portfolio]") {
+  auto outcome = run_portfolio<int>(
+      3,
+      [](std::size_t i, std::stop_token stop) {
+        cancellable_sleep(i == 1 ? 1ms : 5s, stop);
+        return static_cast<int>(i) * 10;
+      },
+      [](int v) { return static_cast<std::size_t>(v); });
+
+  REQUIRE(outcome.winner.has_value());
+  REQUIRE(outcome.winner_index == 1);
+  REQUIRE(*outcome.winner == 10);
+  REQUIRE(outcome.reports[1].status == portfolio_status::finished);
+  REQUIRE(outcome.reports[0].status == portfolio_status::cancelled);
+  REQUIRE(outcome.reports[2].status == portfolio_status::cancelled);
+}
+
+TEST_CASE("run_portfolio - smallest within budget wins", "[portfolio]") {
+  portfolio_options options;
+  options.policy = portfolio_policy::smallest_within_budget;
+  options.budget = 2s;
+
+  // Sizes 30, 10, 20 finish quickly; candidate 3 would be smallest but too slow.
+  constexpr int sizes[] = {30, 10, 20, 1};
+  auto outcome = run_portfolio<int>(
+      4,
+      [&](std::size_t i, std::stop_token stop) {
+        cancellable_sleep(i == 3 ? 60s : 1ms, stop);
+        return sizes[i];
+      },
+      [](int v) { return static_cast<std::size_t>(v); }, options);
+
+  REQUIRE(outcome.winner_index == 1);
+  REQUIRE(*outcome.winner == 10);
+  REQUIRE(outcome.reports[3].status == portfolio_status::cancelled);
+}
+
+TEST_CASE("run_portfolio - failures are reported", "[portfolio]") {
+  auto outcome = run_portfolio<int>(
+      2,
+      [](std::size_t i, std::stop_token stop) {
+        if (i == 0) throw std::runtime_error("out of memory");
+        cancellable_sleep(5ms, stop);
+        return 7;
+      },
+      [](int v) { return static_cast<std::size_t>(v); });
+
+  REQUIRE(outcome.winner_index == 1);
+  REQUIRE(outcome.reports[0].status == portfolio_status::failed);
+  REQUIRE(outcome.reports[0].error == "out of memory");
+
+  auto none = run_portfolio<int>(
+      2, [](std::size_t, std::stop_token) -> int { throw std::runtime_error("boom"); },
+      [](int v) { return static_cast<std::size_t>(v); });
+  REQUIRE_FALSE(none.winner.has_value());
+  REQUIRE(none.reports[1].status == portfolio_status::failed);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_reachability.cpp
+ * @brief Unit tests for the eager and lazy reachability indexes.
+ *
+ * @details
+ * This test suite validates:
+ * - Both indexes agree with a DFS on every pair of nodes of random DAGs.
+ * - Descendant counts and the roots reaching a node.
+ * - The lazy index stays within its memory bound and still answers correctly.
+ * - Cycles are rejected.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/reachability.hpp>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "mock_dag.hpp"
+
+namespace {
+
+/// Random DAG over `n` nodes; edges only go from lower to higher ids.
+std::vector<std::vector<MockHandle>> random_dag(std::size_t n, std::mt19937_64& rng) {
+  std::vector<std::vector<MockHandle>> adj(n);
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    const std::size_t degree = rng() % 4;
+    for (std::size_t k = 0; k < degree; ++k) {
+      adj[i].push_back(MockHandle{i + 1 + rng() % std::min<std::size_t>(n - i - 1, 40)});
+    }
+  }
+  return adj;
+}
+
+/// Reference closure by DFS.
+std::vector<bool> dfs_closure(const std::vector<std::vector<MockHandle>>& adj, std::size_t from) {
+  std::vector<bool> seen(adj.size());
+  std::vector<std::size_t> stack{from};
+  seen[from] = true;
+  while (!stack.empty()) {
+    const std::size_t n = stack.back();
+    stack.pop_back();
+    for (const MockHandle& c : adj[n]) {
+      if (!seen[c.id]) {
+        seen[c.id] = true;
+        stack.push_back(c.id);
+      }
+    }
+  }
+  return seen;
+}
+
+}  // namespace
+
+TEST_CASE("reachability_index - matches DFS on random DAGs", "[reachability]") {
+  std::mt19937_64 rng(31);
+  for (int trial = 0; trial < 5; ++trial) {
+    const std::size_t n = 300;
+    const auto adj = random_dag(n, rng);
+    MockDagView g({MockHandle{0}, MockHandle{1}, MockHandle{2}}, adj);
+    const dagir::reachability_index<MockDagView> eager(g);
+    dagir::lazy_reachability_index<MockDagView> lazy(g);
+    const auto reachable = dfs_closure(adj, 0);
+
+    for (std::size_t a = 0; a < n; ++a) {
+      if (!eager.contains(MockHandle{a})) continue;
+      const auto expected = dfs_closure(adj, a);
+      std::size_t count = 0;
+      for (std::size_t b = 0; b < n; ++b) {
+        if (!eager.contains(MockHandle{b})) continue;
+        REQUIRE(eager.reaches(MockHandle{a}, MockHandle{b}) == expected[b]);
+        REQUIRE(lazy.reaches(MockHandle{a}, MockHandle{b}) == expected[b]);
+        count += expected[b] ? 1 : 0;
+      }
+      REQUIRE(eager.descendant_count(MockHandle{a}) == count);
+    }
+    REQUIRE(eager.size() >= static_cast<std::size_t>(std::count(reachable.begin(),
+                                                                reachable.end(), true)));
+  }
+}
+
+TEST_CASE("reachability_index - roots sharing a subgraph", "[reachability]") {
+  // Roots 0, 1, 2; 0 -> 3, 1 -> 3, 3 -> 4, 2 -> 5.
+  MockDagView g({MockHandle{0}, MockHandle{1}, MockHandle{2}},
+                {{MockHandle{3}}, {MockHandle{3}}, {MockHandle{5}}, {MockHandle{4}}, {}, {}});
+  const dagir::reachability_index<MockDagView> index(g);
+  REQUIRE(index.size() == 6);
+  REQUIRE(index.roots_reaching(MockHandle{4}) ==
+          std::vector<MockHandle>{MockHandle{0}, MockHandle{1}});
+  REQUIRE(index.roots_reaching(MockHandle{2}) == std::vector<MockHandle>{MockHandle{2}});
+  REQUIRE_FALSE(index.reaches(MockHandle{4}, MockHandle{3}));
+  REQUIRE(index.reaches(MockHandle{5}, MockHandle{5}));
+  REQUIRE(index.memory_bytes() > 0);
+  REQUIRE_THROWS_AS(index.reaches(MockHandle{0}, MockHandle{9}), std::out_of_range);
+
+  MockDagView cycle({MockHandle{0}}, {{MockHandle{1}}, {MockHandle{0}}});
+  REQUIRE_THROWS_AS(dagir::reachability_index<MockDagView>(cycle), std::runtime_error);
+}
+
+TEST_CASE("lazy_reachability_index - bounded memory", "[reachability]") {
+  std::mt19937_64 rng(37);
+  const std::size_t n = 2000;
+  const auto adj = random_dag(n, rng);
+  std::vector<MockHandle> roots;
+  for (std::size_t i = 0; i < 50; ++i) roots.push_back(MockHandle{i});
+  MockDagView g(roots, adj);
+
+  const dagir::reachability_index<MockDagView> eager(g);
+  dagir::lazy_reachability_index<MockDagView> lazy(g, 1024);
+  for (int q = 0; q < 5000; ++q) {
+    const MockHandle a{rng() % n}, b{rng() % n};
+    if (!eager.contains(a) || !eager.contains(b)) continue;
+    REQUIRE(lazy.reaches(a, b) == eager.reaches(a, b));
+    REQUIRE((lazy.memory_bytes() <= 1024 || lazy.cached_closures() == 1));
+  }
+  REQUIRE(lazy.cached_closures() >= 1);
+}
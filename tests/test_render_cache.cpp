@@ -0,0 +1,117 @@
+/**
+ * @file test_render_cache.cpp
+ * @brief Unit tests for the on-disk render cache.
+ *
+ * @details
+ * This test suite validates:
+ * - Misses, stores and hits round-trip content byte for byte.
+ * - Keys depend on every part and on part boundaries.
+ * - Least recently used entries are evicted to honour the size limit.
+ * - View keys follow structure rather than node identity.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <dagir/utility/render_cache.hpp>
+#include <filesystem>
+#include <string>
+
+#include "mock_bdd.hpp"
+
+namespace fs = std::filesystem;
+using dagir::utility::render_cache;
+using dagir::utility::render_cache_key;
+
+namespace {
+
+/// Fresh, empty cache directory removed at scope exit.
+struct temp_dir {
+  fs::path path;
+  explicit temp_dir(const std::string& name)
+      : path(fs::temp_directory_path() / ("dagir_" + name + "_" +
+                                          std::to_string(std::chrono::steady_clock::now()
+                                                             .time_since_epoch()
+                                                             .count()))) {}
+  ~temp_dir() {
+    std::error_code ec;
+    fs::remove_all(path, ec);
+  }
+};
+
+}  // namespace
+
+TEST_CASE("render_cache - miss, store and hit", "[render_cache]") {
+  temp_dir dir("render_cache_basic");
+  render_cache cache(dir.path);
+  const auto key = render_cache_key({"expr contents", "dot"});
+
+  REQUIRE_FALSE(cache.lookup(key).has_value());
+  const std::string content("digraph G {\n  a -> b;\n}\n\0tail", 30);
+  REQUIRE(cache.store(key, content));
+  const auto hit = cache.lookup(key);
+  REQUIRE(hit.has_value());
+  REQUIRE(*hit == content);
+
+  REQUIRE(cache.stats().hits == 1);
+  REQUIRE(cache.stats().misses == 1);
+  REQUIRE(cache.stats().stores == 1);
+  REQUIRE(cache.size_bytes() == content.size());
+
+  // A second instance over the same directory sees the entry.
+  render_cache again(dir.path);
+  REQUIRE(again.lookup(key) == content);
+}
+
+TEST_CASE("render_cache_key - parts and boundaries", "[render_cache]") {
+  REQUIRE(render_cache_key({"a", "b"}) == render_cache_key({"a", "b"}));
+  REQUIRE(render_cache_key({"a", "b"}) != render_cache_key({"b", "a"}));
+  REQUIRE(render_cache_key({"ab", ""}) != render_cache_key({"a", "b"}));
+  REQUIRE(render_cache_key({"a"}) != render_cache_key({"a", ""}));
+}
+
+TEST_CASE("render_cache - evicts least recently used entries", "[render_cache]") {
+  temp_dir dir("render_cache_lru");
+  render_cache cache(dir.path, 250);
+  const auto a = render_cache_key({"a"});
+  const auto b = render_cache_key({"b"});
+  const auto c = render_cache_key({"c"});
+
+  REQUIRE(cache.store(a, std::string(100, 'a')));
+  REQUIRE(cache.store(b, std::string(100, 'b')));
+  // Make `a` older than `b`, then use it so that `b` becomes the LRU entry.
+  const auto now = fs::file_time_type::clock::now();
+  fs::last_write_time(cache.path_for(a), now - std::chrono::hours(2));
+  fs::last_write_time(cache.path_for(b), now - std::chrono::hours(1));
+  REQUIRE(cache.lookup(a).has_value());
+
+  REQUIRE(cache.store(c, std::string(100, 'c')));
+  REQUIRE(cache.stats().evictions == 1);
+  REQUIRE(fs::exists(cache.path_for(a)));
+  REQUIRE_FALSE(fs::exists(cache.path_for(b)));
+  REQUIRE(fs::exists(cache.path_for(c)));
+  REQUIRE(cache.size_bytes() == 200);
+
+  // An entry larger than the limit is still kept until the next store.
+  REQUIRE(cache.store(b, std::string(400, 'b')));
+  REQUIRE(cache.lookup(b).has_value());
+  REQUIRE(cache.size_bytes() == 400);
+}
+
+TEST_CASE("render_cache_view_key - structural", "[render_cache]") {
+  MockBddView first;
+  first.add_root(first.build(0x96, 3));
+  MockBddView second;
+  second.build(0x3c, 3);
+  second.add_root(second.build(0x96, 3));
+
+  const auto k1 = dagir::utility::render_cache_view_key(first, dagir::bdd_label_hash{}, "p", "dot");
+  REQUIRE(k1 ==
+          dagir::utility::render_cache_view_key(second, dagir::bdd_label_hash{}, "p", "dot"));
+  REQUIRE(k1 !=
+          dagir::utility::render_cache_view_key(first, dagir::bdd_label_hash{}, "p", "json"));
+  REQUIRE(k1 != dagir::utility::render_cache_view_key(first, dagir::bdd_label_hash{}, "q", "dot"));
+}
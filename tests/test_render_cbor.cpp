@@ -0,0 +1,154 @@
+/**
+ * @file tests/test_render_cbor.cpp
+ * @brief Unit tests for the CBOR renderer and decoder
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/ir.hpp>
+#include <dagir/render_cbor.hpp>
+#include <dagir/render_json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::string to_cbor(const dagir::ir_graph& g) {
+  std::ostringstream oss;
+  dagir::render_cbor(oss, g);
+  return oss.str();
+}
+
+std::string to_json(const dagir::ir_graph& g) {
+  std::ostringstream oss;
+  dagir::render_json(oss, g);
+  return oss.str();
+}
+
+dagir::ir_graph sample_graph() {
+  dagir::ir_graph g;
+  g.global_attrs.emplace(dagir::ir_attrs::k_graph_label, "sample");
+  g.global_attrs.emplace(dagir::ir_attrs::k_rankdir, "LR");
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    dagir::ir_node n;
+    n.id = 100 + i;
+    n.attributes.emplace(dagir::ir_attrs::k_name, "v" + std::to_string(i));
+    n.attributes.emplace(dagir::ir_attrs::k_label, i == 0 ? "007" : "x \"" + std::to_string(i));
+    n.attributes.emplace(dagir::ir_attrs::k_shape, "box");
+    n.attributes.emplace(dagir::ir_attrs::k_id, "skipped");
+    g.nodes.push_back(n);
+  }
+  g.nodes[1].attributes.emplace("weight", "-3");
+  g.nodes[2].attributes.emplace("weight", "0.1");
+  g.nodes[3].attributes.emplace("weight", "1e300");
+  g.nodes[3].attributes.emplace("flag", "true");
+  g.nodes[3].attributes.emplace("none", "null");
+  for (std::uint64_t i = 0; i < 3; ++i) {
+    dagir::ir_edge e;
+    e.source = 100 + i;
+    e.target = 101 + i;
+    e.attributes.emplace(dagir::ir_attrs::k_style, i == 1 ? "dashed" : "solid");
+    g.edges.push_back(e);
+  }
+  return g;
+}
+
+}  // namespace
+
+TEST_CASE("render_cbor writes an empty graph", "[render_cbor]") {
+  const std::string bytes = to_cbor(dagir::ir_graph{});
+  const std::string expected = std::string("\xd9\xd9\xf7\xa3", 4) + "\x67strings\x80" +
+                               "\x65nodes\x80" + "\x65" "edges\x80";
+  REQUIRE(bytes == expected);
+}
+
+TEST_CASE("render_cbor round-trips to the same JSON", "[render_cbor]") {
+  const dagir::ir_graph g = sample_graph();
+  const std::string bytes = to_cbor(g);
+  REQUIRE(bytes.size() < to_json(g).size() / 2);
+
+  // Repeated strings are written once and referenced from the table.
+  REQUIRE(bytes.find("box") == bytes.rfind("box"));
+  REQUIRE(bytes.find("solid") == bytes.rfind("solid"));
+
+  const dagir::ir_document doc = dagir::decode_cbor(bytes);
+  REQUIRE(to_json(doc.graph) == to_json(g));
+  REQUIRE(doc.graph.nodes[0].attributes.at(dagir::ir_attrs::k_label) == "007");
+  REQUIRE(doc.graph.nodes[1].attributes.at("weight") == "-3");
+  REQUIRE(doc.graph.nodes[2].attributes.at("weight") == "0.1");
+  REQUIRE(doc.graph.nodes[3].attributes.at("weight") == "1e300");
+  REQUIRE(doc.graph.nodes[3].attributes.at("flag") == "true");
+  REQUIRE(doc.graph.nodes[3].attributes.at("none") == "null");
+  REQUIRE(doc.graph.nodes[3].attributes.count(dagir::ir_attrs::k_id) == 0);
+  REQUIRE(doc.graph.edges[1].source == 1);
+  REQUIRE(doc.graph.edges[1].target == 2);
+  REQUIRE(doc.graph.global_attrs.at(dagir::ir_attrs::k_graph_label) == "sample");
+}
+
+TEST_CASE("render_cbor references tabled values by index", "[render_cbor]") {
+  dagir::ir_graph g;
+  for (std::uint64_t id : {0, 1}) {
+    dagir::ir_node n;
+    n.id = id;
+    n.attributes.emplace(dagir::ir_attrs::k_shape, "box");
+    g.nodes.push_back(n);
+  }
+  const std::string bytes = to_cbor(g);
+  // strings = ["box", "shape"]; each node is ["<id>", {1: [0]}].
+  REQUIRE(bytes.find("\x67strings\x82\x63" "box\x65shape") != std::string::npos);
+  REQUIRE(bytes.find(std::string("\x82\x61" "0\xa1\x01\x81\x00", 7)) != std::string::npos);
+  REQUIRE(bytes.find(std::string("\x82\x61" "1\xa1\x01\x81\x00", 7)) != std::string::npos);
+  REQUIRE(dagir::decode_cbor(bytes).graph.nodes[1].attributes.at(dagir::ir_attrs::k_shape) ==
+          "box");
+}
+
+TEST_CASE("decode_cbor keeps keys and dangling endpoints", "[render_cbor]") {
+  std::string bytes;
+  {
+    dagir::ir_graph g;
+    const std::string key = "runtime-key";
+    dagir::ir_node a;
+    a.id = 7;
+    a.attributes.emplace(key, "value");
+    g.nodes.push_back(a);
+    g.edges.push_back(dagir::ir_edge{7, 42, {}});
+    g.edges.push_back(dagir::ir_edge{42, 7, {}});
+    g.edges.push_back(dagir::ir_edge{43, 7, {}});
+    bytes = to_cbor(g);
+  }
+  dagir::ir_document decoded = dagir::decode_cbor(bytes);
+  const dagir::ir_document doc = std::move(decoded);
+  REQUIRE(doc.graph.nodes.size() == 1);
+  REQUIRE(doc.graph.nodes[0].id == 0);
+  REQUIRE(doc.graph.nodes[0].attributes.at("runtime-key") == "value");
+  REQUIRE(doc.graph.edges[0].target == 1);
+  REQUIRE(doc.graph.edges[1].source == 1);
+  REQUIRE(doc.graph.edges[2].source == 2);
+}
+
+TEST_CASE("decode_cbor rejects malformed input", "[render_cbor]") {
+  const std::string bytes = to_cbor(sample_graph());
+  REQUIRE_THROWS_AS(dagir::decode_cbor(bytes.substr(0, bytes.size() - 1)), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::decode_cbor(bytes + '\0'), std::runtime_error);
+  REQUIRE_THROWS_AS(dagir::decode_cbor("\x80"), std::runtime_error);
+}
+
+TEST_CASE("decode_cbor skips deeply nested unknown members", "[render_cbor]") {
+  // {"x": [[[...[]...]]], "nodes": []} with 300000 levels of one-element arrays.
+  constexpr std::size_t depth = 300000;
+  const std::string nested = std::string(depth, '\x81') + '\x80';
+  const dagir::ir_document doc =
+      dagir::decode_cbor(std::string("\xa2\x61x") + nested + "\x65nodes\x80");
+  REQUIRE(doc.graph.nodes.empty());
+
+  // The same nesting cut short, and an array claiming more items than bytes.
+  REQUIRE_THROWS_AS(dagir::decode_cbor(std::string("\xa1\x61x") + std::string(depth, '\x81')),
+                    std::runtime_error);
+  const std::string huge("\xa1\x61x\x9b\xff\xff\xff\xff\xff\xff\xff\xff", 12);
+  REQUIRE_THROWS_AS(dagir::decode_cbor(huge), std::runtime_error);
+}
@@ -4,7 +4,8 @@
  *
  * @details
  * This test verifies that a small `dagir::ir_graph` is rendered to a
- * valid GraphViz DOT snippet and that node/edge attributes appear as expected.
+ * valid GraphViz DOT snippet and that node/edge attributes appear as expected,
+ * and checks the layout hints of `dagir::dot_options`.
  *
  * SPDX-License-Identifier: MIT
  */
@@ -12,7 +13,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <dagir/ir.hpp>
 #include <dagir/render_dot.hpp>
+#include <cstdint>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("render_dot outputs nodes and edges with attributes", "[render_dot]") {
   dagir::ir_graph g;
@@ -56,3 +61,109 @@ TEST_CASE("render_dot outputs nodes and edges with attributes", "[render_dot]")
   // style should be present (renderer may include spaces around '=')
   REQUIRE(out.find("filled") != std::string::npos);
 }
+
+TEST_CASE("render_dot layout hints: ranks, duplicated sinks, defaults, budgets", "[render_dot]") {
+  // Two decision nodes on levels 0 and 1, both pointing at terminal 9.
+  dagir::ir_graph g;
+  for (std::uint64_t id : {1, 2, 9}) {
+    dagir::ir_node n;
+    n.id = id;
+    n.attributes.emplace(dagir::ir_attrs::k_label, id == 9 ? "1" : "x");
+    n.attributes.emplace(dagir::ir_attrs::k_shape, id == 9 ? "box" : "circle");
+    n.attributes.emplace(dagir::ir_attrs::k_level, id == 1 ? "0" : id == 2 ? "1" : "10");
+    g.nodes.push_back(n);
+  }
+  for (auto [s, t] : {std::pair<std::uint64_t, std::uint64_t>{1, 2}, {1, 9}, {2, 9}}) {
+    dagir::ir_edge e;
+    e.source = s;
+    e.target = t;
+    e.attributes.emplace(dagir::ir_attrs::k_style, "dashed");
+    g.edges.push_back(e);
+  }
+
+  // Default options reproduce the plain renderer.
+  std::ostringstream plain;
+  std::ostringstream defaults;
+  dagir::render_dot(plain, g, "G");
+  dagir::render_dot(defaults, g, dagir::dot_options{}, "G");
+  REQUIRE(plain.str() == defaults.str());
+  REQUIRE(plain.str().find("rank = same") == std::string::npos);
+
+  std::ostringstream oss;
+  dagir::render_dot(oss, g, dagir::dot_options::fast(), "G");
+  const std::string out = oss.str();
+
+  REQUIRE(out.find("  splines=\"line\";\n") != std::string::npos);
+  REQUIRE(out.find("  mclimit=\"0.5\";\n") != std::string::npos);
+  // Common values are hoisted and omitted from the elements.
+  REQUIRE(out.find("  node [label = \"x\", shape = \"circle\", style = \"filled\"];\n") !=
+          std::string::npos);
+  REQUIRE(out.find("  edge [style = \"dashed\"];\n") != std::string::npos);
+  REQUIRE(out.find("  n1;\n") != std::string::npos);
+  REQUIRE(out.find("  n1 -> n2;\n") != std::string::npos);
+  REQUIRE(out.find("level") == std::string::npos);
+  // The terminal is written once per parent.
+  REQUIRE(out.find("  { node [label = \"1\", shape = \"box\"]; n9_0; n9_1; }\n") !=
+          std::string::npos);
+  REQUIRE(out.find("  n1 -> n9_0;\n") != std::string::npos);
+  REQUIRE(out.find("  n2 -> n9_1;\n") != std::string::npos);
+  // Ranks follow the numeric level order.
+  const auto r0 = out.find("  { rank = same; n1; }\n");
+  const auto r1 = out.find("  { rank = same; n2; }\n");
+  const auto r10 = out.find("  { rank = same; n9_0; n9_1; }\n");
+  REQUIRE(r0 != std::string::npos);
+  REQUIRE(r0 < r1);
+  REQUIRE(r1 < r10);
+  REQUIRE(r10 != std::string::npos);
+}
+
+TEST_CASE("render_dot orders ranks numerically, then by name", "[render_dot]") {
+  dagir::ir_graph g;
+  const std::vector<std::string> levels{"b", "10", "a10", "9", "a9", "010"};
+  for (std::size_t i = 0; i < levels.size(); ++i) {
+    dagir::ir_node n;
+    n.id = i;
+    n.attributes.emplace(dagir::ir_attrs::k_level, levels[i]);
+    g.nodes.push_back(n);
+  }
+  dagir::dot_options options;
+  options.rank_by_level = true;
+  std::ostringstream ss;
+  dagir::render_dot(ss, g, options, "G");
+  const std::string out = ss.str();
+
+  // 9 < 010 < 10 < a10 < a9 < b
+  std::size_t last = 0;
+  for (const char* id : {"n3", "n5", "n1", "n2", "n4", "n0"}) {
+    const auto pos = out.find(std::string("  { rank = same; ") + id + "; }\n");
+    REQUIRE(pos != std::string::npos);
+    REQUIRE(pos > last);
+    last = pos;
+  }
+}
+
+TEST_CASE("render_dot minified output", "[render_dot]") {
+  dagir::ir_graph g;
+  for (std::uint64_t id : {5, 6}) {
+    dagir::ir_node n;
+    n.id = id;
+    n.attributes.emplace(dagir::ir_attrs::k_label, id == 5 ? "node" : "two words");
+    g.nodes.push_back(n);
+  }
+  dagir::ir_edge e;
+  e.source = 5;
+  e.target = 6;
+  e.attributes.emplace(dagir::ir_attrs::k_pen_width, "1.5");
+  g.edges.push_back(e);
+
+  dagir::dot_options options;
+  options.minified = true;
+  options.hoist_defaults = true;
+  std::ostringstream oss;
+  dagir::render_dot(oss, g, options, "G");
+  // Keywords and values with spaces stay quoted; numbers do not. A value
+  // used once is not hoisted.
+  REQUIRE(oss.str() ==
+          "digraph G{rankdir=TB;node[style=filled];_0[label=\"node\"];"
+          "_1[label=\"two words\"];_0->_1[penwidth=1.5];}\n");
+}
@@ -0,0 +1,66 @@
+/**
+ * @file tests/test_render_graphml.cpp
+ * @brief Unit tests for the GraphML renderer
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <dagir/ir.hpp>
+#include <dagir/render_graphml.hpp>
+#include <sstream>
+#include <string>
+
+TEST_CASE("render_graphml declares keys from attribute usage", "[render_graphml]") {
+  dagir::ir_graph g;
+  g.global_attrs.emplace(dagir::ir_attrs::k_graph_label, "A & B");
+
+  dagir::ir_node a;
+  a.id = 1;
+  a.attributes.emplace(dagir::ir_attrs::k_label, "<a>");
+  a.attributes.emplace(dagir::ir_attrs::k_id, "node1");
+  a.attributes.emplace("weight", "3");
+  dagir::ir_node b;
+  b.id = 2;
+  b.attributes.emplace(dagir::ir_attrs::k_label, "b");
+  b.attributes.emplace("weight", "2.5");
+  dagir::ir_node c;
+  c.id = 3;
+  g.nodes = {a, b, c};
+
+  dagir::ir_edge e;
+  e.source = 1;
+  e.target = 2;
+  e.attributes.emplace("taken", "true");
+  g.edges.push_back(e);
+  dagir::ir_edge f;
+  f.source = 2;
+  f.target = 3;
+  g.edges.push_back(f);
+
+  std::ostringstream oss;
+  dagir::render_graphml(oss, g, "bdd");
+  const std::string out = oss.str();
+
+  REQUIRE(out.starts_with("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<graphml "));
+  REQUIRE(out.find(
+              "  <key id=\"d0\" for=\"graph\" attr.name=\"graph.label\" attr.type=\"string\"/>\n"
+              "  <key id=\"d1\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n"
+              "  <key id=\"d2\" for=\"node\" attr.name=\"weight\" attr.type=\"double\"/>\n"
+              "  <key id=\"d3\" for=\"edge\" attr.name=\"taken\" attr.type=\"boolean\"/>\n") !=
+          std::string::npos);
+  // `k_id` is not declared as a key.
+  REQUIRE(out.find("attr.name=\"id\"") == std::string::npos);
+  REQUIRE(out.find("  <graph id=\"bdd\" edgedefault=\"directed\">\n"
+                   "    <data key=\"d0\">A &amp; B</data>\n") != std::string::npos);
+  REQUIRE(out.find("    <node id=\"1\">\n"
+                   "      <data key=\"d1\">&lt;a&gt;</data>\n"
+                   "      <data key=\"d2\">3</data>\n"
+                   "    </node>\n") != std::string::npos);
+  REQUIRE(out.find("    <node id=\"3\"/>\n") != std::string::npos);
+  REQUIRE(out.find("    <edge id=\"e0\" source=\"1\" target=\"2\">\n"
+                   "      <data key=\"d3\">true</data>\n") != std::string::npos);
+  REQUIRE(out.find("    <edge id=\"e1\" source=\"2\" target=\"3\"/>\n") != std::string::npos);
+  REQUIRE(out.ends_with("  </graph>\n</graphml>\n"));
+}
@@ -9,7 +9,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include <dagir/ir.hpp>
 #include <dagir/render_json.hpp>
+#include <cstdint>
 #include <sstream>
+#include <string>
 
 TEST_CASE("render_json emits nodes edges roots and graphAttributes", "[render_json]") {
   dagir::ir_graph g;
@@ -46,3 +48,51 @@ TEST_CASE("render_json emits nodes edges roots and graphAttributes", "[render_js
   REQUIRE(s.find("\"label\": \"A\"") != std::string::npos);
   REQUIRE(s.find("\"num\": 42") != std::string::npos);
 }
+
+namespace {
+
+/// Three terminals sharing shape and fill, pointed at by dashed edges from node 1.
+dagir::ir_graph styled_graph() {
+  dagir::ir_graph g;
+  for (std::uint64_t id = 1; id <= 4; ++id) {
+    dagir::ir_node n;
+    n.id = id;
+    n.attributes.emplace(dagir::ir_attrs::k_label, std::to_string(id));
+    n.attributes.emplace(dagir::ir_attrs::k_shape, id == 1 ? "circle" : "box");
+    if (id > 1) n.attributes.emplace(dagir::ir_attrs::k_fill_color, "gray");
+    g.nodes.push_back(n);
+  }
+  for (std::uint64_t id = 2; id <= 4; ++id) {
+    dagir::ir_edge e;
+    e.source = 1;
+    e.target = id;
+    e.attributes.emplace(dagir::ir_attrs::k_style, "dashed");
+    g.edges.push_back(e);
+  }
+  return g;
+}
+
+}  // namespace
+
+TEST_CASE("render_json hoists defaults and minifies", "[render_json]") {
+  const dagir::ir_graph g = styled_graph();
+
+  std::ostringstream plain;
+  std::ostringstream defaults;
+  dagir::render_json(plain, g);
+  dagir::render_json(defaults, g, dagir::json_options{});
+  REQUIRE(plain.str() == defaults.str());
+
+  std::ostringstream oss;
+  dagir::render_json(oss, g, dagir::json_options{true, true});
+  const std::string out = oss.str();
+  // `fillcolor` is missing on node 1, so it is not hoisted.
+  REQUIRE(out.starts_with(
+      R"({"defaults":{"node":{"shape":"box"},"edge":{"style":"dashed"}},"nodes":[)"));
+  REQUIRE(out.find(R"({"id":"_0","label":"1","attributes":{"label":1,"shape":"circle"}})") !=
+          std::string::npos);
+  REQUIRE(out.find(R"({"id":"_1","label":"2","attributes":{"fillcolor":"gray","label":2}})") !=
+          std::string::npos);
+  REQUIRE(out.find(R"({"source":"_0","target":"_3"})") != std::string::npos);
+  REQUIRE(out.find(' ') == std::string::npos);
+}
@@ -10,7 +10,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include <dagir/ir.hpp>
 #include <dagir/render_mermaid.hpp>
+#include <cstdint>
 #include <sstream>
+#include <string>
 
 TEST_CASE("render_mermaid outputs nodes, edges, title, and respects rankdir", "[render_mermaid]") {
   dagir::ir_graph g;
@@ -45,3 +47,27 @@ TEST_CASE("render_mermaid outputs nodes, edges, title, and respects rankdir", "[
            out.find("n1(\"Alpha\")") != std::string::npos));
   REQUIRE(out.find("n1 -- \"to B\" --> n2") != std::string::npos);
 }
+
+TEST_CASE("render_mermaid shares styles through classes and minifies", "[render_mermaid]") {
+  dagir::ir_graph g;
+  for (std::uint64_t id = 1; id <= 3; ++id) {
+    dagir::ir_node n;
+    n.id = id;
+    n.attributes.emplace(dagir::ir_attrs::k_label, std::to_string(id));
+    n.attributes.emplace(dagir::ir_attrs::k_fill_color, id == 1 ? "white" : "gray");
+    g.nodes.push_back(n);
+  }
+  dagir::ir_edge e;
+  e.source = 1;
+  e.target = 2;
+  e.attributes.emplace(dagir::ir_attrs::k_label, "hi");
+  g.edges.push_back(e);
+
+  std::ostringstream oss;
+  dagir::render_mermaid(oss, g, dagir::mermaid_options{true, true}, "G");
+  const std::string out = oss.str();
+  REQUIRE(out.find("_0[\"1\"]\nstyle _0 fill:white\n") != std::string::npos);
+  REQUIRE(out.find("classDef s0 fill:gray\nclass _1,_2 s0\n") != std::string::npos);
+  REQUIRE(out.find("style _1") == std::string::npos);
+  REQUIRE(out.find("_0--\"hi\"-->_1\n") != std::string::npos);
+}
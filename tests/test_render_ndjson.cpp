@@ -0,0 +1,48 @@
+/**
+ * @file tests/test_render_ndjson.cpp
+ * @brief Unit tests for the NDJSON renderer
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <dagir/ir.hpp>
+#include <dagir/render_ndjson.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("render_ndjson writes one object per line", "[render_ndjson]") {
+  dagir::ir_graph g;
+  g.global_attrs.emplace(dagir::ir_attrs::k_rankdir, "LR");
+
+  dagir::ir_node a;
+  a.id = 1;
+  a.attributes.emplace(dagir::ir_attrs::k_label, "line\nbreak");
+  a.attributes.emplace("name", "root");
+  dagir::ir_node b;
+  b.id = 2;
+  g.nodes = {a, b};
+
+  dagir::ir_edge e;
+  e.source = 1;
+  e.target = 2;
+  e.attributes.emplace("weight", "0.5");
+  g.edges.push_back(e);
+
+  std::ostringstream oss;
+  dagir::render_ndjson(oss, g);
+
+  std::vector<std::string> lines;
+  std::istringstream in(oss.str());
+  for (std::string line; std::getline(in, line);) lines.push_back(line);
+  REQUIRE(lines == std::vector<std::string>{
+                       R"({"type":"graph","attributes":{"rankdir":"LR"}})",
+                       R"({"type":"node","id":"root","label":"line\nbreak",)"
+                       R"("attributes":{"label":"line\nbreak","name":"root"}})",
+                       R"({"type":"node","id":"2"})",
+                       R"({"type":"edge","source":"root","target":"2",)"
+                       R"("attributes":{"weight":0.5}})",
+                   });
+}
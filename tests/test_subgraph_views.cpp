@@ -0,0 +1,128 @@
+/**
+ * @file test_subgraph_views.cpp
+ * @brief Unit tests for the subgraph, depth-limited and cone view adaptors.
+ *
+ * @details
+ * This test suite validates:
+ * - Every adaptor (also nested) models `read_only_dag_view`.
+ * - Predicate, depth and cone selections contain exactly the expected nodes.
+ * - `build_ir` runs on adapted views with policies written for the base view.
+ *
+ * @copyright
+ * © DagIR Contributors. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <dagir/algorithms.hpp>
+#include <dagir/build_ir.hpp>
+#include <dagir/subgraph_views.hpp>
+#include <string>
+#include <vector>
+
+#include "mock_dag.hpp"
+
+namespace {
+
+/// Sorted stable keys of the nodes reachable in `view`.
+template <class View>
+std::vector<std::uint64_t> node_ids(const View& view) {
+  std::vector<std::uint64_t> out;
+  for (const auto& h : dagir::kahn_topological_order(view)) out.push_back(h.stable_key());
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+// 0 -> {1, 4}; 1 -> 2; 2 -> 3; 4 -> 3; 3 -> 5.
+MockDagView sample() {
+  return MockDagView({MockHandle{0}}, {{MockHandle{1}, MockHandle{4}},
+                                       {MockHandle{2}},
+                                       {MockHandle{3}},
+                                       {MockHandle{5}},
+                                       {MockHandle{3}},
+                                       {}});
+}
+
+using ids = std::vector<std::uint64_t>;
+
+/// Policy that only accepts the base view type.
+struct base_only_attributor {
+  dagir::ir_attr_map operator()(const MockDagView&, const MockHandle& h) const {
+    return {{dagir::ir_attrs::k_label, "n" + std::to_string(h.id)}};
+  }
+};
+
+struct even_or_three {
+  bool operator()(const MockHandle& h) const { return h.id % 2 == 0 || h.id == 3; }
+};
+
+}  // namespace
+
+static_assert(dagir::concepts::read_only_dag_view<dagir::subgraph_view<MockDagView, even_or_three>>);
+static_assert(dagir::concepts::read_only_dag_view<dagir::depth_limited_view<MockDagView>>);
+static_assert(dagir::concepts::read_only_dag_view<dagir::cone_view<MockDagView>>);
+static_assert(dagir::concepts::read_only_dag_view<
+              dagir::depth_limited_view<dagir::cone_view<MockDagView>>>);
+
+TEST_CASE("subgraph_view - predicate selection", "[subgraph_views]") {
+  const MockDagView g = sample();
+  const dagir::subgraph_view filtered(g, even_or_three{});
+  // Node 1 is rejected, so 2 is only reachable through it and disappears.
+  REQUIRE(node_ids(filtered) == ids{0, 3, 4});
+
+  const dagir::subgraph_view none(g, [](const MockHandle&) { return false; });
+  REQUIRE(none.roots().empty());
+}
+
+TEST_CASE("depth_limited_view - shortest depth and truncation", "[subgraph_views]") {
+  const MockDagView g = sample();
+  const dagir::depth_limited_view limited(g, 2);
+  // 3 is at depth 2 through 4, so 5 is cut even though 2 -> 3 is longer.
+  REQUIRE(node_ids(limited) == ids{0, 1, 2, 3, 4});
+  REQUIRE(limited.depth(MockHandle{3}) == 2);
+  REQUIRE(limited.children(MockHandle{2}).empty());
+  REQUIRE(limited.is_truncated(MockHandle{3}));
+  REQUIRE_FALSE(limited.is_truncated(MockHandle{4}));
+  REQUIRE(limited.size() == 5);
+
+  REQUIRE(node_ids(dagir::depth_limited_view(g, 0)) == ids{0});
+  REQUIRE(node_ids(dagir::depth_limited_view(g, 10)) == ids{0, 1, 2, 3, 4, 5});
+}
+
+TEST_CASE("cone_view - fan-out and fan-in", "[subgraph_views]") {
+  const MockDagView g = sample();
+  using cone = dagir::cone_view<MockDagView>;
+
+  REQUIRE(node_ids(cone(g, {MockHandle{2}})) == ids{2, 3, 5});
+  REQUIRE(node_ids(cone(g, {MockHandle{1}, MockHandle{4}}, dagir::cone_direction::fan_out, 1)) ==
+          ids{1, 2, 3, 4});
+
+  const cone above(g, {MockHandle{3}}, dagir::cone_direction::fan_in);
+  REQUIRE(node_ids(above) == ids{0, 1, 2, 3, 4});
+  REQUIRE(above.roots() == std::vector<MockHandle>{MockHandle{0}});
+  REQUIRE(above.children(MockHandle{3}).empty());
+
+  const cone near(g, {MockHandle{3}}, dagir::cone_direction::fan_in, 1);
+  REQUIRE(node_ids(near) == ids{2, 3, 4});
+  REQUIRE(near.roots().size() == 2);
+}
+
+TEST_CASE("subgraph views - composed and rendered", "[subgraph_views]") {
+  const MockDagView g = sample();
+  const dagir::cone_view<MockDagView> below(g, {MockHandle{1}});
+  const dagir::depth_limited_view<dagir::cone_view<MockDagView>> view(below, 1);
+  REQUIRE(node_ids(view) == ids{1, 2});
+
+  // Policies written for MockDagView accept the adapted view.
+  const MockDagView& innermost = view;
+  REQUIRE(&innermost == &g);
+  auto no_edge_attrs = [](auto&&...) { return dagir::ir_attr_map{}; };
+  const dagir::ir_graph ir = dagir::build_ir(view, base_only_attributor{}, no_edge_attrs);
+  REQUIRE(ir.nodes.size() == 2);
+  REQUIRE(ir.edges.size() == 1);
+  for (const auto& n : ir.nodes) {
+    REQUIRE(n.attributes.at(dagir::ir_attrs::k_label) == "n" + std::to_string(n.id));
+  }
+}